@@ -52,7 +52,7 @@ void ADQNEnemy::BeginPlay()
 
 
 	/* Server Socket Echo (UE config parameters (Num States and Actions)) */
-	FString Ping = TEXT("{\"ping\":\"hello from UE\", \"NumStates\":\"8\", \"NumActions\":\"5\"}");
+	FString Ping = FString::Printf(TEXT("{\"ping\":\"hello from UE\", \"NumStates\":\"%d\", \"NumActions\":\"5\"}"), static_cast<int32>(FQState::Schema::NumFields));
 	if (Comm.SendJson(Ping))
 		UE_LOG(LogTemp, Display, TEXT("[DQN] Sent: %s"), *Ping);
 
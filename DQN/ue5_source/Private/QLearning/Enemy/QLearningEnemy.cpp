@@ -173,7 +173,7 @@ EQAction AQLearningEnemy::ChooseAction(const FQState& State) // State - EncodedS
 	}
 
 	// Exploration
-	if (FMath::RandRange(0,1) < Epsilon)
+	if (FMath::FRand() < Epsilon)
 	{
 		int32 Index = FMath::RandRange(0, static_cast<int32>(EQAction::Wait)); // Random Action
 		return static_cast<EQAction>(Index);
@@ -2,6 +2,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "QCore/QStateSchema.h"
 
 #define ADD_HASH(Hash, Field) Hash = HashCombine(Hash, GetTypeHash(Field)); // not used atm
 
@@ -27,65 +28,42 @@ struct FQState
     bool bIsTargetDodging;      // New field
     bool bWasHitRecently;
 
+    // --- Schema: the single field list everything below is generated from ---
+    static constexpr auto Fields = std::make_tuple(
+        QCore::QField(&FQState::HealthPercent, "HealthPercent", 0, 100),
+        QCore::QField(&FQState::TargetHealthPercent, "TargetHealthPercent", 0, 100),
+        QCore::QField(&FQState::HealsLeft, "HealsLeft", 0, 7),
+        QCore::QField(&FQState::bIsInAttackRange, "bIsInAttackRange"),
+        QCore::QField(&FQState::bIsTargetAttacking, "bIsTargetAttacking"),
+        QCore::QField(&FQState::bIsTargetGuarding, "bIsTargetGuarding"),
+        QCore::QField(&FQState::bIsTargetDodging, "bIsTargetDodging"),
+        QCore::QField(&FQState::bWasHitRecently, "bWasHitRecently"));
+    using Schema = QCore::TQStateSchema<FQState, Fields>;
+
     // --- Hashing support ---
     friend uint32 GetTypeHash(const FQState& Key)
     {
-        uint32 Hash = 0;
-        Hash = HashCombine(Hash, GetTypeHash(Key.HealthPercent));
-        Hash = HashCombine(Hash, GetTypeHash(Key.TargetHealthPercent));
-        Hash = HashCombine(Hash, GetTypeHash(Key.HealsLeft));
-        Hash = HashCombine(Hash, GetTypeHash(Key.bIsInAttackRange));
-        Hash = HashCombine(Hash, GetTypeHash(Key.bIsTargetAttacking));
-        Hash = HashCombine(Hash, GetTypeHash(Key.bIsTargetGuarding));
-        Hash = HashCombine(Hash, GetTypeHash(Key.bIsTargetDodging));
-        Hash = HashCombine(Hash, GetTypeHash(Key.bWasHitRecently));
-        return Hash;
+        return Schema::Hash(Key);
     }
 
     // --- Equality operator for use as a key in TMap ---
     bool operator==(const FQState& Other) const
     {
-        return HealthPercent == Other.HealthPercent &&
-               TargetHealthPercent == Other.TargetHealthPercent &&
-               HealsLeft == Other.HealsLeft &&
-               bIsInAttackRange == Other.bIsInAttackRange &&
-               bIsTargetAttacking == Other.bIsTargetAttacking &&
-               bIsTargetGuarding == Other.bIsTargetGuarding &&
-               bIsTargetDodging == Other.bIsTargetDodging &&
-               bWasHitRecently == Other.bWasHitRecently;
+        return Schema::Equals(*this, Other);
     }
 
     // --- Debug ToString() ---
     FString ToString() const
     {
-        return FString::Printf(TEXT("%d_%d_%d_%d_%d_%d_%d_%d"),
-            HealthPercent,
-            TargetHealthPercent,
-            HealsLeft,
-            bIsInAttackRange,
-            bIsTargetAttacking,
-            bIsTargetGuarding,
-            bIsTargetDodging,
-            bWasHitRecently);
+        TCHAR Buffer[Schema::MaxStringLength];
+        Schema::WriteString(*this, Buffer, Schema::MaxStringLength);
+        return FString(Buffer);
     }
 
     static FQState FromString(const FString& Str)
     {
         FQState State;
-        TArray<FString> Parts;
-        Str.ParseIntoArray(Parts, TEXT("_"), true);
-
-        if (Parts.Num() >= 8)
-        {
-            State.HealthPercent = FCString::Atoi(*Parts[0]);
-            State.TargetHealthPercent = FCString::Atoi(*Parts[1]);
-            State.HealsLeft = FCString::Atoi(*Parts[2]);
-            State.bIsInAttackRange = FCString::Atoi(*Parts[3]) != 0;
-            State.bIsTargetAttacking = FCString::Atoi(*Parts[4]) != 0;
-            State.bIsTargetGuarding = FCString::Atoi(*Parts[5]) != 0;
-            State.bIsTargetDodging = FCString::Atoi(*Parts[6]) != 0;
-            State.bWasHitRecently = FCString::Atoi(*Parts[7]) != 0;
-        }
+        Schema::ParseString(*Str, State);
         return State;
     }
 
@@ -93,15 +71,8 @@ struct FQState
 	TArray<float> ToFloatArray() const
     {
     	TArray<float> V;
-    	V.Reserve(8);
-    	V.Add(static_cast<float>(HealthPercent));
-    	V.Add(static_cast<float>(TargetHealthPercent));
-    	V.Add(static_cast<float>(HealsLeft));
-    	V.Add(bIsInAttackRange		? 1.0f : 0.0f);
-    	V.Add(bIsTargetAttacking	? 1.0f : 0.0f);
-    	V.Add(bIsTargetGuarding		? 1.0f : 0.0f);
-    	V.Add(bIsTargetDodging		? 1.0f : 0.0f);
-    	V.Add(bWasHitRecently		? 1.0f : 0.0f);
+    	V.SetNumUninitialized(Schema::NumFields);
+    	Schema::ToFloats(*this, V.GetData());
     	return V;
     }
 	
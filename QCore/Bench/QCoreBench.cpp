@@ -0,0 +1,589 @@
+/*
+ * QCore microbenchmarks - tabular learning hot path
+ *	QCoreBench [--states 10000,100000,1000000] [--ops 2000000] [--filter Substring]
+ *
+ * Every benchmark runs over synthetic state streams (uniform and Zipf s=1.0 over N distinct states)
+ * and reports ns/op, heap bytes allocated per op (global operator new is counted) and table memory (file size for saves).
+ * The "Legacy" rows reproduce what the UE code did before QCore (HashCombine chain, split + Atoi parsing)
+ * so table-layout and persistence changes can be judged against the old baseline.
+ */
+#include "QCore/QLearner.h"
+#include "QCore/QOverlayTable.h"
+#include "QCore/QPersistence.h"
+#include "QCore/QPolicyTable.h"
+#include "QCore/QRowKernels.h"
+#include "QCore/QStateSchema.h"
+#include "QCore/QTileCoding.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+
+/* --- Allocation counting --- */
+static std::atomic<uint64_t> GAllocatedBytes{ 0 };
+static std::atomic<uint64_t> GAllocationCount{ 0 };
+
+void* operator new(size_t Size)
+{
+	GAllocatedBytes.fetch_add(Size, std::memory_order_relaxed);
+	GAllocationCount.fetch_add(1, std::memory_order_relaxed);
+	if (void* Ptr = std::malloc(Size ? Size : 1)) return Ptr;
+	throw std::bad_alloc();
+}
+
+void* operator new(size_t Size, std::align_val_t Alignment)
+{
+	GAllocatedBytes.fetch_add(Size, std::memory_order_relaxed);
+	GAllocationCount.fetch_add(1, std::memory_order_relaxed);
+	const size_t Align = static_cast<size_t>(Alignment);
+	if (void* Ptr = std::aligned_alloc(Align, (Size + Align - 1) / Align * Align)) return Ptr;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* Ptr) noexcept { std::free(Ptr); }
+void operator delete(void* Ptr, size_t) noexcept { std::free(Ptr); }
+void operator delete(void* Ptr, std::align_val_t) noexcept { std::free(Ptr); }
+void operator delete(void* Ptr, size_t, std::align_val_t) noexcept { std::free(Ptr); }
+
+
+/* --- Benchmark state (mirrors the UE FQState) --- */
+struct FBenchState
+{
+	int8_t HealthPercent = 0;
+	int8_t TargetHealthPercent = 0;
+	int8_t HealsLeft = 0;
+	bool bIsInAttackRange = false;
+	bool bIsTargetAttacking = false;
+	bool bIsTargetGuarding = false;
+	bool bWasHitRecently = false;
+
+	static constexpr auto Fields = std::make_tuple(
+		QCore::QField(&FBenchState::HealthPercent, "HealthPercent", 0, 100),
+		QCore::QField(&FBenchState::TargetHealthPercent, "TargetHealthPercent", 0, 100),
+		QCore::QField(&FBenchState::HealsLeft, "HealsLeft", 0, 7),
+		QCore::QField(&FBenchState::bIsInAttackRange, "bIsInAttackRange"),
+		QCore::QField(&FBenchState::bIsTargetAttacking, "bIsTargetAttacking"),
+		QCore::QField(&FBenchState::bIsTargetGuarding, "bIsTargetGuarding"),
+		QCore::QField(&FBenchState::bWasHitRecently, "bWasHitRecently"));
+	using Schema = QCore::TQStateSchema<FBenchState, Fields>;
+};
+
+constexpr int32_t BenchNumActions = 5;
+
+
+/* --- Legacy baselines (what FQState did with UE containers) --- */
+static uint32_t LegacyHashCombine(uint32_t A, uint32_t C)
+{
+	uint32_t B = 0x9e3779b9;
+	A += B;
+	A -= B; A -= C; A ^= (C >> 13);
+	B -= C; B -= A; B ^= (A << 8);
+	C -= A; C -= B; C ^= (B >> 13);
+	A -= B; A -= C; A ^= (C >> 12);
+	B -= C; B -= A; B ^= (A << 16);
+	C -= A; C -= B; C ^= (B >> 5);
+	A -= B; A -= C; A ^= (C >> 3);
+	B -= C; B -= A; B ^= (A << 10);
+	C -= A; C -= B; C ^= (B >> 15);
+	return C;
+}
+
+static uint32_t LegacyHash(const FBenchState& State)
+{
+	uint32_t Hash = 0;
+	Hash = LegacyHashCombine(Hash, static_cast<uint32_t>(State.HealthPercent));
+	Hash = LegacyHashCombine(Hash, static_cast<uint32_t>(State.TargetHealthPercent));
+	Hash = LegacyHashCombine(Hash, static_cast<uint32_t>(State.HealsLeft));
+	Hash = LegacyHashCombine(Hash, State.bIsInAttackRange);
+	Hash = LegacyHashCombine(Hash, State.bIsTargetAttacking);
+	Hash = LegacyHashCombine(Hash, State.bIsTargetGuarding);
+	Hash = LegacyHashCombine(Hash, State.bWasHitRecently);
+	return Hash;
+}
+
+static FBenchState LegacyFromString(const std::string& Str) // ParseIntoArray + Atoi
+{
+	FBenchState State;
+	std::vector<std::string> Parts;
+	size_t Start = 0;
+	for (size_t End; (End = Str.find('_', Start)) != std::string::npos; Start = End + 1)
+	{
+		if (End > Start) Parts.push_back(Str.substr(Start, End - Start));
+	}
+	if (Start < Str.size()) Parts.push_back(Str.substr(Start));
+
+	if (Parts.size() >= 7)
+	{
+		State.HealthPercent = static_cast<int8_t>(std::atoi(Parts[0].c_str()));
+		State.TargetHealthPercent = static_cast<int8_t>(std::atoi(Parts[1].c_str()));
+		State.HealsLeft = static_cast<int8_t>(std::atoi(Parts[2].c_str()));
+		State.bIsInAttackRange = std::atoi(Parts[3].c_str()) != 0;
+		State.bIsTargetAttacking = std::atoi(Parts[4].c_str()) != 0;
+		State.bIsTargetGuarding = std::atoi(Parts[5].c_str()) != 0;
+		State.bWasHitRecently = std::atoi(Parts[6].c_str()) != 0;
+	}
+	return State;
+}
+
+
+/* --- Harness --- */
+struct FBenchOptions
+{
+	std::vector<size_t> StateCounts = { 10000, 100000, 1000000 };
+	size_t NumOps = 2000000;
+	const char* Filter = nullptr;
+};
+
+static volatile uint64_t GSink = 0; // keeps results observable
+
+struct FMeasure
+{
+	std::chrono::steady_clock::time_point Start;
+	uint64_t StartBytes;
+
+	FMeasure()
+		: Start(std::chrono::steady_clock::now())
+		, StartBytes(GAllocatedBytes.load(std::memory_order_relaxed))
+	{
+	}
+
+	void Report(const char* Name, const size_t NumStates, const char* Distribution, const size_t NumOps, const size_t TableBytes) const
+	{
+		const double Nanos = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - Start).count();
+		const double Bytes = static_cast<double>(GAllocatedBytes.load(std::memory_order_relaxed) - StartBytes);
+		std::printf("%-28s %9zu  %-7s %10.1f %12.1f %12.2f\n", Name, NumStates, Distribution,
+			Nanos / static_cast<double>(NumOps), Bytes / static_cast<double>(NumOps), static_cast<double>(TableBytes) / (1024.0 * 1024.0));
+	}
+};
+
+static bool IsSelected(const FBenchOptions& Options, const char* Name)
+{
+	return !Options.Filter || std::strstr(Name, Options.Filter);
+}
+
+/* N distinct, valid state keys */
+static std::vector<QCore::FQKey> MakeStatePool(const size_t NumStates, std::mt19937_64& Rng)
+{
+	std::uniform_int_distribution<int32_t> Percent(0, 100);
+	std::uniform_int_distribution<int32_t> Heals(0, 7);
+	std::uniform_int_distribution<int32_t> Flag(0, 1);
+
+	std::unordered_set<QCore::FQKey> Seen;
+	std::vector<QCore::FQKey> Pool;
+	Pool.reserve(NumStates);
+	while (Pool.size() < NumStates)
+	{
+		FBenchState State;
+		State.HealthPercent = static_cast<int8_t>(Percent(Rng));
+		State.TargetHealthPercent = static_cast<int8_t>(Percent(Rng));
+		State.HealsLeft = static_cast<int8_t>(Heals(Rng));
+		State.bIsInAttackRange = Flag(Rng);
+		State.bIsTargetAttacking = Flag(Rng);
+		State.bIsTargetGuarding = Flag(Rng);
+		State.bWasHitRecently = Flag(Rng);
+
+		const QCore::FQKey Key = FBenchState::Schema::Pack(State);
+		if (Seen.insert(Key).second) Pool.push_back(Key);
+	}
+	return Pool;
+}
+
+/* Stream of pool indices, uniform or Zipf(s = 1) over pool rank */
+static std::vector<uint32_t> MakeStream(const size_t NumStates, const size_t Length, const bool bZipf, std::mt19937_64& Rng)
+{
+	std::vector<uint32_t> Stream(Length);
+	if (!bZipf)
+	{
+		std::uniform_int_distribution<uint32_t> Uniform(0, static_cast<uint32_t>(NumStates - 1));
+		for (uint32_t& Index : Stream) Index = Uniform(Rng);
+		return Stream;
+	}
+
+	std::vector<double> Cdf(NumStates);
+	double Sum = 0.0;
+	for (size_t Rank = 0; Rank < NumStates; ++Rank)
+	{
+		Sum += 1.0 / static_cast<double>(Rank + 1);
+		Cdf[Rank] = Sum;
+	}
+	std::uniform_real_distribution<double> Draw(0.0, Sum);
+	for (uint32_t& Index : Stream)
+	{
+		Index = static_cast<uint32_t>(std::lower_bound(Cdf.begin(), Cdf.end(), Draw(Rng)) - Cdf.begin());
+		if (Index >= NumStates) Index = static_cast<uint32_t>(NumStates - 1);
+	}
+	return Stream;
+}
+
+
+static void BenchLearner(const FBenchOptions& Options, const QCore::ETableBackend Backend, const QCore::EQValueType ValueType,
+	const std::vector<QCore::FQKey>& Pool, const std::vector<uint32_t>& Stream, const char* Distribution)
+{
+	const bool bInt16 = ValueType == QCore::EQValueType::Int16;
+	const char* BackendName = Backend == QCore::ETableBackend::Dense ? (bInt16 ? "Dense16" : "Dense") : (bInt16 ? "Map16" : "Map");
+	char ChooseName[64];
+	char UpdateName[64];
+	std::snprintf(ChooseName, sizeof(ChooseName), "ChooseAction/%s", BackendName);
+	std::snprintf(UpdateName, sizeof(UpdateName), "UpdateQValue/%s", BackendName);
+	if (!IsSelected(Options, ChooseName) && !IsSelected(Options, UpdateName)) return;
+
+	QCore::FQLearner Learner;
+	Learner.SeedRandom(1);
+	Learner.SetTable(QCore::MakeTable(Backend, BenchNumActions, FBenchState::Schema::NumKeys, ValueType));
+	for (const QCore::FQKey Key : Pool) Learner.GetTable()->FindOrAddRowData(Key); // steady state: every state already seen
+
+	std::vector<int32_t> Actions(Stream.size());
+	if (IsSelected(Options, ChooseName))
+	{
+		const FMeasure Measure;
+		for (size_t Step = 0; Step < Stream.size(); ++Step)
+		{
+			Actions[Step] = Learner.ChooseAction(Pool[Stream[Step]]);
+		}
+		Measure.Report(ChooseName, Pool.size(), Distribution, Stream.size(), Learner.GetTable()->GetAllocatedSize());
+	}
+
+	if (IsSelected(Options, UpdateName))
+	{
+		const FMeasure Measure;
+		for (size_t Step = 0; Step + 1 < Stream.size(); ++Step)
+		{
+			Learner.UpdateQValue(Pool[Stream[Step]], Actions[Step] % BenchNumActions, 0.5f, Pool[Stream[Step + 1]]);
+		}
+		Measure.Report(UpdateName, Pool.size(), Distribution, Stream.size() - 1, Learner.GetTable()->GetAllocatedSize());
+	}
+}
+
+/* Frozen greedy policy over the UE default buckets (5 health bands each): index lookup + one byte load */
+static void BenchFrozenPolicy(const FBenchOptions& Options, const std::vector<QCore::FQKey>& Pool, const std::vector<uint32_t>& Stream, const char* Distribution)
+{
+	if (!IsSelected(Options, "ChooseAction/Frozen")) return;
+
+	QCore::FQDiscretizer Discretizer(QCore::MakeKeyLayout<FBenchState::Schema>());
+	const int32_t Edges[] = { 20, 40, 60, 80 };
+	Discretizer.SetBucketEdges("HealthPercent", Edges, 4);
+	Discretizer.SetBucketEdges("TargetHealthPercent", Edges, 4);
+
+	const std::unique_ptr<QCore::IQTable> Table = QCore::MakeTable(QCore::ETableBackend::Map, BenchNumActions, 0);
+	for (const QCore::FQKey Key : Pool) Table->FindOrAddRow(Discretizer.Apply(Key))[Key % BenchNumActions] = 1.f;
+	QCore::FQPolicyTable Policy(Discretizer);
+	Policy.Build(*Table);
+
+	uint64_t Sum = 0;
+	const FMeasure Measure;
+	for (const uint32_t Index : Stream) Sum += static_cast<uint64_t>(Policy.Choose(Pool[Index]));
+	Measure.Report("ChooseAction/Frozen", Pool.size(), Distribution, Stream.size(), Policy.GetAllocatedSize());
+	GSink = GSink + Sum;
+}
+
+/* Tile-coded linear Q over the schema fields (8 tilings): hash the active tiles + one SIMD row add per tiling */
+static void BenchTileCoding(const FBenchOptions& Options, const std::vector<QCore::FQKey>& Pool, const std::vector<uint32_t>& Stream, const char* Distribution)
+{
+	if (!IsSelected(Options, "ChooseAction/Tiles") && !IsSelected(Options, "UpdateQValue/Tiles")) return;
+
+	const QCore::FQKeyLayout Layout = QCore::MakeKeyLayout<FBenchState::Schema>();
+	std::vector<QCore::FQTileDimension> Dimensions;
+	for (size_t Field = 0; Field < Layout.NumFields; ++Field)
+	{
+		const float Range = static_cast<float>(Layout.Fields[Field].Max - Layout.Fields[Field].Min);
+		Dimensions.push_back({ static_cast<float>(Layout.Fields[Field].Min), static_cast<float>(Layout.Fields[Field].Max), Range > 1.f ? 5.f : 1.f });
+	}
+	QCore::FQTileLearner Learner(BenchNumActions, Dimensions);
+	Learner.SeedRandom(1);
+
+	constexpr size_t NumFeatures = FBenchState::Schema::NumFields;
+	std::vector<float> Features(Pool.size() * NumFeatures);
+	for (size_t Index = 0; Index < Pool.size(); ++Index) FBenchState::Schema::ToFloats(FBenchState::Schema::Unpack(Pool[Index]), &Features[Index * NumFeatures]);
+
+	std::vector<int32_t> Actions(Stream.size());
+	if (IsSelected(Options, "ChooseAction/Tiles"))
+	{
+		const FMeasure Measure;
+		for (size_t Step = 0; Step < Stream.size(); ++Step) Actions[Step] = Learner.ChooseAction(&Features[Stream[Step] * NumFeatures]);
+		Measure.Report("ChooseAction/Tiles", Pool.size(), Distribution, Stream.size(), Learner.GetAllocatedSize());
+	}
+	if (IsSelected(Options, "UpdateQValue/Tiles"))
+	{
+		const FMeasure Measure;
+		for (size_t Step = 0; Step + 1 < Stream.size(); ++Step)
+		{
+			Learner.UpdateQValue(&Features[Stream[Step] * NumFeatures], Actions[Step] % BenchNumActions, 0.5f, &Features[Stream[Step + 1] * NumFeatures]);
+		}
+		Measure.Report("UpdateQValue/Tiles", Pool.size(), Distribution, Stream.size() - 1, Learner.GetAllocatedSize());
+	}
+}
+
+/* max Q(s') of a flush's worth of queued updates (FQUpdateQueue): one MaxRow per row against one batched MaxRows call.
+ * Rows are looked up beforehand, only the kernels are timed */
+static void BenchMaxFutureQ(const FBenchOptions& Options, const std::vector<QCore::FQKey>& Pool, const std::vector<uint32_t>& Stream, const char* Distribution)
+{
+	if (!IsSelected(Options, "MaxQ/PerRow") && !IsSelected(Options, "MaxQ/Batched")) return;
+
+	const std::unique_ptr<QCore::IQTable> Table = QCore::MakeTable(QCore::ETableBackend::Map, BenchNumActions, 0);
+	for (size_t Index = 0; Index < Pool.size(); ++Index) Table->FindOrAddRow(Pool[Index])[Index % BenchNumActions] = static_cast<float>(Index);
+	std::vector<const float*> Rows(Stream.size());
+	for (size_t Step = 0; Step < Stream.size(); ++Step) Rows[Step] = static_cast<const float*>(Table->FindRowData(Pool[Stream[Step]]));
+
+	constexpr size_t FlushSize = 256; // FQUpdateQueue's default capacity
+	std::vector<float> Max(FlushSize);
+	if (IsSelected(Options, "MaxQ/PerRow"))
+	{
+		float Sum = 0.f;
+		const FMeasure Measure;
+		for (size_t Begin = 0; Begin < Rows.size(); Begin += FlushSize)
+		{
+			const size_t Count = std::min(FlushSize, Rows.size() - Begin);
+			for (size_t Index = 0; Index < Count; ++Index) Max[Index] = QCore::MaxRow(Rows[Begin + Index]);
+			Sum += Max[0];
+		}
+		Measure.Report("MaxQ/PerRow", Pool.size(), Distribution, Rows.size(), Table->GetAllocatedSize());
+		GSink = GSink + static_cast<uint64_t>(Sum);
+	}
+
+	if (IsSelected(Options, "MaxQ/Batched"))
+	{
+		float Sum = 0.f;
+		const FMeasure Measure;
+		for (size_t Begin = 0; Begin < Rows.size(); Begin += FlushSize)
+		{
+			const size_t Count = std::min(FlushSize, Rows.size() - Begin);
+			QCore::MaxRows(Rows.data() + Begin, static_cast<int32_t>(Count), Max.data());
+			Sum += Max[0];
+		}
+		Measure.Report("MaxQ/Batched", Pool.size(), Distribution, Rows.size(), Table->GetAllocatedSize());
+		GSink = GSink + static_cast<uint64_t>(Sum);
+	}
+}
+
+static void BenchHashing(const FBenchOptions& Options, const std::vector<QCore::FQKey>& Pool, const std::vector<uint32_t>& Stream, const char* Distribution)
+{
+	std::vector<FBenchState> States(Pool.size());
+	for (size_t Index = 0; Index < Pool.size(); ++Index) States[Index] = FBenchState::Schema::Unpack(Pool[Index]);
+
+	if (IsSelected(Options, "GetTypeHash/Schema"))
+	{
+		uint64_t Sum = 0;
+		const FMeasure Measure;
+		for (const uint32_t Index : Stream) Sum += FBenchState::Schema::Hash(States[Index]);
+		Measure.Report("GetTypeHash/Schema", Pool.size(), Distribution, Stream.size(), 0);
+		GSink = GSink + Sum;
+	}
+
+	if (IsSelected(Options, "GetTypeHash/Legacy"))
+	{
+		uint64_t Sum = 0;
+		const FMeasure Measure;
+		for (const uint32_t Index : Stream) Sum += LegacyHash(States[Index]);
+		Measure.Report("GetTypeHash/Legacy", Pool.size(), Distribution, Stream.size(), 0);
+		GSink = GSink + Sum;
+	}
+}
+
+static void BenchFromString(const FBenchOptions& Options, const std::vector<QCore::FQKey>& Pool, const std::vector<uint32_t>& Stream, const char* Distribution)
+{
+	std::vector<std::string> Strings(Pool.size());
+	for (size_t Index = 0; Index < Pool.size(); ++Index)
+	{
+		char Buffer[FBenchState::Schema::MaxStringLength];
+		FBenchState::Schema::WriteString(FBenchState::Schema::Unpack(Pool[Index]), Buffer, sizeof(Buffer));
+		Strings[Index] = Buffer;
+	}
+
+	if (IsSelected(Options, "FromString/Schema"))
+	{
+		uint64_t Sum = 0;
+		const FMeasure Measure;
+		for (const uint32_t Index : Stream)
+		{
+			FBenchState State;
+			FBenchState::Schema::ParseString(Strings[Index].c_str(), State);
+			Sum += State.HealthPercent;
+		}
+		Measure.Report("FromString/Schema", Pool.size(), Distribution, Stream.size(), 0);
+		GSink = GSink + Sum;
+	}
+
+	if (IsSelected(Options, "FromString/Legacy"))
+	{
+		uint64_t Sum = 0;
+		const FMeasure Measure;
+		for (const uint32_t Index : Stream) Sum += LegacyFromString(Strings[Index]).HealthPercent;
+		Measure.Report("FromString/Legacy", Pool.size(), Distribution, Stream.size(), 0);
+		GSink = GSink + Sum;
+	}
+}
+
+/* Shared table scaling: N threads, one learner each, ChooseAction + UpdateQValue over their slice of the stream.
+ * ns/op is wall time over all threads' ops (lower = more throughput). GlobalLock is a Map table behind one mutex. */
+static void BenchConcurrent(const FBenchOptions& Options, const std::vector<QCore::FQKey>& Pool, const std::vector<uint32_t>& Stream, const char* Distribution)
+{
+	enum class EKind { Sharded, AtomicDense, GlobalLock };
+	const char* KindNames[] = { "Sharded", "AtomicDense", "GlobalLock" };
+
+	for (const EKind Kind : { EKind::Sharded, EKind::AtomicDense, EKind::GlobalLock })
+	{
+		for (const int32_t NumThreads : { 1, 4, 16, 64 })
+		{
+			char Name[64];
+			std::snprintf(Name, sizeof(Name), "Concurrent/%s/%dt", KindNames[static_cast<int32_t>(Kind)], NumThreads);
+			if (!IsSelected(Options, Name)) continue;
+
+			const std::shared_ptr<QCore::IQTable> Table = Kind == EKind::GlobalLock
+				? QCore::MakeTable(QCore::ETableBackend::Map, BenchNumActions, 0)
+				: QCore::MakeTable(Kind == EKind::Sharded ? QCore::ETableBackend::Sharded : QCore::ETableBackend::Dense, BenchNumActions,
+					FBenchState::Schema::NumKeys, QCore::EQValueType::AtomicFloat);
+			std::mutex GlobalLock;
+			const size_t OpsPerThread = Stream.size() / static_cast<size_t>(NumThreads);
+
+			const FMeasure Measure;
+			std::vector<std::thread> Threads;
+			for (int32_t Thread = 0; Thread < NumThreads; ++Thread)
+			{
+				Threads.emplace_back([&, Thread]()
+				{
+					QCore::FQLearner Learner;
+					Learner.SeedRandom(1, static_cast<uint64_t>(Thread)); // one stream per agent, they don't explore in lockstep
+					Learner.SetTable(Table);
+					const size_t Begin = static_cast<size_t>(Thread) * OpsPerThread;
+					for (size_t Step = Begin; Step + 1 < Begin + OpsPerThread; ++Step)
+					{
+						const QCore::FQKey State = Pool[Stream[Step]];
+						std::unique_lock<std::mutex> Lock(GlobalLock, std::defer_lock);
+						if (Kind == EKind::GlobalLock) Lock.lock();
+						const int32_t Action = Learner.ChooseAction(State);
+						Learner.UpdateQValue(State, Action, 0.5f, Pool[Stream[Step + 1]]);
+					}
+				});
+			}
+			for (std::thread& Thread : Threads) Thread.join();
+			Measure.Report(Name, Pool.size(), Distribution, OpsPerThread * static_cast<size_t>(NumThreads), Table->GetAllocatedSize());
+		}
+	}
+}
+
+/* Whole-table load and save (per state): the binary format SaveQTableToDisk writes, and the JSON export */
+static void BenchLoad(const FBenchOptions& Options, const QCore::ETableBackend Backend, const std::vector<QCore::FQKey>& Pool)
+{
+	const bool bDense = Backend == QCore::ETableBackend::Dense;
+	const char* JsonName = bDense ? "LoadQTable/Json/Dense" : "LoadQTable/Json/Map";
+	const char* BinaryName = bDense ? "LoadQTable/Binary/Dense" : "LoadQTable/Binary/Map";
+	const char* SaveJsonName = bDense ? "SaveQTable/Json/Dense" : "SaveQTable/Json/Map";
+	const char* SaveBinaryName = bDense ? "SaveQTable/Binary/Dense" : "SaveQTable/Binary/Map";
+	const char* MappedName = bDense ? nullptr : "LoadQTable/Mapped"; // the view doesn't depend on the backend, measured once
+	const bool bMapped = MappedName && IsSelected(Options, MappedName);
+	if (!IsSelected(Options, JsonName) && !IsSelected(Options, BinaryName) && !IsSelected(Options, SaveJsonName) && !IsSelected(Options, SaveBinaryName) && !bMapped) return;
+
+	const QCore::FQKeyLayout Layout = QCore::MakeKeyLayout<FBenchState::Schema>();
+	const std::unique_ptr<QCore::IQTable> Source = QCore::MakeTable(Backend, BenchNumActions, FBenchState::Schema::NumKeys);
+	std::mt19937 Rng(3);
+	std::uniform_real_distribution<float> Value(-10.f, 10.f);
+	for (const QCore::FQKey Key : Pool)
+	{
+		const QCore::FQRow Row = Source->FindOrAddRow(Key);
+		for (int32_t Action = 0; Action < BenchNumActions; ++Action) Row[Action] = Value(Rng);
+	}
+
+	std::string Json;
+	std::string Binary;
+	{
+		const FMeasure Measure;
+		Json = QCore::WriteTableJson(*Source, Layout);
+		if (IsSelected(Options, SaveJsonName)) Measure.Report(SaveJsonName, Pool.size(), "-", Pool.size(), Json.size());
+	}
+	{
+		const FMeasure Measure;
+		Binary = QCore::WriteTableBinary(*Source, Layout);
+		if (IsSelected(Options, SaveBinaryName)) Measure.Report(SaveBinaryName, Pool.size(), "-", Pool.size(), Binary.size());
+	}
+
+	const std::unique_ptr<QCore::IQTable> Table = QCore::MakeTable(Backend, BenchNumActions, FBenchState::Schema::NumKeys);
+	if (IsSelected(Options, JsonName))
+	{
+		const FMeasure Measure;
+		QCore::ReadTableJson(*Table, Layout, Json.data(), Json.size());
+		Measure.Report(JsonName, Pool.size(), "-", Pool.size(), Table->GetAllocatedSize());
+	}
+	if (IsSelected(Options, BinaryName))
+	{
+		const FMeasure Measure;
+		QCore::ReadTableBinary(*Table, Layout, Binary.data(), Binary.size());
+		Measure.Report(BinaryName, Pool.size(), "-", Pool.size(), Table->GetAllocatedSize());
+	}
+	if (bMapped)
+	{
+		// The file's bytes already in memory, as a mapping is - what's left is the key index and an empty overlay
+		const std::string Aligned = QCore::WriteTableBinary(*Source, Layout, true);
+		const std::vector<char, QCore::TAlignedAllocator<char, QCore::RowAlignment>> Mapped(Aligned.begin(), Aligned.end());
+		const FMeasure Measure;
+		const std::shared_ptr<const QCore::FQTableView> View = std::make_shared<QCore::FQTableView>(Mapped.data(), Mapped.size(), Layout);
+		const QCore::FQOverlayTable Overlay(View);
+		Measure.Report(MappedName, Pool.size(), "-", Pool.size(), View->GetIndexSize() + Overlay.GetAllocatedSize());
+	}
+}
+
+
+static FBenchOptions ParseOptions(const int Argc, char** Argv)
+{
+	FBenchOptions Options;
+	for (int Arg = 1; Arg + 1 < Argc; Arg += 2)
+	{
+		if (!std::strcmp(Argv[Arg], "--states"))
+		{
+			Options.StateCounts.clear();
+			for (const char* Token = Argv[Arg + 1]; *Token; )
+			{
+				char* End;
+				Options.StateCounts.push_back(std::strtoull(Token, &End, 10));
+				Token = *End ? End + 1 : End;
+			}
+		}
+		else if (!std::strcmp(Argv[Arg], "--ops")) Options.NumOps = std::strtoull(Argv[Arg + 1], nullptr, 10);
+		else if (!std::strcmp(Argv[Arg], "--filter")) Options.Filter = Argv[Arg + 1];
+	}
+	return Options;
+}
+
+int main(int Argc, char** Argv)
+{
+	const FBenchOptions Options = ParseOptions(Argc, Argv);
+	std::printf("%-28s %9s  %-7s %10s %12s %12s\n", "benchmark", "states", "dist", "ns/op", "alloc B/op", "table MB");
+
+	for (const size_t NumStates : Options.StateCounts)
+	{
+		std::mt19937_64 Rng(NumStates);
+		const std::vector<QCore::FQKey> Pool = MakeStatePool(NumStates, Rng);
+
+		for (const bool bZipf : { false, true })
+		{
+			const char* Distribution = bZipf ? "zipf" : "uniform";
+			const std::vector<uint32_t> Stream = MakeStream(NumStates, Options.NumOps, bZipf, Rng);
+
+			for (const QCore::EQValueType ValueType : { QCore::EQValueType::Float, QCore::EQValueType::Int16 })
+			{
+				BenchLearner(Options, QCore::ETableBackend::Map, ValueType, Pool, Stream, Distribution);
+				BenchLearner(Options, QCore::ETableBackend::Dense, ValueType, Pool, Stream, Distribution);
+			}
+			BenchFrozenPolicy(Options, Pool, Stream, Distribution);
+			BenchMaxFutureQ(Options, Pool, Stream, Distribution);
+			BenchTileCoding(Options, Pool, Stream, Distribution);
+			BenchHashing(Options, Pool, Stream, Distribution);
+			BenchFromString(Options, Pool, Stream, Distribution);
+			BenchConcurrent(Options, Pool, Stream, Distribution);
+		}
+
+		BenchLoad(Options, QCore::ETableBackend::Map, Pool);
+		BenchLoad(Options, QCore::ETableBackend::Dense, Pool);
+	}
+	return 0;
+}
@@ -0,0 +1,63 @@
+#include "QCore/QAtomicDenseTable.h"
+#include "QCore/QRowKernels.h"
+
+
+namespace QCore
+{
+	FQAtomicDenseTable::FQAtomicDenseTable(const int32_t InNumActions, const uint64_t InNumKeys)
+		: IQTable(InNumActions, EQValueType::AtomicFloat)
+		, NumRows(InNumKeys)
+		, Values(InNumKeys * RowWidth)
+		, VisitedWords((InNumKeys + 63) / 64)
+	{
+		Empty();
+	}
+
+	FQAtomicDenseTable::FQAtomicDenseTable(const int32_t InNumActions, std::shared_ptr<const FQStateIndex> InStateIndex)
+		: FQAtomicDenseTable(InNumActions, InStateIndex->GetNumStates())
+	{
+		StateIndex = std::move(InStateIndex);
+	}
+
+	void* FQAtomicDenseTable::FindOrAddRowData(const FQKey Key)
+	{
+		const uint64_t Row = ToRow(Key);
+		const uint64_t Bit = uint64_t(1) << (Row & 63);
+		std::atomic<uint64_t>& Word = VisitedWords[Row >> 6];
+		if (!(Word.load(std::memory_order_relaxed) & Bit) && !(Word.fetch_or(Bit, std::memory_order_relaxed) & Bit))
+		{
+			NumVisited.fetch_add(1, std::memory_order_relaxed); // only the thread that set the bit counts it
+		}
+		return &Values[Row * RowWidth];
+	}
+
+	void FQAtomicDenseTable::Empty()
+	{
+		for (uint64_t Row = 0; Row < NumRows; ++Row)
+		{
+			std::atomic<float>* Cells = &Values[Row * RowWidth];
+			for (int32_t Lane = 0; Lane < RowWidth; ++Lane) Cells[Lane].store(Lane < NumActions ? 0.f : RowPadding, std::memory_order_relaxed);
+		}
+		for (std::atomic<uint64_t>& Word : VisitedWords) Word.store(0, std::memory_order_relaxed);
+		NumVisited.store(0, std::memory_order_relaxed);
+	}
+
+	size_t FQAtomicDenseTable::GetAllocatedSize() const
+	{
+		return Values.capacity() * sizeof(std::atomic<float>) + VisitedWords.capacity() * sizeof(std::atomic<uint64_t>);
+	}
+
+	void FQAtomicDenseTable::ForEachRow(const std::function<void(FQKey, const float*)>& Func) const
+	{
+		alignas(RowAlignment) float Row[RowWidth];
+		for (size_t WordIndex = 0; WordIndex < VisitedWords.size(); ++WordIndex)
+		{
+			for (uint64_t Word = VisitedWords[WordIndex].load(std::memory_order_relaxed); Word; Word &= Word - 1)
+			{
+				const uint64_t Index = WordIndex * 64 + FirstSetBit64(Word);
+				LoadAtomicRow(&Values[Index * RowWidth], Row);
+				Func(StateIndex ? StateIndex->GetStateKey(static_cast<uint32_t>(Index)) : Index, Row);
+			}
+		}
+	}
+}
@@ -0,0 +1,105 @@
+#include "QCore/QDenseTable.h"
+#include "QCore/QRowKernels.h"
+#include <algorithm>
+
+
+namespace QCore
+{
+	template <typename ValueType>
+	TQDenseTable<ValueType>::TQDenseTable(const int32_t InNumActions, const uint64_t InNumKeys, const float InValueScale)
+		: IQTable(InNumActions, TQValueType<ValueType>::Value, InValueScale)
+		, NumRows(InNumKeys)
+	{
+		Values.resize(NumRows * RowWidth);
+		VisitedWords.resize((NumRows + 63) / 64);
+		Empty();
+	}
+
+	template <typename ValueType>
+	TQDenseTable<ValueType>::TQDenseTable(const int32_t InNumActions, std::shared_ptr<const FQStateIndex> InStateIndex, const float InValueScale)
+		: TQDenseTable(InNumActions, InStateIndex->GetNumStates(), InValueScale)
+	{
+		StateIndex = std::move(InStateIndex);
+	}
+
+	template <typename ValueType>
+	void* TQDenseTable<ValueType>::FindOrAddRowData(const FQKey Key)
+	{
+		const uint64_t Row = ToRow(Key);
+		uint64_t& Word = VisitedWords[Row >> 6];
+		const uint64_t Bit = uint64_t(1) << (Row & 63);
+		if (!(Word & Bit))
+		{
+			Word |= Bit;
+			++NumVisited;
+		}
+		return &Values[Row * RowWidth];
+	}
+
+	template <typename ValueType>
+	bool TQDenseTable<ValueType>::EnableVisitCounts()
+	{
+		if (!bVisitCounts) Counts.assign(NumRows * NumActions, 0);
+		bVisitCounts = true;
+		return true;
+	}
+
+	template <typename ValueType>
+	void* TQDenseTable<ValueType>::FindOrAddCountedRowData(const FQKey Key, uint32_t*& OutCounts)
+	{
+		OutCounts = bVisitCounts ? &Counts[ToRow(Key) * NumActions] : nullptr;
+		return FindOrAddRowData(Key);
+	}
+
+	template <typename ValueType>
+	const void* TQDenseTable<ValueType>::FindCountedRowData(const FQKey Key, const uint32_t*& OutCounts) const
+	{
+		const bool bFound = Contains(Key);
+		OutCounts = bFound && bVisitCounts ? &Counts[ToRow(Key) * NumActions] : nullptr;
+		return bFound ? GetRow(Key) : nullptr;
+	}
+
+	template <typename ValueType>
+	void TQDenseTable<ValueType>::Empty()
+	{
+		for (uint64_t Row = 0; Row < NumRows; ++Row)
+		{
+			InitRow(&Values[Row * RowWidth], NumActions);
+		}
+		std::fill(VisitedWords.begin(), VisitedWords.end(), 0);
+		std::fill(Counts.begin(), Counts.end(), 0);
+		NumVisited = 0;
+	}
+
+	template <typename ValueType>
+	size_t TQDenseTable<ValueType>::GetAllocatedSize() const
+	{
+		return Values.capacity() * sizeof(ValueType) + VisitedWords.capacity() * sizeof(uint64_t) + Counts.capacity() * sizeof(uint32_t);
+	}
+
+	template <typename ValueType>
+	void TQDenseTable<ValueType>::ForEachRow(const std::function<void(FQKey, const float*)>& Func) const
+	{
+		alignas(RowAlignment) float Dequantized[RowWidth];
+		for (size_t WordIndex = 0; WordIndex < VisitedWords.size(); ++WordIndex)
+		{
+			for (uint64_t Word = VisitedWords[WordIndex]; Word; Word &= Word - 1)
+			{
+				const uint64_t Row = WordIndex * 64 + FirstSetBit64(Word);
+				const ValueType* RowValues = &Values[Row * RowWidth];
+				if constexpr (std::is_same_v<ValueType, float>)
+				{
+					Func(ToKey(Row), RowValues);
+				}
+				else
+				{
+					for (int32_t Lane = 0; Lane < RowWidth; ++Lane) Dequantized[Lane] = Dequantize16(RowValues[Lane], ValueScale);
+					Func(ToKey(Row), Dequantized);
+				}
+			}
+		}
+	}
+
+	template class TQDenseTable<float>;
+	template class TQDenseTable<int16_t>;
+}
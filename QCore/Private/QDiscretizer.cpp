@@ -0,0 +1,128 @@
+#include "QCore/QDiscretizer.h"
+#include "QCore/QTable.h"
+#include <cstring>
+#include <unordered_map>
+
+
+namespace QCore
+{
+	bool FQDiscretizer::SetBucketEdges(const char* FieldName, const int32_t* Edges, const size_t NumEdges)
+	{
+		size_t FieldIndex = 0;
+		while (FieldIndex < Layout.NumFields && std::strcmp(Layout.Fields[FieldIndex].Name, FieldName) != 0) ++FieldIndex;
+		if (FieldIndex == Layout.NumFields) return false;
+
+		const FQFieldLayout& Field = Layout.Fields[FieldIndex];
+		if (Field.Bits > MaxBucketedBits) return false;
+		for (size_t Edge = 0; Edge < NumEdges; ++Edge)
+		{
+			if (Edges[Edge] <= Field.Min || Edges[Edge] > Field.Max) return false;
+			if (Edge > 0 && Edges[Edge] <= Edges[Edge - 1]) return false;
+		}
+
+		for (auto It = Buckets.begin(); It != Buckets.end(); ++It)
+		{
+			if (It->FieldIndex == FieldIndex)
+			{
+				Buckets.erase(It);
+				break;
+			}
+		}
+		if (NumEdges == 0) return true;
+
+		FBucketedField Bucketed;
+		Bucketed.FieldIndex = FieldIndex;
+		Bucketed.Shift = Field.Shift;
+		Bucketed.Mask = (uint64_t(1) << Field.Bits) - 1;
+		Bucketed.NumBuckets = static_cast<uint32_t>(NumEdges + 1);
+		Bucketed.Lookup.resize(static_cast<size_t>(Bucketed.Mask) + 1);
+
+		// Values above Max can't come out of Pack (it clamps), they map to the last bucket anyway
+		size_t Edge = 0;
+		int32_t LowerBound = Field.Min;
+		for (size_t Offset = 0; Offset < Bucketed.Lookup.size(); ++Offset)
+		{
+			const int32_t Value = Field.Min + static_cast<int32_t>(Offset);
+			while (Edge < NumEdges && Value >= Edges[Edge]) LowerBound = Edges[Edge++];
+			Bucketed.Lookup[Offset] = static_cast<uint16_t>(LowerBound - Field.Min);
+		}
+
+		Buckets.push_back(std::move(Bucketed));
+		return true;
+	}
+
+	bool FQDiscretizer::HasSameBuckets(const FQDiscretizer& Other) const
+	{
+		if (Layout.Fields != Other.Layout.Fields || Layout.NumFields != Other.Layout.NumFields || Buckets.size() != Other.Buckets.size()) return false;
+
+		for (const FBucketedField& Field : Buckets) // set in any order
+		{
+			bool bMatched = false;
+			for (const FBucketedField& OtherField : Other.Buckets) bMatched |= OtherField.FieldIndex == Field.FieldIndex && OtherField.Lookup == Field.Lookup;
+			if (!bMatched) return false;
+		}
+		return true;
+	}
+
+	uint64_t FQDiscretizer::CountReachableKeys() const
+	{
+		uint64_t Count = 1;
+		for (size_t FieldIndex = 0; FieldIndex < Layout.NumFields; ++FieldIndex)
+		{
+			const FQFieldLayout& Field = Layout.Fields[FieldIndex];
+			uint64_t Values = static_cast<uint64_t>(static_cast<int64_t>(Field.Max) - Field.Min) + 1;
+			for (const FBucketedField& Bucketed : Buckets)
+			{
+				if (Bucketed.FieldIndex == FieldIndex) Values = Bucketed.NumBuckets;
+			}
+			Count *= Values;
+		}
+		return Count;
+	}
+
+	void DiscretizeTable(IQTable& Table, const FQDiscretizer& Discretizer)
+	{
+		if (Discretizer.IsIdentity()) return;
+
+		bool bAlreadyBucketed = true;
+		Table.ForEachRow([&](const FQKey Key, const float*) { bAlreadyBucketed &= Discretizer.Apply(Key) == Key; });
+		if (bAlreadyBucketed) return; // nothing to fold - also keeps an overlay's shared rows shared
+
+		struct FRowCopy
+		{
+			FQKey Key;
+			float Values[RowWidth];
+			uint32_t Visits[RowWidth];
+		};
+
+		const int32_t NumActions = Table.GetNumActions();
+		std::vector<FRowCopy> Copies;
+		Copies.reserve(Table.Num());
+		Table.ForEachRow([&](const FQKey Key, const float* Row)
+		{
+			FRowCopy Copy;
+			Copy.Key = Key;
+			std::memcpy(Copy.Values, Row, sizeof(Copy.Values));
+			for (int32_t Action = 0; Action < NumActions; ++Action) Copy.Visits[Action] = Table.GetVisitCount(Key, Action);
+			Copies.push_back(Copy);
+		});
+
+		Table.Empty();
+		std::unordered_map<FQKey, int32_t> Counts;
+		for (const FRowCopy& Copy : Copies)
+		{
+			const FQKey Key = Discretizer.Apply(Copy.Key);
+			const int32_t Count = ++Counts[Key];
+			float Row[RowWidth] = {};
+			uint32_t Visits[RowWidth] = {};
+			Table.LoadRow(Key, Row);
+			for (int32_t Action = 0; Action < NumActions; ++Action)
+			{
+				Row[Action] += (Copy.Values[Action] - Row[Action]) / static_cast<float>(Count); // running mean
+				Visits[Action] = Table.GetVisitCount(Key, Action) + Copy.Visits[Action]; // merged states' visits add up
+			}
+			Table.StoreRow(Key, Row);
+			Table.StoreVisitCounts(Key, Visits); // no-op without counts
+		}
+	}
+}
@@ -0,0 +1,276 @@
+#include "QCore/QDynaPlanner.h"
+#include "QCore/QAtomicDenseTable.h"
+#include <algorithm>
+
+
+namespace QCore
+{
+	FQDynaPlanner::FQDynaPlanner() = default;
+
+	void FQDynaPlanner::Start(const IQTable& Live, const FQLearnerConfig& LearnerConfig, const bool bThreaded)
+	{
+		Stop();
+
+		Planner.Config = LearnerConfig;
+		Planner.SetTable(MakeTable(ETableBackend::Map, Live.GetNumActions(), 0));
+		IQTable& Copy = *Planner.GetTable();
+		Live.ForEachRow([&Copy](const FQKey Key, const float* Row) { Copy.StoreRow(Key, Row); });
+
+		Model.Empty();
+		ModelSize = 0;
+		BatchChanges.clear();
+		PendingTransitions.clear();
+		Inbox.clear();
+		InboxRows.clear();
+		Outbox.clear();
+		NumUnpublished = 0;
+		bStopRequested = false;
+
+		if (bThreaded) Worker = std::thread(&FQDynaPlanner::Run, this);
+	}
+
+	void FQDynaPlanner::Stop()
+	{
+		if (!Worker.joinable()) return;
+		{
+			const std::lock_guard<std::mutex> Lock(Mutex);
+			bStopRequested = true;
+		}
+		WakeUp.notify_one();
+		Worker.join();
+	}
+
+	size_t FQDynaPlanner::Publish(IQTable& Live)
+	{
+		{
+			const std::lock_guard<std::mutex> Lock(Mutex);
+			PublishedChanges.swap(Outbox);
+			NumUnpublished = 0;
+		}
+
+		const bool bAtomic = Live.GetValueType() == EQValueType::AtomicFloat; // shared table, other learners may be writing
+		PublishedStates.clear();
+		for (const auto& [Pair, Change] : PublishedChanges)
+		{
+			PublishedStates.push_back(Pair.State);
+			if (bAtomic)
+			{
+				AtomicAdd(Live.FindOrAddRowAs<std::atomic<float>>(Pair.State)[Pair.Action], Change);
+				continue;
+			}
+
+			float Row[RowWidth] = {};
+			Live.LoadRow(Pair.State, Row);
+			Row[Pair.Action] += Change;
+			Live.StoreRow(Pair.State, Row);
+		}
+		const size_t NumChanges = PublishedChanges.size();
+		PublishedChanges.clear();
+
+		// Rows are read after the changes above, the worker adds back whatever it planned since the swap. Changed rows
+		// go back too: other planners on the same live table publish into them, and a change measured against a
+		// stale row would stack on top of theirs
+		for (const FQTransition& Transition : PendingTransitions) PublishedStates.push_back(Transition.PrevState);
+		if (!PublishedStates.empty())
+		{
+			std::sort(PublishedStates.begin(), PublishedStates.end());
+			PublishedStates.erase(std::unique(PublishedStates.begin(), PublishedStates.end()), PublishedStates.end());
+			PublishedRows.resize(PublishedStates.size());
+			for (size_t Index = 0; Index < PublishedStates.size(); ++Index)
+			{
+				FLiveRow& Published = PublishedRows[Index];
+				Published.State = PublishedStates[Index];
+				for (float& Value : Published.Row) Value = 0.f;
+				Live.LoadRow(Published.State, Published.Row);
+			}
+
+			const std::lock_guard<std::mutex> Lock(Mutex);
+			Inbox.insert(Inbox.end(), PendingTransitions.begin(), PendingTransitions.end());
+			InboxRows.insert(InboxRows.end(), PublishedRows.begin(), PublishedRows.end());
+		}
+		PendingTransitions.clear();
+
+		WakeUp.notify_one();
+		return NumChanges;
+	}
+
+	int32_t FQDynaPlanner::Plan(const int32_t NumUpdates)
+	{
+		if (IsRunning() || !Planner.GetTable()) return 0;
+
+		int32_t Allowed;
+		{
+			const std::lock_guard<std::mutex> Lock(Mutex);
+			Allowed = ApplyInbox(NumUpdates);
+		}
+
+		const int32_t Done = PlanBatch(Allowed);
+
+		const std::lock_guard<std::mutex> Lock(Mutex);
+		MergeBatchChanges(Done);
+		return Done;
+	}
+
+	void FQDynaPlanner::Run()
+	{
+		for (;;)
+		{
+			int32_t Allowed;
+			{
+				std::unique_lock<std::mutex> Lock(Mutex);
+				WakeUp.wait(Lock, [this]()
+				{
+					return bStopRequested || !InboxRows.empty() || (Model.Num() > 0 && NumUnpublished < Config.MaxUnpublishedUpdates);
+				});
+				if (bStopRequested) return;
+				Allowed = ApplyInbox(Config.UpdatesPerBatch);
+			}
+
+			const int32_t Done = PlanBatch(Allowed);
+
+			const std::lock_guard<std::mutex> Lock(Mutex);
+			MergeBatchChanges(Done);
+		}
+	}
+
+	int32_t FQDynaPlanner::ApplyInbox(const int32_t MaxUpdates)
+	{
+		IQTable& Copy = *Planner.GetTable();
+		for (const FQTransition& Transition : Inbox) Model.Observe(Transition);
+		Inbox.clear();
+
+		// Live row + planned changes it hasn't received yet
+		for (FLiveRow& Published : InboxRows)
+		{
+			for (int32_t Action = 0; Action < Copy.GetNumActions(); ++Action)
+			{
+				const auto It = Outbox.find({ Published.State, Action });
+				if (It != Outbox.end()) Published.Row[Action] += It->second;
+			}
+			Copy.StoreRow(Published.State, Published.Row);
+		}
+		InboxRows.clear();
+		ModelSize.store(Model.Num(), std::memory_order_relaxed);
+
+		const int32_t Remaining = Config.MaxUnpublishedUpdates - NumUnpublished;
+		return Remaining < MaxUpdates ? (Remaining > 0 ? Remaining : 0) : MaxUpdates;
+	}
+
+	int32_t FQDynaPlanner::PlanBatch(const int32_t NumUpdates)
+	{
+		IQTable& Copy = *Planner.GetTable();
+		FQTransition Simulated;
+		int32_t Done = 0;
+		for (; Done < NumUpdates && Model.Sample(Rng, Simulated); ++Done)
+		{
+			const FQRow Row = Copy.FindRow(Simulated.PrevState); // every modelled state was stored by ApplyInbox
+			const float Before = Row[Simulated.ActionTaken];
+			Planner.ReplayQValue(Simulated.PrevState, Simulated.ActionTaken, Simulated.Reward, Simulated.NewState);
+			BatchChanges[{ Simulated.PrevState, Simulated.ActionTaken }] += Row[Simulated.ActionTaken] - Before;
+		}
+		NumPlanningUpdates.fetch_add(static_cast<uint64_t>(Done), std::memory_order_relaxed);
+		return Done;
+	}
+
+	void FQDynaPlanner::MergeBatchChanges(const int32_t NumUpdates)
+	{
+		for (const auto& [Pair, Change] : BatchChanges) Outbox[Pair] += Change;
+		BatchChanges.clear();
+		NumUnpublished += NumUpdates;
+	}
+
+
+	void FQDynaWorker::Start()
+	{
+		if (Worker.joinable()) return;
+		bStopRequested = false;
+		Worker = std::thread(&FQDynaWorker::Run, this);
+	}
+
+	void FQDynaWorker::Add(FQDynaPlanner& Planner)
+	{
+		const std::lock_guard<std::mutex> Lock(Mutex);
+		Planners.push_back(&Planner);
+		NumIdle = 0;
+	}
+
+	void FQDynaWorker::Remove(FQDynaPlanner& Planner)
+	{
+		std::unique_lock<std::mutex> Lock(Mutex);
+		Planners.erase(std::remove(Planners.begin(), Planners.end(), &Planner), Planners.end());
+		BatchDone.wait(Lock, [this, &Planner]() { return Planning != &Planner; });
+	}
+
+	void FQDynaWorker::BeginFrame()
+	{
+		{
+			const std::lock_guard<std::mutex> Lock(Mutex);
+			Budget = UpdatesPerFrame;
+			NumIdle = 0;
+		}
+		WakeUp.notify_one();
+	}
+
+	void FQDynaWorker::Stop()
+	{
+		{
+			const std::lock_guard<std::mutex> Lock(Mutex);
+			bStopRequested = true;
+		}
+		WakeUp.notify_one();
+		if (Worker.joinable()) Worker.join();
+
+		const std::lock_guard<std::mutex> Lock(Mutex);
+		Planners.clear();
+		Budget = 0;
+	}
+
+	size_t FQDynaWorker::Num() const
+	{
+		const std::lock_guard<std::mutex> Lock(Mutex);
+		return Planners.size();
+	}
+
+	int32_t FQDynaWorker::PlanFrame()
+	{
+		if (IsRunning()) return 0;
+
+		const uint64_t Before = GetNumPlanningUpdates();
+		std::unique_lock<std::mutex> Lock(Mutex);
+		Budget = UpdatesPerFrame;
+		NumIdle = 0;
+		while (PlanNext(Lock)) {}
+		return static_cast<int32_t>(GetNumPlanningUpdates() - Before);
+	}
+
+	void FQDynaWorker::Run()
+	{
+		std::unique_lock<std::mutex> Lock(Mutex);
+		for (;;)
+		{
+			WakeUp.wait(Lock, [this]() { return bStopRequested || (Budget > 0 && !Planners.empty()); });
+			if (bStopRequested) return;
+			PlanNext(Lock);
+		}
+	}
+
+	bool FQDynaWorker::PlanNext(std::unique_lock<std::mutex>& Lock)
+	{
+		if (Budget <= 0 || Planners.empty()) return false;
+
+		FQDynaPlanner* Planner = Planners[Next++ % Planners.size()];
+		const int32_t Batch = std::min(std::max(Planner->Config.UpdatesPerBatch, 1), Budget);
+		Planning = Planner;
+		Lock.unlock();
+		const int32_t Done = Planner->Plan(Batch);
+		Lock.lock();
+		Planning = nullptr;
+		BatchDone.notify_all();
+
+		NumPlanningUpdates.fetch_add(static_cast<uint64_t>(Done), std::memory_order_relaxed);
+		Budget -= Done;
+		NumIdle = Done > 0 ? 0 : NumIdle + 1;
+		if (NumIdle >= Planners.size()) Budget = 0; // all waiting for a Publish (or nothing observed yet) - sleep until the next frame
+		return true;
+	}
+}
@@ -0,0 +1,229 @@
+#include "QCore/QLearner.h"
+#include "QCore/QAtomicDenseTable.h"
+#include "QCore/QRowKernels.h"
+#include <cmath>
+
+
+namespace QCore
+{
+	namespace
+	{
+		/* Row access per table value type. Updates go through Add (Q += Delta) so an AtomicFloat cell is one CAS */
+		struct FFloatRowOps
+		{
+			using FRow = FQRow;
+			using FConstRow = FQConstRow;
+			using FValue = float;
+
+			float Get(const FConstRow& Row, const int32_t Action) const { return Row[Action]; }
+			void Add(const FRow& Row, const int32_t Action, const float Delta) const { Row[Action] += Delta; }
+			float Max(const FConstRow& Row) const { return MaxRow(Row.GetData()); }
+			int32_t ArgMax(const FConstRow& Row) const { return ArgMaxRow(Row.GetData()); }
+		};
+
+		struct FInt16RowOps
+		{
+			using FRow = FQRow16;
+			using FConstRow = FQConstRow16;
+			using FValue = int16_t;
+
+			float Scale;
+			float InvScale;
+
+			float Get(const FConstRow& Row, const int32_t Action) const { return static_cast<float>(Row[Action]) * Scale; }
+			void Add(const FRow& Row, const int32_t Action, const float Delta) const { Row[Action] = Quantize16(Get(Row, Action) + Delta, InvScale); }
+			float Max(const FConstRow& Row) const { return MaxRow16(Row.GetData(), Scale); }
+			int32_t ArgMax(const FConstRow& Row) const { return ArgMaxRow16(Row.GetData()); }
+		};
+
+		struct FAtomicRowOps
+		{
+			using FRow = FQAtomicRow;
+			using FConstRow = FQConstAtomicRow;
+			using FValue = std::atomic<float>;
+
+			float Get(const FConstRow& Row, const int32_t Action) const { return Row[Action].load(std::memory_order_relaxed); }
+			void Add(const FRow& Row, const int32_t Action, const float Delta) const { AtomicAdd(Row[Action], Delta); }
+			float Max(const FConstRow& Row) const
+			{
+				alignas(RowAlignment) float Snapshot[RowWidth];
+				LoadAtomicRow(Row.GetData(), Snapshot);
+				return MaxRow(Snapshot);
+			}
+			int32_t ArgMax(const FConstRow& Row) const
+			{
+				alignas(RowAlignment) float Snapshot[RowWidth];
+				LoadAtomicRow(Row.GetData(), Snapshot);
+				return ArgMaxRow(Snapshot);
+			}
+		};
+
+		/* Func(Ops) with the ops matching Table's value type */
+		template <typename FuncType>
+		decltype(auto) WithRowOps(const IQTable& Table, FuncType&& Func)
+		{
+			switch (Table.GetValueType())
+			{
+				case EQValueType::Int16: return Func(FInt16RowOps{ Table.GetValueScale(), 1.f / Table.GetValueScale() });
+				case EQValueType::AtomicFloat: return Func(FAtomicRowOps{});
+				case EQValueType::Float:
+				default: return Func(FFloatRowOps{});
+			}
+		}
+
+		template <typename OpsType>
+		using TRowValue = typename std::decay_t<OpsType>::FValue;
+
+		/* Missing rows are implicit defaults: every action 0 */
+		template <typename OpsType>
+		float MaxOrDefault(const OpsType& Ops, const typename OpsType::FConstRow& Row) { return Row ? Ops.Max(Row) : 0.f; }
+	}
+
+
+	FQLearner::FQLearner() = default;
+
+	int32_t FQLearner::ChooseAction(const FQKey State)
+	{
+		return WithRowOps(*Table, [this, State](const auto& Ops) { return ChooseActionImpl(Ops, State); });
+	}
+
+	template <typename OpsType>
+	int32_t FQLearner::ChooseActionImpl(const OpsType& Ops, const FQKey State)
+	{
+		const float Epsilon = Config.ExplorationRate;
+		const IQTable& ConstTable = *Table;
+		const typename OpsType::FConstRow Row = ConstTable.FindRowAs<typename OpsType::FValue>(State); // unseen states aren't stored until an update writes to them
+
+		// Exploration
+		if (Rng.Chance(Epsilon))
+		{
+			return static_cast<int32_t>(Rng.NextBounded(static_cast<uint32_t>(Table->GetNumActions()))); // Random Action
+		}
+
+		// Exploitation
+		return Row ? Ops.ArgMax(Row) : 0;
+	}
+
+	int32_t FQLearner::ChooseGreedyAction(const FQKey State) const
+	{
+		const IQTable& ConstTable = *Table;
+		return WithRowOps(ConstTable, [&ConstTable, State](const auto& Ops)
+		{
+			const auto Row = ConstTable.FindRowAs<TRowValue<decltype(Ops)>>(State);
+			return Row ? Ops.ArgMax(Row) : 0;
+		});
+	}
+
+	void FQLearner::UpdateQValue(const FQKey PrevState, const int32_t ActionTaken, const float Reward, const FQKey NewState)
+	{
+		WithRowOps(*Table, [&](const auto& Ops) { UpdateQValueImpl(Ops, PrevState, ActionTaken, Reward, NewState); });
+	}
+
+	template <typename OpsType>
+	void FQLearner::UpdateQValueImpl(const OpsType& Ops, const FQKey PrevState, const int32_t ActionTaken, const float Reward, const FQKey NewState)
+	{
+		using FValue = typename OpsType::FValue;
+		const float Gamma = Config.DiscountFactor;
+
+		// One probe per state: the handles are reused for the update (and traces on PrevState)
+		uint32_t* Counts;
+		typename OpsType::FRow Row = Table->FindRowAs<FValue>(PrevState, Counts);
+		const float MaxFutureQ = MaxOrDefault(Ops, static_cast<const IQTable&>(*Table).FindRowAs<FValue>(NewState)); // an unseen s' only contributes 0, it isn't stored
+
+		if (Config.TraceDecay <= 0.f)
+		{
+			ApplyTarget(Ops, Row, Counts, PrevState, ActionTaken, Reward + Gamma * MaxFutureQ);
+			return;
+		}
+
+		// Watkins Q(lambda): an exploratory action breaks the greedy chain, older pairs get no credit for what follows
+		const float Delta = Reward + Gamma * MaxFutureQ - (Row ? Ops.Get(Row, ActionTaken) : 0.f);
+		if (!Row && (Delta != 0.f || Table->HasVisitCounts())) Row = Table->FindOrAddRowAs<FValue>(PrevState, Counts);
+		CountStepSize(Counts, ActionTaken); // traced pairs were all counted when taken
+		if (Row && Ops.Get(Row, ActionTaken) < Ops.Max(Row)) Traces.Empty();
+		Traces.Mark(PrevState, ActionTaken);
+
+		if (Delta != 0.f)
+		{
+			// PrevState first: re-adding an older traced row may evict it on a memory-capped table
+			for (const FQTraceList::FTrace& Trace : Traces)
+			{
+				if (Trace.Key == PrevState) Ops.Add(Row, Trace.Action, GetStepSize(Counts, Trace.Action) * Delta * Trace.Eligibility);
+			}
+			for (const FQTraceList::FTrace& Trace : Traces)
+			{
+				if (Trace.Key == PrevState) continue;
+				uint32_t* TracedCounts;
+				const typename OpsType::FRow TracedRow = Table->FindOrAddRowAs<FValue>(Trace.Key, TracedCounts);
+				Ops.Add(TracedRow, Trace.Action, GetStepSize(TracedCounts, Trace.Action) * Delta * Trace.Eligibility);
+			}
+		}
+		Traces.Decay(Gamma * Config.TraceDecay, Config.TraceThreshold);
+	}
+
+	void FQLearner::ReplayQValue(const FQKey PrevState, const int32_t ActionTaken, const float Reward, const FQKey NewState)
+	{
+		WithRowOps(*Table, [&](const auto& Ops)
+		{
+			uint32_t* Counts;
+			const auto Row = Table->FindRowAs<TRowValue<decltype(Ops)>>(PrevState, Counts);
+			const float MaxFutureQ = MaxOrDefault(Ops, static_cast<const IQTable&>(*Table).FindRowAs<TRowValue<decltype(Ops)>>(NewState)); // read only
+			ApplyTarget(Ops, Row, Counts, PrevState, ActionTaken, Reward + Config.DiscountFactor * MaxFutureQ);
+		});
+	}
+
+	void FQLearner::UpdateQValueToTarget(const FQKey State, const int32_t Action, const float Target)
+	{
+		WithRowOps(*Table, [&](const auto& Ops)
+		{
+			uint32_t* Counts;
+			const auto Row = Table->FindRowAs<TRowValue<decltype(Ops)>>(State, Counts);
+			ApplyTarget(Ops, Row, Counts, State, Action, Target);
+		});
+	}
+
+	float FQLearner::GetQValue(const FQKey State, const int32_t Action) const
+	{
+		const IQTable& ConstTable = *Table;
+		return WithRowOps(ConstTable, [&](const auto& Ops)
+		{
+			const auto Row = ConstTable.FindRowAs<TRowValue<decltype(Ops)>>(State);
+			return Row ? Ops.Get(Row, Action) : 0.f;
+		});
+	}
+
+	float FQLearner::GetMaxQValue(const FQKey State) const
+	{
+		const IQTable& ConstTable = *Table;
+		return WithRowOps(ConstTable, [&](const auto& Ops)
+		{
+			const auto Row = ConstTable.FindRowAs<TRowValue<decltype(Ops)>>(State);
+			return Row ? Ops.Max(Row) : 0.f;
+		});
+	}
+
+	template <typename OpsType>
+	void FQLearner::ApplyTarget(const OpsType& Ops, typename OpsType::FRow Row, uint32_t* Counts, const FQKey State, const int32_t Action, const float Target)
+	{
+		if (!Row)
+		{
+			if (Target == 0.f && !Table->HasVisitCounts()) return; // Q stays at the implicit 0, nothing to store
+			Row = Table->FindOrAddRowAs<typename OpsType::FValue>(State, Counts);
+		}
+		Ops.Add(Row, Action, CountStepSize(Counts, Action) * (Target - Ops.Get(Row, Action)));
+	}
+
+	float FQLearner::GetStepSize(const uint32_t* Counts, const int32_t Action) const
+	{
+		if (!Counts || Config.VisitCountExponent <= 0.f || Counts[Action] == 0) return Config.LearningRate;
+
+		const float Alpha = std::pow(static_cast<float>(Counts[Action]), -Config.VisitCountExponent);
+		return Alpha > Config.LearningRate ? Alpha : Config.LearningRate;
+	}
+
+	float FQLearner::CountStepSize(uint32_t* Counts, const int32_t Action) const
+	{
+		if (Counts && Counts[Action] != ~uint32_t(0)) ++Counts[Action];
+		return GetStepSize(Counts, Action);
+	}
+}
@@ -0,0 +1,247 @@
+#include "QCore/QMapTable.h"
+#include "QCore/QRowKernels.h"
+#include "QCore/QStateSchema.h"
+
+
+namespace QCore
+{
+	template <typename ValueType>
+	size_t TQMapTable<ValueType>::FKeyHash::operator()(const FKey& Key) const
+	{
+		return HashKey(Key.Key);
+	}
+
+	template <typename ValueType>
+	TQMapTable<ValueType>::TQMapTable(const int32_t InNumActions, const float InValueScale)
+		: IQTable(InNumActions, TQValueType<ValueType>::Value, InValueScale)
+	{
+	}
+
+	template <typename ValueType>
+	typename TQMapTable<ValueType>::FNode& TQMapTable<ValueType>::FindOrAddNode(const FQKey Key)
+	{
+		const auto [It, bInserted] = Rows.try_emplace({ Key }); // one hash + probe for both cases
+		FNode& Node = *It;
+		if (!bInserted)
+		{
+			Touch(Node);
+			return Node;
+		}
+
+		InitRow(Node.second.Values, NumActions);
+		if (bVisitCounts) AddCounts(Node.first);
+		if (MaxRows)
+		{
+			if (Ring.size() < MaxRows)
+			{
+				Ring.push_back(&Node);
+			}
+			else
+			{
+				const size_t Slot = FindVictim();
+				Evict(Slot);
+				Ring[Slot] = &Node;
+			}
+			LastAccessed = &Node;
+		}
+		return Node;
+	}
+
+	template <typename ValueType>
+	const void* TQMapTable<ValueType>::FindRowData(const FQKey Key) const
+	{
+		const auto It = Rows.find({ Key });
+		if (It == Rows.end()) return nullptr;
+		Touch(*It);
+		return It->second.Values;
+	}
+
+	template <typename ValueType>
+	void TQMapTable<ValueType>::Touch(const FNode& Node) const
+	{
+		if (!MaxRows) return;
+		Node.first.bReferenced = 1;
+		LastAccessed = &Node;
+	}
+
+	template <typename ValueType>
+	void TQMapTable<ValueType>::Empty()
+	{
+		Rows.clear();
+		CountChunks.clear();
+		FreeCounts.clear();
+		NumCountRows = 0;
+		Ring.clear();
+		Hand = 0;
+		LastAccessed = nullptr;
+	}
+
+	template <typename ValueType>
+	bool TQMapTable<ValueType>::EnableVisitCounts()
+	{
+		if (bVisitCounts) return true;
+		bVisitCounts = true;
+		for (const auto& Pair : Rows) AddCounts(Pair.first);
+		return true;
+	}
+
+	template <typename ValueType>
+	void* TQMapTable<ValueType>::FindOrAddCountedRowData(const FQKey Key, uint32_t*& OutCounts)
+	{
+		FNode& Node = FindOrAddNode(Key);
+		OutCounts = bVisitCounts ? GetCounts(Node.first.CountsIndex) : nullptr;
+		return Node.second.Values;
+	}
+
+	template <typename ValueType>
+	const void* TQMapTable<ValueType>::FindCountedRowData(const FQKey Key, const uint32_t*& OutCounts) const
+	{
+		const auto It = Rows.find({ Key });
+		if (It == Rows.end())
+		{
+			OutCounts = nullptr;
+			return nullptr;
+		}
+		Touch(*It);
+		OutCounts = bVisitCounts ? GetCounts(It->first.CountsIndex) : nullptr;
+		return It->second.Values;
+	}
+
+	template <typename ValueType>
+	void TQMapTable<ValueType>::AddCounts(const FKey& Key)
+	{
+		if (!FreeCounts.empty())
+		{
+			Key.CountsIndex = FreeCounts.back();
+			FreeCounts.pop_back();
+		}
+		else
+		{
+			if (NumCountRows == CountChunks.size() * CountChunkRows)
+			{
+				CountChunks.emplace_back(new uint32_t[CountChunkRows * NumActions]());
+			}
+			Key.CountsIndex = NumCountRows++;
+		}
+		uint32_t* Counts = GetCounts(Key.CountsIndex);
+		for (int32_t Action = 0; Action < NumActions; ++Action) Counts[Action] = 0;
+	}
+
+	template <typename ValueType>
+	uint32_t TQMapTable<ValueType>::SumCounts(const FKey& Key) const
+	{
+		const uint32_t* Counts = GetCounts(Key.CountsIndex);
+		uint64_t Sum = 0;
+		for (int32_t Action = 0; Action < NumActions; ++Action) Sum += Counts[Action];
+		return Sum < ~uint32_t(0) ? static_cast<uint32_t>(Sum) : ~uint32_t(0);
+	}
+
+	template <typename ValueType>
+	bool TQMapTable<ValueType>::SetMemoryLimit(const size_t Bytes, const EQEvictionPolicy Policy)
+	{
+		// Per row: node, ~one bucket pointer, ring pointer, counts
+		constexpr size_t NodeSize = (sizeof(FNode) + 2 * sizeof(void*) + alignof(FRow) - 1) / alignof(FRow) * alignof(FRow);
+		const size_t RowBytes = NodeSize + 2 * sizeof(void*) + (bVisitCounts ? NumActions * sizeof(uint32_t) : 0);
+
+		Eviction = Policy;
+		MaxRows = Bytes ? (Bytes / RowBytes > 2 ? Bytes / RowBytes : 2) : 0; // 2+ so the last looked up row can be spared
+		Ring.clear();
+		Hand = 0;
+		LastAccessed = nullptr;
+		if (!MaxRows)
+		{
+			Ring.shrink_to_fit();
+			return true;
+		}
+
+		Ring.reserve(MaxRows);
+		for (auto It = Rows.begin(); It != Rows.end(); )
+		{
+			if (Ring.size() < MaxRows)
+			{
+				Ring.push_back(&*It++);
+				continue;
+			}
+			if (bVisitCounts) FreeCounts.push_back(It->first.CountsIndex); // over the cap already - trimmed in table order
+			It = Rows.erase(It);
+			++NumEvicted;
+		}
+		return true;
+	}
+
+	template <typename ValueType>
+	size_t TQMapTable<ValueType>::FindVictim()
+	{
+		const size_t NumSlots = Ring.size();
+		if (Eviction == EQEvictionPolicy::LeastVisited && bVisitCounts)
+		{
+			size_t Victim = NumSlots;
+			uint32_t VictimVisits = ~uint32_t(0);
+			for (int32_t Sample = 0; Sample < EvictionSamples && Sample < static_cast<int32_t>(NumSlots); ++Sample)
+			{
+				const size_t Slot = (Hand + Sample) % NumSlots;
+				if (Ring[Slot] == LastAccessed) continue;
+				const uint32_t Visits = SumCounts(Ring[Slot]->first);
+				if (Visits < VictimVisits || Victim == NumSlots)
+				{
+					Victim = Slot;
+					VictimVisits = Visits;
+				}
+			}
+			Hand = (Victim + 1) % NumSlots;
+			return Victim;
+		}
+
+		// Clock: clear referenced bits until an unreferenced row is under the hand (at most one full turn)
+		for (;;)
+		{
+			const size_t Slot = Hand;
+			Hand = (Hand + 1) % NumSlots;
+			const FNode* Node = Ring[Slot];
+			if (Node == LastAccessed) continue;
+			if (!Node->first.bReferenced) return Slot;
+			Node->first.bReferenced = 0;
+		}
+	}
+
+	template <typename ValueType>
+	void TQMapTable<ValueType>::Evict(const size_t Slot)
+	{
+		const FNode* Node = Ring[Slot];
+		if (bVisitCounts) FreeCounts.push_back(Node->first.CountsIndex);
+		Rows.erase(Node->first.Key);
+		++NumEvicted;
+	}
+
+	template <typename ValueType>
+	size_t TQMapTable<ValueType>::GetAllocatedSize() const
+	{
+		static_assert(sizeof(std::pair<const FKey, FRow>) == sizeof(std::pair<const FQKey, FRow>), "counts index must fit the key padding");
+
+		// Node = key + row + next pointer (+ cached hash), rounded to the row alignment
+		constexpr size_t NodeSize = (sizeof(FQKey) + sizeof(FRow) + 2 * sizeof(void*) + alignof(FRow) - 1) / alignof(FRow) * alignof(FRow);
+		return Rows.size() * NodeSize + Rows.bucket_count() * sizeof(void*) + CountChunks.size() * CountChunkRows * NumActions * sizeof(uint32_t)
+			+ Ring.capacity() * sizeof(FNode*);
+	}
+
+	template <typename ValueType>
+	void TQMapTable<ValueType>::ForEachRow(const std::function<void(FQKey, const float*)>& Func) const
+	{
+		for (const auto& Pair : Rows)
+		{
+			if constexpr (std::is_same_v<ValueType, float>)
+			{
+				Func(Pair.first.Key, Pair.second.Values);
+			}
+			else
+			{
+				alignas(RowAlignment) float Row[RowWidth];
+				for (int32_t Lane = 0; Lane < RowWidth; ++Lane) Row[Lane] = Dequantize16(Pair.second.Values[Lane], ValueScale);
+				Func(Pair.first.Key, Row);
+			}
+		}
+	}
+
+	template class TQMapTable<float>;
+	template class TQMapTable<int16_t>;
+}
@@ -0,0 +1,112 @@
+#include "QCore/QOverlayTable.h"
+#include "QCore/QMapTable.h"
+#include <cstring>
+
+
+namespace QCore
+{
+	namespace
+	{
+		const uint32_t NoCounts[RowWidth] = {}; // shared rows of a view saved without counts
+	}
+
+	FQOverlayTable::FQOverlayTable(std::shared_ptr<const FQTableView> InBase)
+		: IQTable(InBase->GetNumActions(), InBase->GetValueType(), InBase->GetValueScale())
+		, Base(std::move(InBase))
+	{
+		const bool bInt16 = StoredType == EQValueType::Int16;
+		if (bInt16) Rows = std::make_unique<FQMapTable16>(NumActions, ValueScale); // same scale, copied rows stay bit-exact
+		else Rows = std::make_unique<FQMapTable>(NumActions);
+		RowBytes = RowWidth * (bInt16 ? sizeof(int16_t) : sizeof(float));
+	}
+
+	bool FQOverlayTable::Contains(const FQKey Key) const
+	{
+		return Rows->Contains(Key) || (Base && Base->FindRowIndex(Key) != FQTableView::NoRow);
+	}
+
+	const void* FQOverlayTable::FindRowData(const FQKey Key) const
+	{
+		if (const void* Data = Rows->FindRowData(Key)) return Data;
+		return Base ? Base->FindRowData(Key) : nullptr;
+	}
+
+	const void* FQOverlayTable::FindCountedRowData(const FQKey Key, const uint32_t*& OutCounts) const
+	{
+		if (const void* Data = Rows->FindCountedRowData(Key, OutCounts)) return Data;
+
+		OutCounts = nullptr;
+		const uint32_t Row = Base ? Base->FindRowIndex(Key) : FQTableView::NoRow;
+		if (Row == FQTableView::NoRow) return nullptr;
+		if (bVisitCounts) OutCounts = Base->HasVisitCounts() ? Base->GetVisitCounts(Row) : NoCounts;
+		return Base->GetRowData(Row);
+	}
+
+	void* FQOverlayTable::CopyOnWrite(const FQKey Key, const bool bAdd, uint32_t*& OutCounts)
+	{
+		if (void* Data = Rows->FindMutableCountedRowData(Key, OutCounts)) return Data;
+
+		const uint32_t Row = Base ? Base->FindRowIndex(Key) : FQTableView::NoRow;
+		if (Row == FQTableView::NoRow && !bAdd) return nullptr;
+
+		void* Data = Rows->FindOrAddCountedRowData(Key, OutCounts);
+		if (Row == FQTableView::NoRow) return Data;
+
+		std::memcpy(Data, Base->GetRowData(Row), RowBytes);
+		if (OutCounts && Base->HasVisitCounts()) std::memcpy(OutCounts, Base->GetVisitCounts(Row), NumActions * sizeof(uint32_t));
+		++NumShadowed;
+		return Data;
+	}
+
+	void* FQOverlayTable::FindOrAddRowData(const FQKey Key)
+	{
+		uint32_t* Counts;
+		return CopyOnWrite(Key, true, Counts);
+	}
+
+	void* FQOverlayTable::FindMutableRowData(const FQKey Key)
+	{
+		uint32_t* Counts;
+		return CopyOnWrite(Key, false, Counts);
+	}
+
+	void* FQOverlayTable::FindOrAddCountedRowData(const FQKey Key, uint32_t*& OutCounts)
+	{
+		return CopyOnWrite(Key, true, OutCounts);
+	}
+
+	void* FQOverlayTable::FindMutableCountedRowData(const FQKey Key, uint32_t*& OutCounts)
+	{
+		return CopyOnWrite(Key, false, OutCounts);
+	}
+
+	size_t FQOverlayTable::Num() const
+	{
+		return Rows->Num() + (Base ? Base->Num() : 0) - NumShadowed;
+	}
+
+	void FQOverlayTable::Empty()
+	{
+		Base.reset();
+		Rows->Empty();
+		NumShadowed = 0;
+	}
+
+	void FQOverlayTable::ForEachRow(const std::function<void(FQKey, const float*)>& Func) const
+	{
+		Rows->ForEachRow(Func);
+		if (!Base) return;
+
+		Base->ForEachRow([this, &Func](const FQKey Key, const float* Row)
+		{
+			if (!Rows->Contains(Key)) Func(Key, Row); // shadowed by a private copy
+		});
+	}
+
+	bool FQOverlayTable::EnableVisitCounts()
+	{
+		if (!Rows->EnableVisitCounts()) return false;
+		bVisitCounts = true;
+		return true;
+	}
+}
@@ -0,0 +1,492 @@
+#include "QCore/QPersistence.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+
+namespace QCore
+{
+	namespace
+	{
+		/* Just enough JSON for the two-level table object: strings without escapes that matter, numbers, objects */
+		struct FJsonCursor
+		{
+			const char* Pos;
+			const char* End;
+
+			void SkipWhitespace()
+			{
+				while (Pos < End && (*Pos == ' ' || *Pos == '\t' || *Pos == '\n' || *Pos == '\r')) ++Pos;
+			}
+
+			bool Consume(const char Expected)
+			{
+				SkipWhitespace();
+				if (Pos == End || *Pos != Expected) return false;
+				++Pos;
+				return true;
+			}
+
+			bool ReadString(const char*& OutBegin, const char*& OutEnd)
+			{
+				if (!Consume('"')) return false;
+				OutBegin = Pos;
+				while (Pos < End && *Pos != '"')
+				{
+					if (*Pos == '\\' && Pos + 1 < End) ++Pos;
+					++Pos;
+				}
+				if (Pos == End) return false;
+				OutEnd = Pos++;
+				return true;
+			}
+
+			bool ReadNumber(double& OutValue)
+			{
+				SkipWhitespace();
+				char Buffer[64];
+				size_t Length = 0;
+				while (Pos < End && Length + 1 < sizeof(Buffer) && *Pos && std::strchr("+-.eE0123456789", *Pos))
+				{
+					Buffer[Length++] = *Pos++;
+				}
+				if (Length == 0) return false;
+				Buffer[Length] = '\0';
+
+				char* ParseEnd = nullptr;
+				OutValue = std::strtod(Buffer, &ParseEnd);
+				return ParseEnd == Buffer + Length;
+			}
+		};
+
+		/* Visit counts are stored beside the rows as "N:50.100.0.1.0.0.1" entries - '.' instead of '_' so that readers
+		 * without counts (these and the old UE loader) see a single field and skip the entry as an unparseable key */
+		constexpr char CountsPrefix[] = "N:";
+		constexpr size_t CountsPrefixLength = sizeof(CountsPrefix) - 1;
+
+		bool IsDefaultRow(const float* Row, const int32_t NumActions)
+		{
+			for (int32_t Action = 0; Action < NumActions; ++Action)
+			{
+				if (Row[Action] != 0.f) return false;
+			}
+			return true;
+		}
+
+		bool HasVisits(const IQTable& Table, const FQKey Key)
+		{
+			for (int32_t Action = 0; Action < Table.GetNumActions(); ++Action)
+			{
+				if (Table.GetVisitCount(Key, Action) != 0) return true;
+			}
+			return false;
+		}
+
+		void ReplaceChar(char* Str, const char From, const char To)
+		{
+			for (; *Str; ++Str) *Str = *Str == From ? To : *Str;
+		}
+
+		template <typename ValueType>
+		bool ReadActionObject(FJsonCursor& Cursor, ValueType* Row, const int32_t NumActions)
+		{
+			if (!Cursor.Consume('{')) return false;
+			if (Cursor.Consume('}')) return true;
+
+			do
+			{
+				const char* KeyBegin;
+				const char* KeyEnd;
+				double Value;
+				if (!Cursor.ReadString(KeyBegin, KeyEnd) || !Cursor.Consume(':') || !Cursor.ReadNumber(Value)) return false;
+
+				int32_t Action = 0;
+				for (const char* Char = KeyBegin; Char < KeyEnd && *Char >= '0' && *Char <= '9'; ++Char)
+				{
+					Action = Action * 10 + (*Char - '0');
+				}
+				if (Row && KeyBegin < KeyEnd && Action < NumActions) Row[Action] = static_cast<ValueType>(Value);
+			}
+			while (Cursor.Consume(','));
+
+			return Cursor.Consume('}');
+		}
+
+
+		/* --- Binary --- */
+		constexpr uint32_t TableMagic = 0x42415451; // "QTAB"
+		constexpr uint32_t TableVersion = 1;
+		constexpr uint8_t TableFlagVisitCounts = 1;
+		constexpr uint8_t TableFlagAlignedRows = 2;
+		constexpr uint8_t TableKnownFlags = TableFlagVisitCounts | TableFlagAlignedRows;
+
+		struct FTableHeader
+		{
+			uint32_t Magic;
+			uint32_t Version;
+			uint32_t NumActions;
+			uint8_t ValueType; // EQValueType, AtomicFloat tables are saved as Float
+			uint8_t Flags;
+			uint16_t NumFields;
+			float ValueScale;
+			uint32_t Reserved;
+			uint64_t NumRows;
+			uint64_t Checksum;
+		};
+		static_assert(sizeof(FTableHeader) == 40, "FTableHeader is the on-disk layout");
+
+		struct FTableField
+		{
+			uint32_t NameHash;
+			uint8_t Shift;
+			uint8_t Bits;
+			uint16_t Reserved;
+			int32_t Min;
+			int32_t Max;
+		};
+		static_assert(sizeof(FTableField) == 16, "FTableField is the on-disk layout");
+
+		FTableField MakeTableField(const FQFieldLayout& Field)
+		{
+			uint32_t Hash = 2166136261u; // FNV-1a
+			for (const char* Char = Field.Name; *Char; ++Char) Hash = (Hash ^ static_cast<uint8_t>(*Char)) * 16777619u;
+			return { Hash, static_cast<uint8_t>(Field.Shift), static_cast<uint8_t>(Field.Bits), 0, Field.Min, Field.Max };
+		}
+
+		/* 8 bytes per step, so verifying stays close to copy speed */
+		uint64_t Checksum(const char* Data, const size_t Size)
+		{
+			uint64_t Hash = 14695981039346656037ull;
+			size_t Offset = 0;
+			for (; Offset + 8 <= Size; Offset += 8)
+			{
+				uint64_t Word;
+				std::memcpy(&Word, Data + Offset, sizeof(Word));
+				Hash = (Hash ^ Word) * 1099511628211ull;
+				Hash ^= Hash >> 32;
+			}
+			for (; Offset < Size; ++Offset) Hash = (Hash ^ static_cast<uint8_t>(Data[Offset])) * 1099511628211ull;
+			return Hash;
+		}
+
+		size_t AlignUp(const size_t Offset, const size_t Alignment) { return (Offset + Alignment - 1) / Alignment * Alignment; }
+	}
+
+
+	std::string WriteTableJson(const IQTable& Table, const FQKeyLayout& Layout)
+	{
+		std::string Output;
+		Output.reserve(Table.Num() * (Layout.NumFields * 4 + Table.GetNumActions() * 16) + 4);
+		Output += "{";
+
+		bool bFirstRow = true;
+		char Buffer[64];
+		Table.ForEachRow([&](const FQKey Key, const float* Row)
+		{
+			// Missing rows read as all 0 - rows still at the default aren't worth a line (unless they carry counts)
+			if (IsDefaultRow(Row, Table.GetNumActions()) && !(Table.HasVisitCounts() && HasVisits(Table, Key))) return;
+
+			Output += bFirstRow ? "\n\t\"" : ",\n\t\"";
+			bFirstRow = false;
+
+			WriteKeyString(Key, Layout, Buffer, sizeof(Buffer));
+			Output += Buffer;
+			Output += "\": {";
+
+			for (int32_t Action = 0; Action < Table.GetNumActions(); ++Action)
+			{
+				std::snprintf(Buffer, sizeof(Buffer), "%s\"%d\": %.9g", Action > 0 ? ", " : " ", Action, static_cast<double>(Row[Action]));
+				Output += Buffer;
+			}
+			Output += " }";
+
+			if (!Table.HasVisitCounts()) return;
+			Output += ",\n\t\"";
+			Output += CountsPrefix;
+			WriteKeyString(Key, Layout, Buffer, sizeof(Buffer));
+			ReplaceChar(Buffer, '_', '.');
+			Output += Buffer;
+			Output += "\": {";
+			for (int32_t Action = 0; Action < Table.GetNumActions(); ++Action)
+			{
+				std::snprintf(Buffer, sizeof(Buffer), "%s\"%d\": %u", Action > 0 ? ", " : " ", Action, Table.GetVisitCount(Key, Action));
+				Output += Buffer;
+			}
+			Output += " }";
+		});
+
+		Output += "\n}\n";
+		return Output;
+	}
+
+	bool ReadTableJson(IQTable& Table, const FQKeyLayout& Layout, const char* Data, const size_t Size)
+	{
+		Table.Empty();
+
+		FJsonCursor Cursor{ Data, Data + Size };
+		if (!Cursor.Consume('{')) return false;
+		if (Cursor.Consume('}')) return true;
+
+		do
+		{
+			const char* KeyBegin;
+			const char* KeyEnd;
+			if (!Cursor.ReadString(KeyBegin, KeyEnd) || !Cursor.Consume(':'))
+			{
+				Table.Empty();
+				return false;
+			}
+
+			FQKey Key;
+			if (static_cast<size_t>(KeyEnd - KeyBegin) > CountsPrefixLength && std::strncmp(KeyBegin, CountsPrefix, CountsPrefixLength) == 0)
+			{
+				char KeyString[128];
+				const size_t Length = static_cast<size_t>(KeyEnd - KeyBegin) - CountsPrefixLength;
+				const bool bFits = Length < sizeof(KeyString);
+				if (bFits)
+				{
+					std::memcpy(KeyString, KeyBegin + CountsPrefixLength, Length);
+					KeyString[Length] = '\0';
+					ReplaceChar(KeyString, '.', '_');
+				}
+				const bool bValidKey = bFits && ParseKeyString(KeyString, KeyString + Length, Layout, Key);
+				double Counts[RowWidth] = {};
+				if (!ReadActionObject(Cursor, bValidKey ? Counts : nullptr, Table.GetNumActions()))
+				{
+					Table.Empty();
+					return false;
+				}
+
+				uint32_t RowCounts[RowWidth];
+				for (int32_t Action = 0; Action < RowWidth; ++Action) RowCounts[Action] = Counts[Action] < 4294967295.0 ? (Counts[Action] > 0.0 ? static_cast<uint32_t>(Counts[Action]) : 0) : ~uint32_t(0);
+				if (bValidKey) Table.StoreVisitCounts(Key, RowCounts); // ignored unless the table has counts
+				continue;
+			}
+
+			const bool bValidKey = ParseKeyString(KeyBegin, KeyEnd, Layout, Key);
+			float Row[RowWidth] = {};
+			if (!ReadActionObject(Cursor, bValidKey ? Row : nullptr, Table.GetNumActions()))
+			{
+				Table.Empty();
+				return false;
+			}
+			if (bValidKey && !IsDefaultRow(Row, Table.GetNumActions())) Table.StoreRow(Key, Row); // any value type, quantized for Int16
+		}
+		while (Cursor.Consume(','));
+
+		if (!Cursor.Consume('}'))
+		{
+			Table.Empty();
+			return false;
+		}
+		return true;
+	}
+
+	std::string WriteTableBinary(const IQTable& Table, const FQKeyLayout& Layout, const bool bAlignedRows)
+	{
+		const int32_t NumActions = Table.GetNumActions();
+		const bool bInt16 = Table.GetValueType() == EQValueType::Int16;
+		const bool bCounts = Table.HasVisitCounts();
+		const size_t ValueSize = bInt16 ? sizeof(int16_t) : sizeof(float);
+		const size_t RowBytes = (bAlignedRows ? RowWidth : NumActions) * ValueSize; // aligned rows keep their padding lanes
+		const float InvScale = 1.f / Table.GetValueScale();
+
+		// One pass over the table into the three sections, then one copy each
+		std::vector<FQKey> Keys;
+		std::vector<char> Values;
+		std::vector<uint32_t> Counts;
+		Keys.reserve(Table.Num());
+		Values.reserve(Table.Num() * RowBytes);
+		if (bCounts) Counts.reserve(Table.Num() * NumActions);
+
+		Table.ForEachRow([&](const FQKey Key, const float* Row)
+		{
+			if (IsDefaultRow(Row, NumActions) && !(bCounts && HasVisits(Table, Key))) return;
+
+			Keys.push_back(Key);
+			const size_t Offset = Values.size();
+			Values.resize(Offset + RowBytes);
+			if (bInt16)
+			{
+				int16_t Quantized[RowWidth];
+				for (int32_t Lane = 0; Lane < RowWidth; ++Lane) Quantized[Lane] = Lane < NumActions ? Quantize16(Row[Lane], InvScale) : RowPadding16; // exact, Row was dequantized
+				std::memcpy(&Values[Offset], Quantized, RowBytes);
+			}
+			else
+			{
+				std::memcpy(&Values[Offset], Row, RowBytes);
+			}
+			if (bCounts)
+			{
+				for (int32_t Action = 0; Action < NumActions; ++Action) Counts.push_back(Table.GetVisitCount(Key, Action));
+			}
+		});
+
+		FTableHeader Header = {};
+		Header.Magic = TableMagic;
+		Header.Version = TableVersion;
+		Header.NumActions = static_cast<uint32_t>(NumActions);
+		Header.ValueType = static_cast<uint8_t>(bInt16 ? EQValueType::Int16 : EQValueType::Float);
+		Header.Flags = (bCounts ? TableFlagVisitCounts : 0) | (bAlignedRows ? TableFlagAlignedRows : 0);
+		Header.NumFields = static_cast<uint16_t>(Layout.NumFields);
+		Header.ValueScale = bInt16 ? Table.GetValueScale() : 1.f;
+		Header.NumRows = Keys.size();
+
+		const size_t KeysOffset = sizeof(FTableHeader) + Layout.NumFields * sizeof(FTableField);
+		const size_t ValuesOffset = AlignUp(KeysOffset + Keys.size() * sizeof(FQKey), bAlignedRows ? RowAlignment : 1);
+		const size_t CountsOffset = AlignUp(ValuesOffset + Values.size(), sizeof(uint32_t));
+		std::string Output(bCounts ? CountsOffset + Counts.size() * sizeof(uint32_t) : ValuesOffset + Values.size(), '\0');
+
+		for (size_t Field = 0; Field < Layout.NumFields; ++Field)
+		{
+			const FTableField Entry = MakeTableField(Layout.Fields[Field]);
+			std::memcpy(&Output[sizeof(FTableHeader) + Field * sizeof(FTableField)], &Entry, sizeof(Entry));
+		}
+		if (!Keys.empty()) std::memcpy(&Output[KeysOffset], Keys.data(), Keys.size() * sizeof(FQKey));
+		if (!Values.empty()) std::memcpy(&Output[ValuesOffset], Values.data(), Values.size());
+		if (!Counts.empty()) std::memcpy(&Output[CountsOffset], Counts.data(), Counts.size() * sizeof(uint32_t));
+
+		Header.Checksum = Checksum(Output.data() + sizeof(FTableHeader), Output.size() - sizeof(FTableHeader));
+		std::memcpy(&Output[0], &Header, sizeof(Header));
+		return Output;
+	}
+
+	bool IsTableBinary(const char* Data, const size_t Size)
+	{
+		uint32_t Magic;
+		if (Size < sizeof(Magic)) return false;
+		std::memcpy(&Magic, Data, sizeof(Magic));
+		return Magic == TableMagic;
+	}
+
+	bool ParseTableBinary(const char* Data, const size_t Size, const FQKeyLayout& Layout, FQTableFileInfo& OutInfo)
+	{
+		FTableHeader Header;
+		if (Size < sizeof(Header)) return false;
+		std::memcpy(&Header, Data, sizeof(Header));
+		if (Header.Magic != TableMagic || Header.Version != TableVersion || (Header.Flags & ~TableKnownFlags) != 0) return false;
+		if (Header.NumActions < 1 || Header.NumActions > static_cast<uint32_t>(RowWidth) || Header.NumFields != Layout.NumFields) return false;
+		if (Header.ValueType != static_cast<uint8_t>(EQValueType::Float) && Header.ValueType != static_cast<uint8_t>(EQValueType::Int16)) return false;
+
+		FQTableFileInfo Info;
+		Info.NumActions = static_cast<int32_t>(Header.NumActions);
+		Info.ValueType = static_cast<EQValueType>(Header.ValueType);
+		Info.ValueScale = Header.ValueScale;
+		Info.bVisitCounts = (Header.Flags & TableFlagVisitCounts) != 0;
+		Info.bAlignedRows = (Header.Flags & TableFlagAlignedRows) != 0;
+		Info.RowStride = Info.bAlignedRows ? RowWidth : Info.NumActions;
+
+		const size_t ValueSize = Info.ValueType == EQValueType::Int16 ? sizeof(int16_t) : sizeof(float);
+		Info.KeysOffset = sizeof(FTableHeader) + Layout.NumFields * sizeof(FTableField);
+		if (Size < Info.KeysOffset || Header.NumRows > (Size - Info.KeysOffset) / sizeof(FQKey)) return false; // also keeps the offsets below from overflowing
+		Info.NumRows = static_cast<size_t>(Header.NumRows);
+		Info.ValuesOffset = AlignUp(Info.KeysOffset + Info.NumRows * sizeof(FQKey), Info.bAlignedRows ? RowAlignment : 1);
+		Info.CountsOffset = AlignUp(Info.ValuesOffset + Info.NumRows * Info.RowStride * ValueSize, sizeof(uint32_t));
+		const size_t ExpectedSize = Info.bVisitCounts ? Info.CountsOffset + Info.NumRows * Info.NumActions * sizeof(uint32_t)
+			: Info.ValuesOffset + Info.NumRows * Info.RowStride * ValueSize;
+		if (Size != ExpectedSize) return false;
+		if (Checksum(Data + sizeof(FTableHeader), Size - sizeof(FTableHeader)) != Header.Checksum) return false;
+
+		for (size_t Field = 0; Field < Layout.NumFields; ++Field)
+		{
+			const FTableField Expected = MakeTableField(Layout.Fields[Field]);
+			if (std::memcmp(Data + sizeof(FTableHeader) + Field * sizeof(FTableField), &Expected, sizeof(Expected)) != 0) return false; // keys pack differently
+		}
+
+		OutInfo = Info;
+		return true;
+	}
+
+	bool ReadTableBinary(IQTable& Table, const FQKeyLayout& Layout, const char* Data, const size_t Size)
+	{
+		Table.Empty();
+
+		FQTableFileInfo Info;
+		if (!ParseTableBinary(Data, Size, Layout, Info) || Info.NumActions != Table.GetNumActions()) return false;
+
+		const int32_t NumActions = Table.GetNumActions();
+		const bool bInt16 = Info.ValueType == EQValueType::Int16;
+		const bool bRawInt16 = bInt16 && Table.GetValueType() == EQValueType::Int16 && Table.GetValueScale() == Info.ValueScale;
+		const bool bRawFloat = !bInt16 && Table.GetValueType() == EQValueType::Float;
+		const size_t ValueSize = bInt16 ? sizeof(int16_t) : sizeof(float);
+		const size_t RowBytes = NumActions * ValueSize;
+		for (size_t Index = 0; Index < Info.NumRows; ++Index)
+		{
+			FQKey Key;
+			std::memcpy(&Key, Data + Info.KeysOffset + Index * sizeof(FQKey), sizeof(Key));
+			const char* Values = Data + Info.ValuesOffset + Index * Info.RowStride * ValueSize;
+
+			if (bRawFloat) std::memcpy(Table.FindOrAddRow(Key).GetData(), Values, RowBytes);
+			else if (bRawInt16) std::memcpy(Table.FindOrAddRowAs<int16_t>(Key).GetData(), Values, RowBytes);
+			else
+			{
+				float Row[RowWidth];
+				if (bInt16)
+				{
+					int16_t Quantized[RowWidth];
+					std::memcpy(Quantized, Values, RowBytes);
+					for (int32_t Action = 0; Action < NumActions; ++Action) Row[Action] = Dequantize16(Quantized[Action], Info.ValueScale);
+				}
+				else
+				{
+					std::memcpy(Row, Values, RowBytes);
+				}
+				Table.StoreRow(Key, Row);
+			}
+
+			if (Info.bVisitCounts && Table.HasVisitCounts())
+			{
+				uint32_t RowCounts[RowWidth];
+				std::memcpy(RowCounts, Data + Info.CountsOffset + Index * NumActions * sizeof(uint32_t), NumActions * sizeof(uint32_t));
+				Table.StoreVisitCounts(Key, RowCounts);
+			}
+		}
+		return true;
+	}
+
+	bool ReadTable(IQTable& Table, const FQKeyLayout& Layout, const char* Data, const size_t Size)
+	{
+		return IsTableBinary(Data, Size) ? ReadTableBinary(Table, Layout, Data, Size) : ReadTableJson(Table, Layout, Data, Size);
+	}
+
+	bool SaveTableJsonFile(const IQTable& Table, const FQKeyLayout& Layout, const std::string& Path)
+	{
+		std::ofstream File(Path, std::ios::binary | std::ios::trunc);
+		if (!File) return false;
+
+		const std::string Json = WriteTableJson(Table, Layout);
+		File.write(Json.data(), static_cast<std::streamsize>(Json.size()));
+		return static_cast<bool>(File);
+	}
+
+	bool LoadTableJsonFile(IQTable& Table, const FQKeyLayout& Layout, const std::string& Path)
+	{
+		std::ifstream File(Path, std::ios::binary);
+		if (!File) return false;
+
+		const std::string Contents((std::istreambuf_iterator<char>(File)), std::istreambuf_iterator<char>());
+		return ReadTableJson(Table, Layout, Contents.data(), Contents.size());
+	}
+
+	bool SaveTableBinaryFile(const IQTable& Table, const FQKeyLayout& Layout, const std::string& Path, const bool bAlignedRows)
+	{
+		std::ofstream File(Path, std::ios::binary | std::ios::trunc);
+		if (!File) return false;
+
+		const std::string Bytes = WriteTableBinary(Table, Layout, bAlignedRows);
+		File.write(Bytes.data(), static_cast<std::streamsize>(Bytes.size()));
+		return static_cast<bool>(File);
+	}
+
+	bool LoadTableFile(IQTable& Table, const FQKeyLayout& Layout, const std::string& Path)
+	{
+		std::ifstream File(Path, std::ios::binary);
+		if (!File) return false;
+
+		const std::string Contents((std::istreambuf_iterator<char>(File)), std::istreambuf_iterator<char>());
+		return ReadTable(Table, Layout, Contents.data(), Contents.size());
+	}
+}
@@ -0,0 +1,164 @@
+#include "QCore/QPolicyTable.h"
+#include "QCore/QTable.h"
+#include <cstdio>
+#include <cstring>
+
+
+namespace QCore
+{
+	namespace
+	{
+		constexpr uint32_t PolicyMagic = 0x4C4F5051; // "QPOL"
+		constexpr uint32_t PolicyVersion = 1;
+		constexpr size_t PolicyHeaderSize = 4 + 4 + 4 + 4 + 8;
+
+		void AppendLittleEndian(std::string& Out, const uint64_t Value, const int32_t NumBytes)
+		{
+			for (int32_t Byte = 0; Byte < NumBytes; ++Byte) Out.push_back(static_cast<char>(Value >> (Byte * 8)));
+		}
+
+		uint64_t ReadLittleEndian(const char* Data, const int32_t NumBytes)
+		{
+			uint64_t Value = 0;
+			for (int32_t Byte = 0; Byte < NumBytes; ++Byte) Value |= static_cast<uint64_t>(static_cast<uint8_t>(Data[Byte])) << (Byte * 8);
+			return Value;
+		}
+
+		template <typename... ArgTypes>
+		void AppendFormat(std::string& Out, const char* Format, const ArgTypes... Args)
+		{
+			char Buffer[256];
+			const int Length = std::snprintf(Buffer, sizeof(Buffer), Format, Args...);
+			if (Length > 0) Out.append(Buffer, static_cast<size_t>(Length) < sizeof(Buffer) ? static_cast<size_t>(Length) : sizeof(Buffer) - 1);
+		}
+
+		/* Comma separated, PerLine values to a line, indented two tabs */
+		template <typename ValueType>
+		void AppendArray(std::string& Out, const ValueType* Values, const size_t Num, const size_t PerLine)
+		{
+			for (size_t Index = 0; Index < Num; ++Index)
+			{
+				if (Index % PerLine == 0) Out += "\t\t";
+				AppendFormat(Out, "%u,", static_cast<uint32_t>(Values[Index]));
+				Out += (Index + 1) % PerLine == 0 || Index + 1 == Num ? "\n" : " ";
+			}
+		}
+
+		bool IsArithmetic(const FQPolicyTable::FField& Field) // buckets are the raw values, index = value * Stride
+		{
+			for (size_t Offset = 0; Offset < Field.Strides.size(); ++Offset)
+			{
+				if (Field.Strides[Offset] != Offset * Field.Stride) return false;
+			}
+			return true;
+		}
+	}
+
+
+	FQPolicyTable::FQPolicyTable(const FQDiscretizer& Discretizer)
+		: StateIndex(Discretizer)
+	{
+		Actions.assign(static_cast<size_t>(StateIndex.GetNumStates()), 0);
+	}
+
+	void FQPolicyTable::Build(const IQTable& Table)
+	{
+		if (!IsValid()) return;
+
+		NumActions = Table.GetNumActions();
+		float Row[RowWidth];
+		for (uint32_t Index = 0; Index < Actions.size(); ++Index)
+		{
+			int32_t Best = 0;
+			if (Table.LoadRow(GetStateKey(Index), Row))
+			{
+				for (int32_t Action = 1; Action < NumActions; ++Action) Best = Row[Action] > Row[Best] ? Action : Best;
+			}
+			Actions[Index] = static_cast<uint8_t>(Best);
+		}
+	}
+
+	std::string WritePolicyBinary(const FQPolicyTable& Policy)
+	{
+		std::string Out;
+		Out.reserve(PolicyHeaderSize + Policy.GetNumStates());
+		AppendLittleEndian(Out, PolicyMagic, 4);
+		AppendLittleEndian(Out, PolicyVersion, 4);
+		AppendLittleEndian(Out, static_cast<uint32_t>(Policy.GetNumActions()), 4);
+		AppendLittleEndian(Out, Policy.GetNumStates(), 4);
+		AppendLittleEndian(Out, Policy.GetSignature(), 8);
+		Out.append(reinterpret_cast<const char*>(Policy.GetActions()), Policy.GetNumStates());
+		return Out;
+	}
+
+	bool ReadPolicyBinary(FQPolicyTable& Policy, const char* Data, const size_t Size)
+	{
+		if (!Policy.IsValid() || Size < PolicyHeaderSize) return false;
+		if (ReadLittleEndian(Data, 4) != PolicyMagic || ReadLittleEndian(Data + 4, 4) != PolicyVersion) return false;
+
+		const uint64_t NumActions = ReadLittleEndian(Data + 8, 4);
+		const uint64_t NumStates = ReadLittleEndian(Data + 12, 4);
+		if (NumActions == 0 || NumActions > RowWidth) return false;
+		if (NumStates != Policy.GetNumStates() || ReadLittleEndian(Data + 16, 8) != Policy.GetSignature()) return false; // other layout or buckets
+		if (Size != PolicyHeaderSize + NumStates) return false;
+
+		const uint8_t* Actions = reinterpret_cast<const uint8_t*>(Data + PolicyHeaderSize);
+		for (size_t Index = 0; Index < NumStates; ++Index)
+		{
+			if (Actions[Index] >= NumActions) return false;
+		}
+		std::memcpy(Policy.Actions.data(), Actions, NumStates);
+		Policy.NumActions = static_cast<int32_t>(NumActions);
+		return true;
+	}
+
+	std::string WritePolicyHeader(const FQPolicyTable& Policy, const FQKeyLayout& Layout, const char* Name, const char* Source)
+	{
+		const std::vector<FQPolicyTable::FField>& Fields = Policy.GetFields();
+		std::string Out;
+		Out.reserve(1024 + Policy.GetNumStates() * 4);
+
+		AppendFormat(Out, "// Generated by QPolicyGen from %s - do not edit\n", Source);
+		AppendFormat(Out, "// %zu states, %d actions\n#pragma once\n\n#include <cstdint>\n\n\n", Policy.GetNumStates(), Policy.GetNumActions());
+		AppendFormat(Out, "namespace %s\n{\n", Name);
+		AppendFormat(Out, "\tinline constexpr uint64_t Signature = 0x%016llXull; // QCore::FQPolicyTable::GetSignature() of the layout and buckets\n",
+			static_cast<unsigned long long>(Policy.GetSignature()));
+		AppendFormat(Out, "\tinline constexpr int32_t NumActions = %d;\n", Policy.GetNumActions());
+		AppendFormat(Out, "\tinline constexpr uint32_t NumStates = %zu;\n\n", Policy.GetNumStates());
+
+		for (size_t FieldIndex = 0; FieldIndex < Fields.size(); ++FieldIndex)
+		{
+			const FQPolicyTable::FField& Field = Fields[FieldIndex];
+			if (IsArithmetic(Field)) continue;
+			const char* FieldName = FieldIndex < Layout.NumFields ? Layout.Fields[FieldIndex].Name : "Field";
+			AppendFormat(Out, "\t// %s: %u buckets, raw value - min -> bucket * %u\n", FieldName, Field.Radix, Field.Stride);
+			AppendFormat(Out, "\tinline constexpr uint32_t %sIndex[%zu] =\n\t{\n", FieldName, Field.Strides.size());
+			AppendArray(Out, Field.Strides.data(), Field.Strides.size(), 16);
+			Out += "\t};\n\n";
+		}
+
+		Out += "\tinline constexpr uint8_t Actions[NumStates] =\n\t{\n";
+		AppendArray(Out, Policy.GetActions(), Policy.GetNumStates(), 32);
+		Out += "\t};\n\n";
+
+		Out += "\t/* Packed state key (raw or bucketed) -> index into Actions */\n";
+		Out += "\tconstexpr uint32_t StateIndex(const uint64_t Key)\n\t{\n\t\treturn 0";
+		for (size_t FieldIndex = 0; FieldIndex < Fields.size(); ++FieldIndex)
+		{
+			const FQPolicyTable::FField& Field = Fields[FieldIndex];
+			const char* FieldName = FieldIndex < Layout.NumFields ? Layout.Fields[FieldIndex].Name : "Field";
+			Out += "\n\t\t\t+ ";
+			if (!IsArithmetic(Field))
+			{
+				AppendFormat(Out, "%sIndex[(Key >> %u) & 0x%llX]", FieldName, Field.Shift, static_cast<unsigned long long>(Field.Mask));
+			}
+			else
+			{
+				AppendFormat(Out, "static_cast<uint32_t>((Key >> %u) & 0x%llX) * %u /* %s */", Field.Shift, static_cast<unsigned long long>(Field.Mask), Field.Stride, FieldName);
+			}
+		}
+		Out += ";\n\t}\n\n";
+		Out += "\tconstexpr int32_t Choose(const uint64_t Key) { return Actions[StateIndex(Key)]; }\n}\n";
+		return Out;
+	}
+}
@@ -0,0 +1,178 @@
+#include "QCore/QPrioritizedSweeper.h"
+#include <chrono>
+#include <cmath>
+
+
+namespace QCore
+{
+	FQPrioritizedSweeper::FQPrioritizedSweeper(const size_t InCapacity, const size_t ModelCapacity)
+		: Model(ModelCapacity > 0 ? ModelCapacity : 1)
+		, Capacity(InCapacity > 0 ? InCapacity : 1)
+	{
+		Heap.reserve(Capacity);
+		Positions.reserve(Capacity);
+	}
+
+	void FQPrioritizedSweeper::Observe(const FQLearner& Learner, const FQTransition& Transition)
+	{
+		FQDynaModel::FDroppedLinks Dropped;
+		Model.Observe(Transition, &Dropped);
+		for (int32_t Index = 0; Index < Dropped.NumStates; ++Index) RemovePredecessor(Dropped.States[Index], Dropped.Pair);
+
+		std::vector<FQStateAction>& Leading = Predecessors[Transition.NewState];
+		const FQStateAction Pair{ Transition.PrevState, Transition.ActionTaken };
+		bool bKnown = false;
+		for (const FQStateAction& Predecessor : Leading) bKnown |= Predecessor == Pair;
+		if (!bKnown) Leading.push_back(Pair);
+
+		const FQDynaModel::FEntry& Entry = *Model.Find(Pair);
+		Push(Pair, std::fabs(GetModelTarget(Learner, Entry) - Learner.GetQValue(Pair.State, Pair.Action)));
+		QueuePredecessors(Learner, Transition.PrevState); // the real update just changed Q(PrevState)
+	}
+
+	int32_t FQPrioritizedSweeper::Sweep(FQLearner& Learner, const int32_t MaxUpdates, const float BudgetMicros)
+	{
+		if (Heap.empty()) return 0;
+
+		using FClock = std::chrono::steady_clock;
+		const FClock::time_point Deadline = FClock::now() + std::chrono::duration_cast<FClock::duration>(std::chrono::duration<float, std::micro>(BudgetMicros));
+
+		int32_t NumUpdates = 0;
+		while (NumUpdates < MaxUpdates && !Heap.empty())
+		{
+			const FQStateAction Pair = Heap[0].Pair;
+			Positions.erase(Pair);
+			const FQueued Last = Heap.back();
+			Heap.pop_back();
+			if (!Heap.empty())
+			{
+				Place(0, Last);
+				SiftDown(0);
+			}
+
+			if (const FQDynaModel::FEntry* Entry = Model.Find(Pair))
+			{
+				const float Target = GetModelTarget(Learner, *Entry);
+				Learner.UpdateQValueToTarget(Pair.State, Pair.Action, Target);
+				Push(Pair, std::fabs(Target - Learner.GetQValue(Pair.State, Pair.Action))); // alpha < 1 leaves part of the error
+				QueuePredecessors(Learner, Pair.State);
+			}
+			++NumUpdates;
+
+			if (BudgetMicros > 0.f && FClock::now() >= Deadline) break;
+		}
+		return NumUpdates;
+	}
+
+	void FQPrioritizedSweeper::Empty()
+	{
+		Model.Empty();
+		Predecessors.clear();
+		Heap.clear();
+		Positions.clear();
+	}
+
+	float FQPrioritizedSweeper::GetModelTarget(const FQLearner& Learner, const FQDynaModel::FEntry& Entry) const
+	{
+		uint32_t Total = 0;
+		float Expected = 0.f;
+		for (int32_t Index = 0; Index < Entry.NumSuccessors; ++Index)
+		{
+			Total += Entry.Successors[Index].Count;
+			Expected += static_cast<float>(Entry.Successors[Index].Count) * Learner.GetMaxQValue(Entry.Successors[Index].State);
+		}
+		return Entry.MeanReward + Learner.Config.DiscountFactor * (Total ? Expected / static_cast<float>(Total) : 0.f);
+	}
+
+	void FQPrioritizedSweeper::QueuePredecessors(const FQLearner& Learner, const FQKey State)
+	{
+		const auto It = Predecessors.find(State);
+		if (It == Predecessors.end()) return;
+
+		for (const FQStateAction& Predecessor : It->second)
+		{
+			if (const FQDynaModel::FEntry* Entry = Model.Find(Predecessor))
+			{
+				Push(Predecessor, std::fabs(GetModelTarget(Learner, *Entry) - Learner.GetQValue(Predecessor.State, Predecessor.Action)));
+			}
+		}
+	}
+
+	void FQPrioritizedSweeper::RemovePredecessor(const FQKey State, const FQStateAction& Pair)
+	{
+		const auto It = Predecessors.find(State);
+		if (It == Predecessors.end()) return;
+
+		std::vector<FQStateAction>& Leading = It->second;
+		for (size_t Index = 0; Index < Leading.size(); ++Index)
+		{
+			if (!(Leading[Index] == Pair)) continue;
+			Leading[Index] = Leading.back();
+			Leading.pop_back();
+			break;
+		}
+		if (Leading.empty()) Predecessors.erase(It);
+	}
+
+	void FQPrioritizedSweeper::Push(const FQStateAction& Pair, const float Priority)
+	{
+		if (!(Priority >= PriorityThreshold)) return;
+
+		const auto It = Positions.find(Pair);
+		if (It != Positions.end())
+		{
+			if (Priority > Heap[It->second].Priority)
+			{
+				Heap[It->second].Priority = Priority;
+				SiftUp(It->second);
+			}
+			return;
+		}
+		if (Heap.size() >= Capacity)
+		{
+			size_t Smallest = Heap.size() / 2; // a max-heap's minimum is one of its leaves
+			for (size_t Index = Smallest + 1; Index < Heap.size(); ++Index)
+			{
+				if (Heap[Index].Priority < Heap[Smallest].Priority) Smallest = Index;
+			}
+			if (!(Priority > Heap[Smallest].Priority)) return;
+
+			Positions.erase(Heap[Smallest].Pair);
+			Place(Smallest, { Priority, Pair });
+			SiftUp(Smallest); // larger than the leaf it replaced, only moves up
+			return;
+		}
+
+		Heap.push_back({ Priority, Pair });
+		Positions[Pair] = static_cast<uint32_t>(Heap.size() - 1);
+		SiftUp(Heap.size() - 1);
+	}
+
+	void FQPrioritizedSweeper::SiftUp(size_t Index)
+	{
+		const FQueued Entry = Heap[Index];
+		while (Index > 0)
+		{
+			const size_t Parent = (Index - 1) / 2;
+			if (Heap[Parent].Priority >= Entry.Priority) break;
+			Place(Index, Heap[Parent]);
+			Index = Parent;
+		}
+		Place(Index, Entry);
+	}
+
+	void FQPrioritizedSweeper::SiftDown(size_t Index)
+	{
+		const FQueued Entry = Heap[Index];
+		for (;;)
+		{
+			size_t Child = Index * 2 + 1;
+			if (Child >= Heap.size()) break;
+			if (Child + 1 < Heap.size() && Heap[Child + 1].Priority > Heap[Child].Priority) ++Child;
+			if (Heap[Child].Priority <= Entry.Priority) break;
+			Place(Index, Heap[Child]);
+			Index = Child;
+		}
+		Place(Index, Entry);
+	}
+}
@@ -0,0 +1,56 @@
+#include "QCore/QReplayBuffer.h"
+#include <chrono>
+
+
+namespace QCore
+{
+	FQReplayBuffer::FQReplayBuffer(const size_t InCapacity)
+		: Capacity(0)
+	{
+		SetCapacity(InCapacity);
+	}
+
+	void FQReplayBuffer::SetCapacity(const size_t InCapacity)
+	{
+		Capacity = InCapacity > 0 ? InCapacity : 1;
+		Transitions.clear();
+		Transitions.shrink_to_fit();
+		Transitions.reserve(Capacity);
+		Next = 0;
+	}
+
+	void FQReplayBuffer::Add(const FQTransition& Transition)
+	{
+		if (Transitions.size() < Capacity)
+		{
+			Transitions.push_back(Transition);
+			return;
+		}
+		Transitions[Next] = Transition;
+		Next = Next + 1 < Capacity ? Next + 1 : 0;
+	}
+
+	const FQTransition& FQReplayBuffer::Sample()
+	{
+		return Transitions[Rng.NextBounded(static_cast<uint32_t>(Transitions.size()))];
+	}
+
+	int32_t FQReplayBuffer::Replay(FQLearner& Learner, const int32_t MaxUpdates, const float BudgetMicros)
+	{
+		if (Transitions.empty()) return 0;
+
+		using FClock = std::chrono::steady_clock;
+		const FClock::time_point Deadline = FClock::now() + std::chrono::duration_cast<FClock::duration>(std::chrono::duration<float, std::micro>(BudgetMicros));
+
+		int32_t NumUpdates = 0;
+		while (NumUpdates < MaxUpdates)
+		{
+			const FQTransition& Transition = Sample();
+			Learner.ReplayQValue(Transition.PrevState, Transition.ActionTaken, Transition.Reward, Transition.NewState);
+			++NumUpdates;
+
+			if (BudgetMicros > 0.f && FClock::now() >= Deadline) break;
+		}
+		return NumUpdates;
+	}
+}
@@ -0,0 +1,114 @@
+#include "QCore/QShardedTable.h"
+
+
+namespace QCore
+{
+	FQShardedTable::FQShardedTable(const int32_t InNumActions, const int32_t InNumShards)
+		: IQTable(InNumActions, EQValueType::AtomicFloat)
+		, NumShards(1)
+	{
+		while (NumShards < InNumShards) NumShards <<= 1;
+		Shards = std::make_unique<FShard[]>(static_cast<size_t>(NumShards));
+		for (int32_t Index = 0; Index < NumShards; ++Index) ResetShard(Shards[Index]);
+	}
+
+	size_t FQShardedTable::FindSlot(const FShard& Shard, const FQKey Key)
+	{
+		// Fibonacci hashing for the slot - independent of the HashKey bits that picked the shard
+		const size_t Mask = Shard.Slots.size() - 1;
+		size_t Index = static_cast<size_t>((Key * 0x9E3779B97F4A7C15ull) >> 32) & Mask;
+		while (Shard.Slots[Index].Row != EmptySlot && Shard.Slots[Index].Key != Key) Index = (Index + 1) & Mask;
+		return Index;
+	}
+
+	void* FQShardedTable::FindOrAddRowData(const FQKey Key)
+	{
+		FShard& Shard = GetShard(Key);
+		const std::lock_guard<std::mutex> Lock(Shard.Mutex);
+
+		size_t Index = FindSlot(Shard, Key);
+		if (Shard.Slots[Index].Row != EmptySlot) return GetRow(Shard, Shard.Slots[Index].Row);
+
+		if ((static_cast<size_t>(Shard.NumRows) + 1) * 2 > Shard.Slots.size())
+		{
+			Grow(Shard);
+			Index = FindSlot(Shard, Key);
+		}
+
+		const uint32_t Row = Shard.NumRows++;
+		if (Row % RowsPerChunk == 0) Shard.Chunks.emplace_back(static_cast<size_t>(RowsPerChunk) * RowWidth);
+		std::atomic<float>* Cells = GetRow(Shard, Row);
+		for (int32_t Lane = 0; Lane < RowWidth; ++Lane) Cells[Lane].store(Lane < NumActions ? 0.f : RowPadding, std::memory_order_relaxed);
+
+		Shard.Slots[Index] = { Key, Row }; // other threads see the row only after taking this shard's lock
+		NumRows.fetch_add(1, std::memory_order_relaxed);
+		return Cells;
+	}
+
+	const void* FQShardedTable::FindRowData(const FQKey Key) const
+	{
+		const FShard& Shard = GetShard(Key);
+		const std::lock_guard<std::mutex> Lock(Shard.Mutex);
+
+		const FSlot& Slot = Shard.Slots[FindSlot(Shard, Key)];
+		return Slot.Row != EmptySlot ? GetRow(Shard, Slot.Row) : nullptr;
+	}
+
+	void FQShardedTable::Grow(FShard& Shard)
+	{
+		std::vector<FSlot> Old(Shard.Slots.size() * 2, FSlot{ 0, EmptySlot });
+		Old.swap(Shard.Slots);
+		for (const FSlot& Slot : Old)
+		{
+			if (Slot.Row != EmptySlot) Shard.Slots[FindSlot(Shard, Slot.Key)] = Slot;
+		}
+	}
+
+	void FQShardedTable::ResetShard(FShard& Shard) const
+	{
+		Shard.Slots.assign(InitialSlots, FSlot{ 0, EmptySlot });
+		Shard.Slots.shrink_to_fit();
+		Shard.Chunks.clear();
+		Shard.Chunks.shrink_to_fit();
+		Shard.NumRows = 0;
+	}
+
+	void FQShardedTable::Empty()
+	{
+		for (int32_t Index = 0; Index < NumShards; ++Index)
+		{
+			const std::lock_guard<std::mutex> Lock(Shards[Index].Mutex);
+			ResetShard(Shards[Index]);
+		}
+		NumRows.store(0, std::memory_order_relaxed);
+	}
+
+	size_t FQShardedTable::GetAllocatedSize() const
+	{
+		size_t Size = static_cast<size_t>(NumShards) * sizeof(FShard);
+		for (int32_t Index = 0; Index < NumShards; ++Index)
+		{
+			const FShard& Shard = Shards[Index];
+			const std::lock_guard<std::mutex> Lock(Shard.Mutex);
+			Size += Shard.Slots.capacity() * sizeof(FSlot) + Shard.Chunks.capacity() * sizeof(TQRowArray<std::atomic<float>>);
+			Size += Shard.Chunks.size() * RowsPerChunk * RowWidth * sizeof(std::atomic<float>);
+		}
+		return Size;
+	}
+
+	void FQShardedTable::ForEachRow(const std::function<void(FQKey, const float*)>& Func) const
+	{
+		alignas(RowAlignment) float Row[RowWidth];
+		for (int32_t Index = 0; Index < NumShards; ++Index)
+		{
+			const FShard& Shard = Shards[Index];
+			const std::lock_guard<std::mutex> Lock(Shard.Mutex);
+			for (const FSlot& Slot : Shard.Slots)
+			{
+				if (Slot.Row == EmptySlot) continue;
+				LoadAtomicRow(GetRow(Shard, Slot.Row), Row);
+				Func(Slot.Key, Row);
+			}
+		}
+	}
+}
@@ -0,0 +1,145 @@
+#include "QCore/QSnapshot.h"
+#include "QCore/QRowKernels.h"
+
+
+namespace QCore
+{
+	size_t FQTableSnapshot::FindSlot(const FQKey Key) const
+	{
+		const size_t Mask = Slots.size() - 1;
+		size_t Index = static_cast<size_t>((Key * 0x9E3779B97F4A7C15ull) >> 32) & Mask;
+		while (Slots[Index].Row != EmptySlot && Slots[Index].Key != Key) Index = (Index + 1) & Mask;
+		return Index;
+	}
+
+	void FQTableSnapshot::Build(const IQTable& Source, const uint64_t InVersion)
+	{
+		NumActions = Source.GetNumActions();
+		Version = InVersion;
+		NumRows = 0;
+
+		size_t NumSlots = 16;
+		while (NumSlots < Source.Num() * 2) NumSlots <<= 1;
+		Slots.assign(NumSlots, FSlot{ 0, EmptySlot });
+		Rows.resize(Source.Num() * RowWidth);
+
+		Source.ForEachRow([this](const FQKey Key, const float* Row)
+		{
+			if (NumRows * RowWidth == Rows.size()) Rows.resize(Rows.size() + RowWidth); // Num() raced a concurrent learner
+			if ((NumRows + 1) * 2 > Slots.size()) return; // index full - row added after the Num() above, skip it
+
+			const uint32_t RowIndex = static_cast<uint32_t>(NumRows++);
+			for (int32_t Lane = 0; Lane < RowWidth; ++Lane) Rows[RowIndex * RowWidth + Lane] = Row[Lane];
+			Slots[FindSlot(Key)] = { Key, RowIndex };
+		});
+	}
+
+	FQConstRow FQTableSnapshot::FindRow(const FQKey Key) const
+	{
+		if (Slots.empty()) return {};
+		const FSlot& Slot = Slots[FindSlot(Key)];
+		return Slot.Row != EmptySlot ? FQConstRow(&Rows[Slot.Row * RowWidth], NumActions) : FQConstRow();
+	}
+
+	int32_t FQTableSnapshot::ChooseGreedyAction(const FQKey Key) const
+	{
+		const FQConstRow Row = FindRow(Key);
+		return Row ? ArgMaxRow(Row.GetData()) : 0;
+	}
+
+	void FQTableSnapshot::ForEachRow(const std::function<void(FQKey, const float*)>& Func) const
+	{
+		for (const FSlot& Slot : Slots)
+		{
+			if (Slot.Row != EmptySlot) Func(Slot.Key, &Rows[Slot.Row * RowWidth]);
+		}
+	}
+
+
+	FQSnapshotPublisher::FQSnapshotPublisher()
+	{
+		for (std::atomic<uint64_t>& Epoch : ReaderEpochs) Epoch.store(FreeSlot, std::memory_order_relaxed);
+	}
+
+	FQSnapshotPublisher::~FQSnapshotPublisher()
+	{
+		delete Current.load(std::memory_order_relaxed);
+	}
+
+	void FQSnapshotPublisher::Publish(const IQTable& Source)
+	{
+		Reclaim();
+
+		std::unique_ptr<FQTableSnapshot> Snapshot;
+		if (!Reusable.empty())
+		{
+			Snapshot = std::move(Reusable.back());
+			Reusable.pop_back();
+		}
+		else
+		{
+			Snapshot = std::make_unique<FQTableSnapshot>();
+		}
+		Snapshot->Build(Source, ++NumPublished);
+
+		// Readers that pinned up to the current epoch may hold the old pointer
+		FQTableSnapshot* Old = Current.exchange(Snapshot.release(), std::memory_order_seq_cst);
+		const uint64_t Epoch = GlobalEpoch.fetch_add(1, std::memory_order_seq_cst);
+		if (Old) Retired.push_back({ std::unique_ptr<FQTableSnapshot>(Old), Epoch });
+	}
+
+	size_t FQSnapshotPublisher::Reclaim()
+	{
+		uint64_t OldestPinned = FreeSlot;
+		for (const std::atomic<uint64_t>& Epoch : ReaderEpochs)
+		{
+			const uint64_t Pinned = Epoch.load(std::memory_order_seq_cst);
+			if (Pinned != IdleSlot && Pinned < OldestPinned) OldestPinned = Pinned; // FreeSlot never lowers it
+		}
+
+		size_t NumReclaimed = 0;
+		for (size_t Index = 0; Index < Retired.size(); )
+		{
+			if (Retired[Index].Epoch < OldestPinned)
+			{
+				Reusable.push_back(std::move(Retired[Index].Snapshot));
+				Retired[Index] = std::move(Retired.back());
+				Retired.pop_back();
+				++NumReclaimed;
+				continue;
+			}
+			++Index;
+		}
+		return NumReclaimed;
+	}
+
+
+	FQSnapshotReader::FQSnapshotReader(FQSnapshotPublisher& InPublisher)
+		: Publisher(InPublisher)
+	{
+		for (int32_t Index = 0; Index < MaxSnapshotReaders; ++Index)
+		{
+			uint64_t Expected = FQSnapshotPublisher::FreeSlot;
+			if (Publisher.ReaderEpochs[Index].compare_exchange_strong(Expected, FQSnapshotPublisher::IdleSlot))
+			{
+				Slot = Index;
+				return;
+			}
+		}
+	}
+
+	FQSnapshotReader::~FQSnapshotReader()
+	{
+		if (IsValid()) Publisher.ReaderEpochs[Slot].store(FQSnapshotPublisher::FreeSlot, std::memory_order_release);
+	}
+
+	FQSnapshotReader::FPin FQSnapshotReader::Pin()
+	{
+		if (!IsValid()) return FPin(nullptr, nullptr);
+
+		// Announce the epoch before reading the pointer: a Publish that misses the announcement swapped first
+		std::atomic<uint64_t>& Epoch = Publisher.ReaderEpochs[Slot];
+		Epoch.store(Publisher.GlobalEpoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+		return FPin(&Epoch, Publisher.Current.load(std::memory_order_seq_cst));
+	}
+}
@@ -0,0 +1,98 @@
+#include "QCore/QStateIndex.h"
+#include <cstring>
+
+
+namespace QCore
+{
+	namespace
+	{
+		/* FNV-1a, stable across builds (the signature is written to disk) */
+		void HashBytes(uint64_t& Hash, const void* Data, const size_t Size)
+		{
+			const uint8_t* Bytes = static_cast<const uint8_t*>(Data);
+			for (size_t Index = 0; Index < Size; ++Index) Hash = (Hash ^ Bytes[Index]) * 0x100000001B3ull;
+		}
+
+		void HashValue(uint64_t& Hash, const uint64_t Value)
+		{
+			uint8_t Bytes[8];
+			for (int32_t Byte = 0; Byte < 8; ++Byte) Bytes[Byte] = static_cast<uint8_t>(Value >> (Byte * 8));
+			HashBytes(Hash, Bytes, sizeof(Bytes));
+		}
+	}
+
+
+	FQStateIndex::FQStateIndex(const FQDiscretizer& Discretizer)
+	{
+		const FQKeyLayout& Layout = Discretizer.GetLayout();
+		uint64_t Hash = 0xCBF29CE484222325ull;
+
+		uint64_t Count = 1;
+		Fields.resize(Layout.NumFields);
+		for (size_t FieldIndex = Layout.NumFields; FieldIndex-- > 0;) // last field packs lowest, it gets stride 1
+		{
+			const FQFieldLayout& FieldLayout = Layout.Fields[FieldIndex];
+			FField& Field = Fields[FieldIndex];
+			Field.Shift = FieldLayout.Shift;
+			if (FieldLayout.Bits > MaxFieldBits)
+			{
+				Fields.clear();
+				return;
+			}
+			Field.Mask = (uint64_t(1) << FieldLayout.Bits) - 1;
+
+			// Buckets in ascending order: a new one starts wherever Apply moves to a new lower bound
+			const uint64_t MaxOffset = static_cast<uint64_t>(static_cast<int64_t>(FieldLayout.Max) - FieldLayout.Min);
+			std::vector<uint32_t> BucketOf(static_cast<size_t>(Field.Mask) + 1);
+			uint64_t Previous = ~uint64_t(0);
+			for (uint64_t Offset = 0; Offset <= Field.Mask; ++Offset)
+			{
+				const uint64_t Clamped = Offset < MaxOffset ? Offset : MaxOffset; // above Max can't be packed, fold into the last value
+				const uint64_t Bucketed = (Discretizer.Apply(Clamped << Field.Shift) >> Field.Shift) & Field.Mask;
+				if (Bucketed != Previous)
+				{
+					Field.Bounds.push_back(static_cast<uint32_t>(Bucketed));
+					Previous = Bucketed;
+				}
+				BucketOf[Offset] = static_cast<uint32_t>(Field.Bounds.size() - 1);
+			}
+
+			Field.Radix = static_cast<uint32_t>(Field.Bounds.size());
+			Field.Stride = static_cast<uint32_t>(Count);
+			Count *= Field.Radix;
+			if (Count > MaxStates)
+			{
+				Fields.clear();
+				return;
+			}
+
+			Field.Strides.resize(BucketOf.size());
+			for (size_t Offset = 0; Offset < BucketOf.size(); ++Offset) Field.Strides[Offset] = BucketOf[Offset] * Field.Stride;
+
+			HashBytes(Hash, FieldLayout.Name, std::strlen(FieldLayout.Name) + 1);
+			HashValue(Hash, (static_cast<uint64_t>(Field.Shift) << 32) | static_cast<uint32_t>(Field.Mask));
+			for (const uint32_t Bound : Field.Bounds) HashValue(Hash, Bound);
+		}
+		HashValue(Hash, Count);
+
+		NumStates = Count;
+		Signature = Hash;
+	}
+
+	FQKey FQStateIndex::GetStateKey(const uint32_t Index) const
+	{
+		FQKey Key = 0;
+		for (const FField& Field : Fields)
+		{
+			Key |= static_cast<FQKey>(Field.Bounds[(Index / Field.Stride) % Field.Radix]) << Field.Shift;
+		}
+		return Key;
+	}
+
+	size_t FQStateIndex::GetAllocatedSize() const
+	{
+		size_t Size = Fields.capacity() * sizeof(FField);
+		for (const FField& Field : Fields) Size += (Field.Strides.capacity() + Field.Bounds.capacity()) * sizeof(uint32_t);
+		return Size;
+	}
+}
@@ -0,0 +1,58 @@
+#include "QCore/QStateSchema.h"
+
+
+namespace QCore
+{
+	size_t WriteKeyString(const FQKey Key, const FQKeyLayout& Layout, char* Out, const size_t Capacity)
+	{
+		size_t Length = 0;
+		for (size_t Index = 0; Index < Layout.NumFields; ++Index)
+		{
+			const FQFieldLayout& Field = Layout.Fields[Index];
+			const uint64_t Mask = (uint64_t(1) << Field.Bits) - 1;
+			const int32_t Value = static_cast<int32_t>((Key >> Field.Shift) & Mask) + Field.Min;
+
+			if (Index > 0 && Length < Capacity) Out[Length++] = '_';
+
+			char Digits[12];
+			size_t NumDigits = 0;
+			uint32_t Magnitude = Value < 0 ? 0u - static_cast<uint32_t>(Value) : static_cast<uint32_t>(Value);
+			do { Digits[NumDigits++] = static_cast<char>('0' + Magnitude % 10); Magnitude /= 10; } while (Magnitude);
+
+			if (Value < 0 && Length < Capacity) Out[Length++] = '-';
+			while (NumDigits && Length < Capacity) Out[Length++] = Digits[--NumDigits];
+		}
+		if (Length < Capacity) Out[Length] = '\0';
+		return Length;
+	}
+
+	bool ParseKeyString(const char* Str, const char* End, const FQKeyLayout& Layout, FQKey& OutKey)
+	{
+		FQKey Key = 0;
+		size_t Parsed = 0;
+		while (Str < End && Parsed < Layout.NumFields)
+		{
+			while (Str < End && *Str == '_') ++Str;
+			if (Str == End) break;
+
+			const bool bNegative = *Str == '-';
+			if (bNegative) ++Str;
+			int32_t Value = 0;
+			while (Str < End && *Str >= '0' && *Str <= '9')
+			{
+				Value = Value * 10 + (*Str - '0');
+				++Str;
+			}
+			if (bNegative) Value = -Value;
+			while (Str < End && *Str != '_') ++Str; // ignore trailing junk, like Atoi
+
+			const FQFieldLayout& Field = Layout.Fields[Parsed++];
+			Value = Value < Field.Min ? Field.Min : (Value > Field.Max ? Field.Max : Value);
+			Key |= static_cast<uint64_t>(Value - Field.Min) << Field.Shift;
+		}
+		if (Parsed < Layout.NumFields) return false;
+
+		OutKey = Key;
+		return true;
+	}
+}
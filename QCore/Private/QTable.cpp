@@ -0,0 +1,182 @@
+#include "QCore/QTable.h"
+#include "QCore/QAtomicDenseTable.h"
+#include "QCore/QDenseTable.h"
+#include "QCore/QMapTable.h"
+#include "QCore/QShardedTable.h"
+#include "QCore/QRowKernels.h"
+#include <cmath>
+
+
+namespace QCore
+{
+	bool IQTable::LoadRow(const FQKey Key, float* OutRow) const
+	{
+		const void* Data = FindRowData(Key);
+		if (!Data) return false;
+
+		if (StoredType == EQValueType::Int16)
+		{
+			const int16_t* Row = static_cast<const int16_t*>(Data);
+			for (int32_t Lane = 0; Lane < RowWidth; ++Lane) OutRow[Lane] = Dequantize16(Row[Lane], ValueScale);
+			return true;
+		}
+		if (StoredType == EQValueType::AtomicFloat)
+		{
+			LoadAtomicRow(static_cast<const std::atomic<float>*>(Data), OutRow);
+			return true;
+		}
+
+		const float* Row = static_cast<const float*>(Data);
+		for (int32_t Lane = 0; Lane < RowWidth; ++Lane) OutRow[Lane] = Row[Lane];
+		return true;
+	}
+
+	void IQTable::StoreRow(const FQKey Key, const float* Row)
+	{
+		void* Data = FindOrAddRowData(Key);
+		if (StoredType == EQValueType::Int16)
+		{
+			const float InvScale = 1.f / ValueScale;
+			int16_t* Values = static_cast<int16_t*>(Data);
+			for (int32_t Action = 0; Action < NumActions; ++Action) Values[Action] = Quantize16(Row[Action], InvScale);
+			return;
+		}
+		if (StoredType == EQValueType::AtomicFloat)
+		{
+			std::atomic<float>* Cells = static_cast<std::atomic<float>*>(Data);
+			for (int32_t Action = 0; Action < NumActions; ++Action) Cells[Action].store(Row[Action], std::memory_order_relaxed);
+			return;
+		}
+
+		float* Values = static_cast<float*>(Data);
+		for (int32_t Action = 0; Action < NumActions; ++Action) Values[Action] = Row[Action];
+	}
+
+
+	uint32_t IQTable::GetVisitCount(const FQKey Key, const int32_t Action) const
+	{
+		const uint32_t* Counts;
+		return FindCountedRowData(Key, Counts) && Counts ? Counts[Action] : 0;
+	}
+
+	void IQTable::StoreVisitCounts(const FQKey Key, const uint32_t* Counts)
+	{
+		if (!bVisitCounts) return;
+
+		uint32_t* RowCounts;
+		FindOrAddCountedRowData(Key, RowCounts);
+		for (int32_t Action = 0; Action < NumActions; ++Action) RowCounts[Action] = Counts[Action];
+	}
+
+
+	namespace
+	{
+		/* Dense rows: StateIndex's states if given, otherwise NumKeys keys */
+		std::unique_ptr<IQTable> MakeTableImpl(const ETableBackend Backend, const int32_t NumActions, const uint64_t NumKeys,
+			const std::shared_ptr<const FQStateIndex>& StateIndex, const EQValueType ValueType, const float ValueRange)
+		{
+			const bool bInt16 = ValueType == EQValueType::Int16;
+			const float Scale = ValueRange / static_cast<float>(MaxQuantized16);
+			if (ValueType == EQValueType::AtomicFloat)
+			{
+				if (Backend == ETableBackend::Sharded) return std::make_unique<FQShardedTable>(NumActions);
+				if (Backend != ETableBackend::Dense || !CanUseDenseTable(NumKeys)) return nullptr;
+				if (StateIndex) return std::make_unique<FQAtomicDenseTable>(NumActions, StateIndex);
+				return std::make_unique<FQAtomicDenseTable>(NumActions, NumKeys);
+			}
+			if (Backend == ETableBackend::Sharded || Backend == ETableBackend::Overlay) return nullptr; // an overlay needs its view
+
+			switch (Backend)
+			{
+				case ETableBackend::Dense:
+					if (!CanUseDenseTable(NumKeys)) return nullptr;
+					if (StateIndex) return bInt16 ? std::unique_ptr<IQTable>(std::make_unique<FQDenseTable16>(NumActions, StateIndex, Scale))
+						: std::make_unique<FQDenseTable>(NumActions, StateIndex);
+					if (bInt16) return std::make_unique<FQDenseTable16>(NumActions, NumKeys, Scale);
+					return std::make_unique<FQDenseTable>(NumActions, NumKeys);
+				case ETableBackend::Map:
+				default:
+					if (bInt16) return std::make_unique<FQMapTable16>(NumActions, Scale);
+					return std::make_unique<FQMapTable>(NumActions);
+			}
+		}
+	}
+
+	std::unique_ptr<IQTable> MakeTable(const ETableBackend Backend, const int32_t NumActions, const uint64_t NumKeys,
+		const EQValueType ValueType, const float ValueRange)
+	{
+		return MakeTableImpl(Backend, NumActions, NumKeys, nullptr, ValueType, ValueRange);
+	}
+
+	std::unique_ptr<IQTable> MakeTable(const ETableBackend Backend, const int32_t NumActions, const std::shared_ptr<const FQStateIndex>& StateIndex,
+		const EQValueType ValueType, const float ValueRange)
+	{
+		const bool bIndexed = StateIndex && StateIndex->IsValid();
+		return MakeTableImpl(Backend, NumActions, bIndexed ? StateIndex->GetNumStates() : 0, bIndexed ? StateIndex : nullptr, ValueType, ValueRange);
+	}
+
+	void MergeAverage(IQTable& Into, const IQTable& From)
+	{
+		const int32_t NumActions = Into.GetNumActions() < From.GetNumActions() ? Into.GetNumActions() : From.GetNumActions();
+
+		if (Into.GetValueType() != EQValueType::Float)
+		{
+			From.ForEachRow([&Into, NumActions](const FQKey Key, const float* OtherRow)
+			{
+				alignas(RowAlignment) float Row[RowWidth];
+				const bool bExisting = Into.LoadRow(Key, Row);
+				for (int32_t Action = 0; Action < NumActions; ++Action)
+				{
+					Row[Action] = bExisting ? (Row[Action] + OtherRow[Action]) / 2.0f : OtherRow[Action];
+				}
+				Into.StoreRow(Key, Row);
+			});
+			return;
+		}
+
+		From.ForEachRow([&Into, NumActions](const FQKey Key, const float* OtherRow)
+		{
+			const bool bNew = !Into.Contains(Key); // Num() alone can't tell on a capped table, an insert may evict
+			const FQRow Row = Into.FindOrAddRow(Key);
+			if (bNew)
+			{
+				for (int32_t Action = 0; Action < NumActions; ++Action) Row[Action] = OtherRow[Action];
+				return;
+			}
+
+			for (int32_t Action = 0; Action < NumActions; ++Action)
+			{
+				Row[Action] = (Row[Action] + OtherRow[Action]) / 2.0f; // Simple average
+			}
+		});
+	}
+
+	FQTableComparison CompareTables(const IQTable& Reference, const IQTable& Other)
+	{
+		FQTableComparison Result;
+		double SumAbsError = 0.0;
+		const int32_t NumActions = Reference.GetNumActions() < Other.GetNumActions() ? Reference.GetNumActions() : Other.GetNumActions();
+
+		Reference.ForEachRow([&](const FQKey Key, const float* ReferenceRow)
+		{
+			alignas(RowAlignment) float OtherRow[RowWidth];
+			if (!Other.LoadRow(Key, OtherRow))
+			{
+				++Result.NumMissing;
+				return;
+			}
+
+			++Result.NumCompared;
+			if (ArgMaxRowScalar(ReferenceRow) == ArgMaxRowScalar(OtherRow)) ++Result.NumGreedyMatches;
+			for (int32_t Action = 0; Action < NumActions; ++Action)
+			{
+				const float Error = std::fabs(ReferenceRow[Action] - OtherRow[Action]);
+				Result.MaxAbsError = Error > Result.MaxAbsError ? Error : Result.MaxAbsError;
+				SumAbsError += Error;
+			}
+		});
+
+		if (Result.NumCompared) Result.MeanAbsError = static_cast<float>(SumAbsError / static_cast<double>(Result.NumCompared * NumActions));
+		return Result;
+	}
+}
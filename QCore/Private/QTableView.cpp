@@ -0,0 +1,134 @@
+#include "QCore/QTableView.h"
+#include "QCore/QDiscretizer.h"
+#include "QCore/QStateSchema.h"
+#include <cstring>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define QCORE_MMAP 1
+#else
+#define QCORE_MMAP 0
+#endif
+
+
+namespace QCore
+{
+	FQTableView::FQTableView(const char* InData, const size_t Size, const FQKeyLayout& Layout, std::shared_ptr<const void> InOwner)
+		: Owner(std::move(InOwner))
+		, Data(InData)
+	{
+		if (!Data || reinterpret_cast<uintptr_t>(Data) % RowAlignment != 0) return; // rows are only aligned relative to the file start
+		if (!ParseTableBinary(Data, Size, Layout, Info) || !Info.bAlignedRows) return;
+		if (Info.NumRows >= NoRow / 2) return;
+
+		RowsData = Data + Info.ValuesOffset;
+		RowBytes = RowWidth * (Info.ValueType == EQValueType::Int16 ? sizeof(int16_t) : sizeof(float));
+
+		size_t NumSlots = 16;
+		while (NumSlots < Info.NumRows * 2) NumSlots *= 2; // at most half full, probes stay short
+		Index.assign(NumSlots, NoRow);
+		const size_t Mask = NumSlots - 1;
+		for (uint32_t Row = 0; Row < Info.NumRows; ++Row)
+		{
+			const FQKey Key = GetKey(Row);
+			size_t Slot = HashKey(Key) & Mask;
+			while (Index[Slot] != NoRow && GetKey(Index[Slot]) != Key) Slot = (Slot + 1) & Mask;
+			if (Index[Slot] == NoRow) Index[Slot] = Row; // a duplicate key keeps its first row, as a load would
+		}
+		bValid = true;
+	}
+
+	uint32_t FQTableView::FindRowIndex(const FQKey Key) const
+	{
+		if (!bValid) return NoRow;
+
+		const size_t Mask = Index.size() - 1;
+		for (size_t Slot = HashKey(Key) & Mask;; Slot = (Slot + 1) & Mask)
+		{
+			const uint32_t Row = Index[Slot];
+			if (Row == NoRow || GetKey(Row) == Key) return Row;
+		}
+	}
+
+	const uint32_t* FQTableView::GetVisitCounts(const uint32_t Row) const
+	{
+		if (!Info.bVisitCounts) return nullptr;
+		return reinterpret_cast<const uint32_t*>(Data + Info.CountsOffset) + static_cast<size_t>(Row) * Info.NumActions;
+	}
+
+	FQKey FQTableView::GetKey(const uint32_t Row) const
+	{
+		return reinterpret_cast<const FQKey*>(Data + Info.KeysOffset)[Row]; // 8-byte aligned: 40-byte header, 16-byte fields
+	}
+
+	void FQTableView::ForEachRow(const std::function<void(FQKey, const float*)>& Func) const
+	{
+		if (!bValid) return;
+
+		alignas(RowAlignment) float Values[RowWidth];
+		for (uint32_t Row = 0; Row < Info.NumRows; ++Row)
+		{
+			if (Info.ValueType != EQValueType::Int16)
+			{
+				Func(GetKey(Row), static_cast<const float*>(GetRowData(Row)));
+				continue;
+			}
+			const int16_t* Quantized = static_cast<const int16_t*>(GetRowData(Row));
+			for (int32_t Lane = 0; Lane < RowWidth; ++Lane) Values[Lane] = Dequantize16(Quantized[Lane], Info.ValueScale);
+			Func(GetKey(Row), Values);
+		}
+	}
+
+	bool FQTableView::IsDiscretizedBy(const FQDiscretizer& Discretizer) const
+	{
+		if (!bValid) return false;
+
+		for (uint32_t Row = 0; Row < Info.NumRows; ++Row)
+		{
+			const FQKey Key = GetKey(Row);
+			if (Discretizer.Apply(Key) != Key) return false;
+		}
+		return true;
+	}
+
+
+	std::shared_ptr<const FQTableView> MapTableFile(const std::string& Path, const FQKeyLayout& Layout)
+	{
+		std::shared_ptr<const void> Owner;
+		const char* Data = nullptr;
+		size_t Size = 0;
+
+#if QCORE_MMAP
+		const int File = open(Path.c_str(), O_RDONLY);
+		if (File < 0) return nullptr;
+		struct stat Stat;
+		void* Address = fstat(File, &Stat) == 0 && Stat.st_size > 0
+			? mmap(nullptr, static_cast<size_t>(Stat.st_size), PROT_READ, MAP_PRIVATE, File, 0) : MAP_FAILED;
+		close(File); // the mapping keeps the file open
+		if (Address == MAP_FAILED) return nullptr;
+
+		Size = static_cast<size_t>(Stat.st_size);
+		Data = static_cast<const char*>(Address); // page aligned
+		Owner = std::shared_ptr<const void>(Address, [Size](const void* Mapped) { munmap(const_cast<void*>(Mapped), Size); });
+#else
+		using FBuffer = std::vector<char, TAlignedAllocator<char, RowAlignment>>;
+
+		std::ifstream File(Path, std::ios::binary | std::ios::ate);
+		if (!File) return nullptr;
+		const std::shared_ptr<FBuffer> Buffer = std::make_shared<FBuffer>(static_cast<size_t>(File.tellg()));
+		File.seekg(0);
+		if (!File.read(Buffer->data(), static_cast<std::streamsize>(Buffer->size()))) return nullptr;
+
+		Size = Buffer->size();
+		Data = Buffer->data();
+		Owner = Buffer;
+#endif
+
+		const std::shared_ptr<const FQTableView> View = std::make_shared<FQTableView>(Data, Size, Layout, std::move(Owner));
+		return View->IsValid() ? View : nullptr;
+	}
+}
@@ -0,0 +1,223 @@
+#include "QCore/QTileCoding.h"
+#include "QCore/QRowKernels.h"
+#include "QCore/QStateSchema.h"
+#include <cmath>
+#include <cstring>
+
+
+namespace QCore
+{
+	namespace
+	{
+		constexpr uint32_t TileWeightsMagic = 0x4C495451; // "QTIL"
+		constexpr uint32_t TileWeightsVersion = 1;
+
+		void AppendLittleEndian(std::string& Out, const uint32_t Value)
+		{
+			for (int32_t Byte = 0; Byte < 4; ++Byte) Out.push_back(static_cast<char>(Value >> (Byte * 8)));
+		}
+
+		void AppendFloat(std::string& Out, const float Value)
+		{
+			uint32_t Bits;
+			std::memcpy(&Bits, &Value, sizeof(Bits));
+			AppendLittleEndian(Out, Bits);
+		}
+
+		uint32_t ReadLittleEndian(const char* Data)
+		{
+			uint32_t Value = 0;
+			for (int32_t Byte = 0; Byte < 4; ++Byte) Value |= static_cast<uint32_t>(static_cast<uint8_t>(Data[Byte])) << (Byte * 8);
+			return Value;
+		}
+
+		float ReadFloat(const char* Data)
+		{
+			const uint32_t Bits = ReadLittleEndian(Data);
+			float Value;
+			std::memcpy(&Value, &Bits, sizeof(Value));
+			return Value;
+		}
+	}
+
+
+	FQTileCoder::FQTileCoder(std::vector<FQTileDimension> InDimensions, const FQTileCodingConfig& InConfig)
+		: Dimensions(std::move(InDimensions))
+		, Config(InConfig)
+	{
+		const int32_t NumDimensions = GetNumDimensions();
+		bValid = Config.NumTilings >= 1 && Config.NumTilings <= MaxTilings && NumDimensions >= 1 && NumDimensions <= MaxDimensions
+			&& Config.MemorySize >= 2 && (Config.MemorySize & (Config.MemorySize - 1)) == 0;
+		for (const FQTileDimension& Dimension : Dimensions) bValid &= Dimension.Max > Dimension.Min && Dimension.Resolution > 0.f;
+		if (!bValid) return;
+
+		Scales.resize(NumDimensions);
+		for (int32_t Dimension = 0; Dimension < NumDimensions; ++Dimension)
+		{
+			Scales[Dimension] = Dimensions[Dimension].Resolution / (Dimensions[Dimension].Max - Dimensions[Dimension].Min);
+		}
+
+		// Tiling t is displaced by t * (2d + 1) / NumTilings tiles along dimension d (wrapped to one tile)
+		Offsets.resize(static_cast<size_t>(Config.NumTilings) * NumDimensions);
+		for (int32_t Tiling = 0; Tiling < Config.NumTilings; ++Tiling)
+		{
+			for (int32_t Dimension = 0; Dimension < NumDimensions; ++Dimension)
+			{
+				Offsets[Tiling * NumDimensions + Dimension] = (Tiling * (2 * Dimension + 1)) % Config.NumTilings;
+			}
+		}
+	}
+
+	void FQTileCoder::GetActiveTiles(const float* Features, uint32_t* OutTiles) const
+	{
+		const int32_t NumDimensions = GetNumDimensions();
+		int32_t Scaled[MaxDimensions]; // in 1/NumTilings tile units, so every tiling's coordinate is an integer division
+		for (int32_t Dimension = 0; Dimension < NumDimensions; ++Dimension)
+		{
+			const FQTileDimension& Range = Dimensions[Dimension];
+			const float Value = Features[Dimension] < Range.Min ? Range.Min : (Features[Dimension] > Range.Max ? Range.Max : Features[Dimension]);
+			Scaled[Dimension] = static_cast<int32_t>(std::floor((Value - Range.Min) * Scales[Dimension] * static_cast<float>(Config.NumTilings)));
+		}
+
+		const int32_t NumTilings = Config.NumTilings;
+		for (int32_t Tiling = 0; Tiling < NumTilings; ++Tiling)
+		{
+			uint64_t Hash = static_cast<uint64_t>(Tiling) + 1;
+			const int32_t* TilingOffsets = &Offsets[Tiling * NumDimensions];
+			for (int32_t Dimension = 0; Dimension < NumDimensions; ++Dimension)
+			{
+				const uint64_t Coordinate = static_cast<uint64_t>((Scaled[Dimension] + TilingOffsets[Dimension]) / NumTilings);
+				Hash = Hash * 0x9E3779B97F4A7C15ull + Coordinate;
+			}
+			OutTiles[Tiling] = HashKey(Hash) & (Config.MemorySize - 1);
+		}
+	}
+
+
+	FQTileLearner::FQTileLearner(const int32_t InNumActions, std::vector<FQTileDimension> Dimensions, const FQTileCodingConfig& Coding)
+		: Coder(std::move(Dimensions), Coding)
+		, NumActions(InNumActions)
+	{
+		if (!IsValid()) return;
+		Weights.resize(static_cast<size_t>(Coder.GetMemorySize()) * RowWidth);
+		ResetWeights();
+	}
+
+	void FQTileLearner::ResetWeights()
+	{
+		for (size_t Row = 0; Row < Weights.size(); Row += RowWidth) InitRow(&Weights[Row], NumActions);
+	}
+
+	void FQTileLearner::SumActiveRows(const uint32_t* Tiles, float* OutRow) const
+	{
+		const float* Rows[FQTileCoder::MaxTilings] = {};
+		for (int32_t Tiling = 0; Tiling < Coder.GetNumTilings(); ++Tiling) Rows[Tiling] = &Weights[static_cast<size_t>(Tiles[Tiling]) * RowWidth];
+		SumRows(Rows, Coder.GetNumTilings(), OutRow);
+	}
+
+	void FQTileLearner::GetQValues(const float* Features, float* OutRow) const
+	{
+		uint32_t Tiles[FQTileCoder::MaxTilings];
+		Coder.GetActiveTiles(Features, Tiles);
+		SumActiveRows(Tiles, OutRow);
+	}
+
+	float FQTileLearner::GetQValue(const float* Features, const int32_t Action) const
+	{
+		alignas(RowAlignment) float Row[RowWidth];
+		GetQValues(Features, Row);
+		return Row[Action];
+	}
+
+	int32_t FQTileLearner::ChooseGreedyAction(const float* Features) const
+	{
+		alignas(RowAlignment) float Row[RowWidth];
+		GetQValues(Features, Row);
+		return ArgMaxRow(Row);
+	}
+
+	int32_t FQTileLearner::ChooseAction(const float* Features)
+	{
+		if (Rng.Chance(Config.ExplorationRate))
+		{
+			return static_cast<int32_t>(Rng.NextBounded(static_cast<uint32_t>(NumActions))); // Random Action
+		}
+		return ChooseGreedyAction(Features);
+	}
+
+	void FQTileLearner::UpdateQValue(const float* PrevFeatures, const int32_t ActionTaken, const float Reward, const float* NewFeatures)
+	{
+		uint32_t Tiles[FQTileCoder::MaxTilings];
+		alignas(RowAlignment) float Row[RowWidth];
+
+		Coder.GetActiveTiles(NewFeatures, Tiles);
+		SumActiveRows(Tiles, Row);
+		const float Target = Reward + Config.DiscountFactor * MaxRow(Row);
+
+		Coder.GetActiveTiles(PrevFeatures, Tiles);
+		SumActiveRows(Tiles, Row);
+		const float Step = Config.LearningRate / static_cast<float>(Coder.GetNumTilings()) * (Target - Row[ActionTaken]);
+		for (int32_t Tiling = 0; Tiling < Coder.GetNumTilings(); ++Tiling)
+		{
+			Weights[static_cast<size_t>(Tiles[Tiling]) * RowWidth + ActionTaken] += Step; // a tile active twice (hash collision) takes both steps
+		}
+	}
+
+
+	std::string WriteTileWeightsBinary(const FQTileLearner& Learner)
+	{
+		const FQTileCoder& Coder = Learner.GetCoder();
+		std::string Out;
+		Out.reserve(24 + Coder.GetDimensions().size() * 12 + static_cast<size_t>(Coder.GetMemorySize()) * Learner.GetNumActions() * 4);
+		AppendLittleEndian(Out, TileWeightsMagic);
+		AppendLittleEndian(Out, TileWeightsVersion);
+		AppendLittleEndian(Out, static_cast<uint32_t>(Learner.GetNumActions()));
+		AppendLittleEndian(Out, static_cast<uint32_t>(Coder.GetNumTilings()));
+		AppendLittleEndian(Out, Coder.GetMemorySize());
+		AppendLittleEndian(Out, static_cast<uint32_t>(Coder.GetNumDimensions()));
+		for (const FQTileDimension& Dimension : Coder.GetDimensions())
+		{
+			AppendFloat(Out, Dimension.Min);
+			AppendFloat(Out, Dimension.Max);
+			AppendFloat(Out, Dimension.Resolution);
+		}
+		for (uint32_t Tile = 0; Tile < Coder.GetMemorySize(); ++Tile)
+		{
+			for (int32_t Action = 0; Action < Learner.GetNumActions(); ++Action) AppendFloat(Out, Learner.GetWeights()[static_cast<size_t>(Tile) * RowWidth + Action]);
+		}
+		return Out;
+	}
+
+	bool ReadTileWeightsBinary(FQTileLearner& Learner, const char* Data, const size_t Size)
+	{
+		if (!Learner.IsValid() || Size < 24) return false;
+
+		const FQTileCoder& Coder = Learner.GetCoder();
+		if (ReadLittleEndian(Data) != TileWeightsMagic || ReadLittleEndian(Data + 4) != TileWeightsVersion) return false;
+		if (ReadLittleEndian(Data + 8) != static_cast<uint32_t>(Learner.GetNumActions()) || ReadLittleEndian(Data + 12) != static_cast<uint32_t>(Coder.GetNumTilings())
+			|| ReadLittleEndian(Data + 16) != Coder.GetMemorySize() || ReadLittleEndian(Data + 20) != static_cast<uint32_t>(Coder.GetNumDimensions()))
+		{
+			return false; // other coding, the hashed tiles wouldn't mean the same thing
+		}
+
+		const size_t NumWeights = static_cast<size_t>(Coder.GetMemorySize()) * Learner.GetNumActions();
+		if (Size != 24 + Coder.GetDimensions().size() * 12 + NumWeights * 4) return false;
+
+		const char* Cursor = Data + 24;
+		for (const FQTileDimension& Dimension : Coder.GetDimensions())
+		{
+			if (ReadFloat(Cursor) != Dimension.Min || ReadFloat(Cursor + 4) != Dimension.Max || ReadFloat(Cursor + 8) != Dimension.Resolution) return false;
+			Cursor += 12;
+		}
+
+		float* Weights = Learner.GetWeights();
+		for (uint32_t Tile = 0; Tile < Coder.GetMemorySize(); ++Tile)
+		{
+			for (int32_t Action = 0; Action < Learner.GetNumActions(); ++Action, Cursor += 4)
+			{
+				Weights[static_cast<size_t>(Tile) * RowWidth + Action] = ReadFloat(Cursor);
+			}
+		}
+		return true;
+	}
+}
@@ -0,0 +1,84 @@
+#include "QCore/QTransitionModel.h"
+
+
+namespace QCore
+{
+	void FQDynaModel::Observe(const FQTransition& Transition, FDroppedLinks* OutDropped)
+	{
+		if (OutDropped) OutDropped->NumStates = 0;
+
+		const FQStateAction Pair{ Transition.PrevState, Transition.ActionTaken };
+		const bool bFull = Capacity > 0 && Entries.size() >= Capacity;
+		const auto [It, bAdded] = Index.try_emplace(Pair, static_cast<uint32_t>(bFull ? NextEvicted : Entries.size()));
+		if (bAdded && bFull)
+		{
+			FEntry& Evicted = Entries[NextEvicted];
+			if (OutDropped)
+			{
+				OutDropped->Pair = Evicted.Pair;
+				OutDropped->NumStates = Evicted.NumSuccessors;
+				for (int32_t Slot = 0; Slot < Evicted.NumSuccessors; ++Slot) OutDropped->States[Slot] = Evicted.Successors[Slot].State;
+			}
+			Index.erase(Evicted.Pair);
+			Evicted = FEntry();
+			Evicted.Pair = Pair;
+			NextEvicted = (NextEvicted + 1) % Capacity;
+		}
+		else if (bAdded)
+		{
+			Entries.emplace_back();
+			Entries.back().Pair = Pair;
+		}
+
+		FEntry& Entry = Entries[It->second];
+		++Entry.Count;
+		Entry.MeanReward += (Transition.Reward - Entry.MeanReward) / static_cast<float>(Entry.Count);
+
+		int32_t Weakest = 0;
+		for (int32_t Index = 0; Index < Entry.NumSuccessors; ++Index)
+		{
+			FSuccessor& Successor = Entry.Successors[Index];
+			if (Successor.State == Transition.NewState)
+			{
+				++Successor.Count;
+				return;
+			}
+			if (Successor.Count < Entry.Successors[Weakest].Count) Weakest = Index;
+		}
+
+		if (Entry.NumSuccessors < MaxDynaSuccessors)
+		{
+			Entry.Successors[Entry.NumSuccessors++] = { Transition.NewState, 1 };
+			return;
+		}
+		if (OutDropped)
+		{
+			OutDropped->Pair = Pair;
+			OutDropped->NumStates = 1;
+			OutDropped->States[0] = Entry.Successors[Weakest].State;
+		}
+		Entry.Successors[Weakest] = { Transition.NewState, 1 };
+	}
+
+	bool FQDynaModel::Sample(FQRandom& Rng, FQTransition& OutTransition) const
+	{
+		if (Entries.empty()) return false;
+
+		const FEntry& Entry = Entries[Rng.NextBounded(static_cast<uint32_t>(Entries.size()))];
+		uint32_t Total = 0;
+		for (int32_t Index = 0; Index < Entry.NumSuccessors; ++Index) Total += Entry.Successors[Index].Count;
+
+		uint32_t Draw = Rng.NextBounded(Total);
+		int32_t Chosen = 0;
+		while (Draw >= Entry.Successors[Chosen].Count) Draw -= Entry.Successors[Chosen++].Count;
+
+		OutTransition = { Entry.Pair.State, Entry.Successors[Chosen].State, Entry.Pair.Action, Entry.MeanReward };
+		return true;
+	}
+
+	const FQDynaModel::FEntry* FQDynaModel::Find(const FQStateAction& Pair) const
+	{
+		const auto It = Index.find(Pair);
+		return It != Index.end() ? &Entries[It->second] : nullptr;
+	}
+}
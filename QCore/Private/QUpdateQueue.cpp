@@ -0,0 +1,104 @@
+#include "QCore/QUpdateQueue.h"
+#include "QCore/QPrioritizedSweeper.h"
+#include "QCore/QRowKernels.h"
+#include <algorithm>
+
+
+namespace QCore
+{
+	namespace
+	{
+		alignas(RowAlignment) const float DefaultRow[RowWidth] = {}; // missing s' rows are implicit zeros
+	}
+
+	FQUpdateQueue::FQUpdateQueue(const size_t Capacity)
+	{
+		Entries.reserve(Capacity);
+		FutureRows.reserve(Capacity);
+		FutureMax.reserve(Capacity);
+	}
+
+	bool FQUpdateQueue::PushEntry(const FEntry& Entry)
+	{
+		if (Entries.size() == Entries.capacity()) return false; // never grow mid-frame
+		Entries.push_back(Entry);
+		Entries.back().Sequence = static_cast<uint32_t>(Entries.size() - 1);
+		return true;
+	}
+
+	bool FQUpdateQueue::Push(FQLearner& Learner, const FQKey PrevState, const int32_t ActionTaken, const float Reward, const FQKey NewState,
+		FQPrioritizedSweeper* Sweeper)
+	{
+		return PushEntry({ &Learner, Sweeper, Learner.GetTable(), Learner.Config.TraceDecay > 0.f, PrevState, NewState, ActionTaken, Reward, 0, NoFutureSlot });
+	}
+
+	bool FQUpdateQueue::PushEndEpisode(FQLearner& Learner)
+	{
+		return PushEntry({ &Learner, nullptr, Learner.GetTable(), Learner.Config.TraceDecay > 0.f, 0, 0, EndEpisodeAction, 0.f, 0, NoFutureSlot });
+	}
+
+	size_t FQUpdateQueue::Flush()
+	{
+		std::sort(Entries.begin(), Entries.end(), [](const FEntry& A, const FEntry& B)
+		{
+			if (A.Table != B.Table) return A.Table < B.Table;
+			if (A.bKeepOrder != B.bKeepOrder) return B.bKeepOrder; // state-sorted run first, then each trace learner
+			if (A.bKeepOrder && A.Learner != B.Learner) return A.Learner < B.Learner;
+			if (!A.bKeepOrder && A.PrevState != B.PrevState) return A.PrevState < B.PrevState;
+			return A.Sequence < B.Sequence;
+		});
+
+		GatherMaxFutureQ();
+
+		size_t NumApplied = 0;
+		for (const FEntry& Entry : Entries)
+		{
+			if (Entry.ActionTaken == EndEpisodeAction)
+			{
+				Entry.Learner->EndEpisode();
+				continue;
+			}
+			if (Entry.FutureSlot != NoFutureSlot) // same target UpdateQValue computes without traces
+			{
+				const float Target = Entry.Reward + Entry.Learner->Config.DiscountFactor * FutureMax[Entry.FutureSlot];
+				Entry.Learner->UpdateQValueToTarget(Entry.PrevState, Entry.ActionTaken, Target);
+			}
+			else
+			{
+				Entry.Learner->UpdateQValue(Entry.PrevState, Entry.ActionTaken, Entry.Reward, Entry.NewState);
+			}
+			if (Entry.Sweeper) Entry.Sweeper->Observe(*Entry.Learner, { Entry.PrevState, Entry.NewState, Entry.ActionTaken, Entry.Reward });
+			++NumApplied;
+		}
+
+		Entries.clear(); // keeps capacity
+		return NumApplied;
+	}
+
+	void FQUpdateQueue::GatherMaxFutureQ()
+	{
+		FutureRows.clear();
+		size_t RunBegin = 0; // first entry of the current (Table, bKeepOrder) run
+		for (size_t Index = 0; Index < Entries.size(); ++Index)
+		{
+			FEntry& Entry = Entries[Index];
+			if (Index > 0 && (Entry.Table != Entries[Index - 1].Table || Entry.bKeepOrder != Entries[Index - 1].bKeepOrder)) RunBegin = Index;
+			Entry.FutureSlot = NoFutureSlot;
+
+			const IQTable& Table = *Entry.Table;
+			if (Entry.bKeepOrder || Entry.ActionTaken == EndEpisodeAction || Table.GetValueType() != EQValueType::Float || Table.GetMaxRows() != 0) continue;
+
+			// The run is sorted by PrevState: s' is written before this update iff an earlier entry of the run updates it
+			const auto Written = std::lower_bound(Entries.begin() + RunBegin, Entries.begin() + Index, Entry.NewState,
+				[](const FEntry& Earlier, const FQKey State) { return Earlier.PrevState < State; });
+			if (Written != Entries.begin() + Index && Written->PrevState == Entry.NewState) continue;
+
+			const float* Row = static_cast<const float*>(Table.FindRowData(Entry.NewState));
+			Entry.FutureSlot = static_cast<uint32_t>(FutureRows.size());
+			FutureRows.push_back(Row ? Row : DefaultRow);
+		}
+
+		FutureMax.resize(FutureRows.size());
+		MaxRows(FutureRows.data(), static_cast<int32_t>(FutureRows.size()), FutureMax.data());
+	}
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "QCore/QStateIndex.h"
+#include "QCore/QTable.h"
+#include <memory>
+#include <vector>
+
+
+namespace QCore
+{
+	static_assert(std::atomic<float>::is_always_lock_free && sizeof(std::atomic<float>) == sizeof(float), "AtomicFloat rows need lock-free float cells");
+
+	/* Q += Delta on one cell - CAS loop, never loses a concurrent update */
+	inline void AtomicAdd(std::atomic<float>& Cell, const float Delta)
+	{
+		float Expected = Cell.load(std::memory_order_relaxed);
+		while (!Cell.compare_exchange_weak(Expected, Expected + Delta, std::memory_order_relaxed)) {}
+	}
+
+	/* Snapshot of a row (RowWidth lanes) for the row kernels - each lane is a consistent value, the row as a whole may mix updates */
+	inline void LoadAtomicRow(const std::atomic<float>* Row, float* OutRow)
+	{
+		for (int32_t Lane = 0; Lane < RowWidth; ++Lane) OutRow[Lane] = Row[Lane].load(std::memory_order_relaxed);
+	}
+
+	/*
+	 * Dense backend shared by several learners at once, no lock anywhere:
+	 * every row exists (defaults) from construction, so adding a row only sets its visited bit (atomic OR),
+	 * and learners change single cells with AtomicAdd. Lookups and policy reads are safe from any thread.
+	 * Empty() and the loaders (StoreRow) are not - call them before learners start.
+	 * Rows are addressed by the key or a FQStateIndex, as in TQDenseTable.
+	 */
+	class FQAtomicDenseTable final : public IQTable
+	{
+	public:
+		FQAtomicDenseTable(int32_t InNumActions, uint64_t InNumKeys);
+		FQAtomicDenseTable(int32_t InNumActions, std::shared_ptr<const FQStateIndex> InStateIndex); // a valid index
+
+		virtual bool Contains(const FQKey Key) const override
+		{
+			const uint64_t Row = ToRow(Key);
+			return Row < NumRows && IsVisited(Row);
+		}
+		virtual void* FindOrAddRowData(FQKey Key) override;
+		virtual const void* FindRowData(FQKey Key) const override { return Contains(Key) ? GetRow(Key) : nullptr; }
+
+		virtual size_t Num() const override { return NumVisited.load(std::memory_order_relaxed); }
+		virtual void Empty() override;
+		virtual size_t GetAllocatedSize() const override;
+		virtual ETableBackend GetBackend() const override { return ETableBackend::Dense; }
+		virtual void ForEachRow(const std::function<void(FQKey, const float*)>& Func) const override;
+
+		uint64_t GetNumRows() const { return NumRows; }
+
+		/* Unchecked access, the key's row < NumRows */
+		std::atomic<float>* GetRow(const FQKey Key) { return &Values[ToRow(Key) * RowWidth]; }
+		const std::atomic<float>* GetRow(const FQKey Key) const { return &Values[ToRow(Key) * RowWidth]; }
+
+	private:
+		uint64_t ToRow(const FQKey Key) const { return StateIndex ? StateIndex->GetStateIndex(Key) : Key; }
+		bool IsVisited(const uint64_t Row) const { return (VisitedWords[Row >> 6].load(std::memory_order_relaxed) >> (Row & 63)) & 1; }
+
+		std::shared_ptr<const FQStateIndex> StateIndex; // null - rows addressed by the key
+		uint64_t NumRows;
+		TQRowArray<std::atomic<float>> Values; // Values[Row * RowWidth + Action]
+		std::vector<std::atomic<uint64_t>> VisitedWords;
+		std::atomic<size_t> NumVisited{ 0 };
+	};
+}
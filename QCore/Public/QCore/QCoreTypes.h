@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <vector>
+
+
+/*
+ * QCore - engine-independent tabular Q-learning core
+ * Plain C++17 (no exceptions, no RTTI) so it compiles inside the UE module and as a standalone CMake library.
+ */
+namespace QCore
+{
+	/* Packed state key (see TQStateSchema::Pack) */
+	using FQKey = uint64_t;
+
+	/* Q rows: actions in the low lanes, padded to RowWidth with RowPadding, RowAlignment aligned */
+	constexpr int32_t RowWidth = 8;
+	constexpr int32_t RowAlignment = 32;
+	constexpr float RowPadding = -std::numeric_limits<float>::infinity();
+
+
+	/* Q value storage. Int16 rows are half the size (one 16-byte vector); value = stored * table scale */
+	enum class EQValueType : uint8_t
+	{
+		Float,
+		Int16,
+		AtomicFloat	// std::atomic<float> cells, CAS updates - one table shared by learners on any thread
+	};
+
+	constexpr int16_t RowPadding16 = std::numeric_limits<int16_t>::min(); // reserved, quantized values stop at -32767
+	constexpr int32_t MaxQuantized16 = std::numeric_limits<int16_t>::max();
+	constexpr float DefaultQuantizedRange = 256.f; // |Q| limit for Int16 tables, ~Rmax / (1 - gamma) for the melee rewards
+
+	/* Round to nearest, saturating to [-MaxQuantized16, MaxQuantized16] */
+	inline int16_t Quantize16(const float Value, const float InvScale)
+	{
+		const float Scaled = Value * InvScale;
+		if (!(Scaled > -static_cast<float>(MaxQuantized16))) return static_cast<int16_t>(-MaxQuantized16); // also NaN
+		if (Scaled >= static_cast<float>(MaxQuantized16)) return static_cast<int16_t>(MaxQuantized16);
+		return static_cast<int16_t>(Scaled < 0.f ? Scaled - 0.5f : Scaled + 0.5f);
+	}
+
+	inline float Dequantize16(const int16_t Value, const float Scale)
+	{
+		return Value == RowPadding16 ? RowPadding : static_cast<float>(Value) * Scale;
+	}
+
+
+	/* Minimal aligned allocator for contiguous row storage */
+	template <typename T, size_t Alignment>
+	struct TAlignedAllocator
+	{
+		using value_type = T;
+		template <typename U> struct rebind { using other = TAlignedAllocator<U, Alignment>; };
+
+		TAlignedAllocator() = default;
+		template <typename U> TAlignedAllocator(const TAlignedAllocator<U, Alignment>&) {}
+
+		T* allocate(const size_t Count) { return static_cast<T*>(::operator new(Count * sizeof(T), std::align_val_t(Alignment))); }
+		void deallocate(T* Ptr, size_t) { ::operator delete(Ptr, std::align_val_t(Alignment)); }
+
+		template <typename U> bool operator==(const TAlignedAllocator<U, Alignment>&) const { return true; }
+		template <typename U> bool operator!=(const TAlignedAllocator<U, Alignment>&) const { return false; }
+	};
+
+	template <typename ValueType>
+	using TQRowArray = std::vector<ValueType, TAlignedAllocator<ValueType, sizeof(ValueType) * RowWidth>>; // row aligned
+
+	using FQRowArray = TQRowArray<float>;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "QCore/QStateIndex.h"
+#include "QCore/QTable.h"
+#include <memory>
+
+
+namespace QCore
+{
+	/*
+	 * Dense backend: one contiguous Value[NumRows][RowWidth] block, no hashing and no per-state allocation.
+	 * Rows are addressed by the packed key (NumRows = the schema's key space, one multiply-add), or with a
+	 * FQStateIndex by the discretizer's state index (NumRows = its reachable states - ~3200 instead of 2M rows
+	 * for FQState's default buckets). Indexed tables take bucketed keys and report them back; a raw key shares
+	 * its bucket's row, so fold raw saves through a Map table first (DiscretizeTable).
+	 * A visited bit per row keeps Contains/Num/ForEachRow (saving, merging) limited to states that were seen.
+	 * Visit counts are a second NumRows * NumActions array addressed by the same row.
+	 */
+	template <typename ValueType>
+	class TQDenseTable final : public IQTable
+	{
+	public:
+		TQDenseTable(int32_t InNumActions, uint64_t InNumKeys, float InValueScale = 1.f);
+		TQDenseTable(int32_t InNumActions, std::shared_ptr<const FQStateIndex> InStateIndex, float InValueScale = 1.f); // a valid index
+
+		virtual bool Contains(const FQKey Key) const override
+		{
+			const uint64_t Row = ToRow(Key);
+			return Row < NumRows && IsVisited(Row);
+		}
+		virtual void* FindOrAddRowData(FQKey Key) override;
+		virtual const void* FindRowData(FQKey Key) const override { return Contains(Key) ? GetRow(Key) : nullptr; }
+
+		virtual size_t Num() const override { return NumVisited; }
+		virtual void Empty() override;
+		virtual size_t GetAllocatedSize() const override;
+		virtual ETableBackend GetBackend() const override { return ETableBackend::Dense; }
+		virtual void ForEachRow(const std::function<void(FQKey, const float*)>& Func) const override;
+
+		virtual bool EnableVisitCounts() override;
+		virtual void* FindOrAddCountedRowData(FQKey Key, uint32_t*& OutCounts) override;
+		virtual const void* FindCountedRowData(FQKey Key, const uint32_t*& OutCounts) const override;
+
+		uint64_t GetNumRows() const { return NumRows; }
+		const FQStateIndex* GetStateIndex() const { return StateIndex.get(); }
+
+		/* Unchecked access, the key's row < NumRows */
+		ValueType* GetRow(const FQKey Key) { return &Values[ToRow(Key) * RowWidth]; }
+		const ValueType* GetRow(const FQKey Key) const { return &Values[ToRow(Key) * RowWidth]; }
+
+	private:
+		uint64_t ToRow(const FQKey Key) const { return StateIndex ? StateIndex->GetStateIndex(Key) : Key; }
+		FQKey ToKey(const uint64_t Row) const { return StateIndex ? StateIndex->GetStateKey(static_cast<uint32_t>(Row)) : Row; }
+		bool IsVisited(const uint64_t Row) const { return (VisitedWords[Row >> 6] >> (Row & 63)) & 1; }
+
+		std::shared_ptr<const FQStateIndex> StateIndex; // null - rows addressed by the key
+		uint64_t NumRows;
+		TQRowArray<ValueType> Values; // Values[Row * RowWidth + Action]
+		std::vector<uint64_t> VisitedWords;
+		std::vector<uint32_t> Counts; // Counts[Row * NumActions + Action], empty until EnableVisitCounts
+		size_t NumVisited = 0;
+	};
+
+	using FQDenseTable = TQDenseTable<float>;
+	using FQDenseTable16 = TQDenseTable<int16_t>;
+
+	extern template class TQDenseTable<float>;
+	extern template class TQDenseTable<int16_t>;
+}
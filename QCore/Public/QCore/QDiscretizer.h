@@ -0,0 +1,67 @@
+#pragma once
+
+#include "QCore/QStateSchema.h"
+#include <vector>
+
+
+namespace QCore
+{
+	class IQTable;
+
+	/*
+	 * State discretizer - coarsens packed keys before they reach the table
+	 * Each field can get ascending bucket edges; a value is replaced by the lower bound of its bucket
+	 * (Min for the first bucket), so keys stay in the schema's layout and the text form stays readable.
+	 *	Edges {20, 40, 60, 80} on HealthPercent 0-100 -> 5 bands: 0, 20, 40, 60, 80
+	 * Fields without edges pass through untouched. Apply is a table lookup per bucketed field.
+	 */
+	class FQDiscretizer
+	{
+	public:
+		FQDiscretizer() = default;
+		explicit FQDiscretizer(const FQKeyLayout& InLayout) : Layout(InLayout) {}
+
+		/* Edges must be strictly ascending and inside (Min, Max] of the field. Empty Edges clears the field.
+		 * Returns false (and leaves the field unchanged) for an unknown field or invalid edges. */
+		bool SetBucketEdges(const char* FieldName, const int32_t* Edges, size_t NumEdges);
+		void Reset() { Buckets.clear(); }
+
+		FQKey Apply(const FQKey Key) const
+		{
+			FQKey Result = Key;
+			for (const FBucketedField& Field : Buckets)
+			{
+				const uint64_t Value = (Key >> Field.Shift) & Field.Mask;
+				Result = (Result & ~(Field.Mask << Field.Shift)) | (static_cast<uint64_t>(Field.Lookup[Value]) << Field.Shift);
+			}
+			return Result;
+		}
+
+		bool IsIdentity() const { return Buckets.empty(); }
+		bool HasSameBuckets(const FQDiscretizer& Other) const; // same layout, Apply gives the same key for every key
+		const FQKeyLayout& GetLayout() const { return Layout; }
+
+		/* Number of distinct keys Apply can produce (the table's reachable state count) */
+		uint64_t CountReachableKeys() const;
+
+		/* Largest field span that can be bucketed (the lookup holds one entry per raw value) */
+		static constexpr uint32_t MaxBucketedBits = 12;
+
+	private:
+		struct FBucketedField
+		{
+			size_t FieldIndex;
+			uint32_t Shift;
+			uint64_t Mask;
+			uint32_t NumBuckets;
+			std::vector<uint16_t> Lookup; // raw offset from Min -> bucket lower bound offset from Min
+		};
+
+		FQKeyLayout Layout;
+		std::vector<FBucketedField> Buckets;
+	};
+
+	/* Re-keys an existing table through Discretizer (e.g. a table saved before buckets were configured).
+	 * Rows that land on the same key are averaged per action and their visit counts summed. A table whose keys are all already bucketed is left untouched. */
+	void DiscretizeTable(IQTable& Table, const FQDiscretizer& Discretizer);
+}
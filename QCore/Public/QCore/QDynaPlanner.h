@@ -0,0 +1,148 @@
+#pragma once
+
+#include "QCore/QLearner.h"
+#include "QCore/QTransitionModel.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+
+namespace QCore
+{
+	struct FQDynaConfig
+	{
+		int32_t UpdatesPerBatch = 64;			// simulated updates between checks of the inbox / stop flag
+		int32_t MaxUnpublishedUpdates = 4096;	// staleness bound - planning pauses until the game thread publishes
+	};
+
+	/*
+	 * Dyna-Q background planner
+	 * A worker thread plans against a private float copy of the live table: it samples the model and applies
+	 * one-step TD updates (FQLearner::ReplayQValue), accumulating the change per (state, action).
+	 * The game thread never waits on planning:
+	 *   Observe - buffers a real transition (game thread only, no locking)
+	 *   Publish - once per frame: adds the accumulated changes to the live table, then hands the buffered
+	 *             transitions and the live rows of every state it changed or observed to the worker, which
+	 *             refreshes its copy from them
+	 * The worker stops after MaxUnpublishedUpdates until the next Publish, so the live table is never more
+	 * than that many simulated updates behind. The copy only catches up on the rows refreshed by a Publish:
+	 * those are at most a frame old (so planners sharing a live table measure their changes against each
+	 * other's), any other row lags behind whatever else writes the live table - traces, replay, sweeping,
+	 * other learners - until this planner changes or observes it.
+	 * Many planners (one per enemy) should be started unthreaded and driven by one FQDynaWorker instead of a
+	 * thread each.
+	 */
+	class FQDynaPlanner
+	{
+	public:
+		FQDynaPlanner();
+		~FQDynaPlanner() { Stop(); }
+
+		FQDynaPlanner(const FQDynaPlanner&) = delete;
+		FQDynaPlanner& operator=(const FQDynaPlanner&) = delete;
+
+		FQDynaConfig Config;
+
+		/* Copies Live's rows and learner parameters. Threaded - starts its own worker, otherwise Plan() drives it (FQDynaWorker) */
+		void Start(const IQTable& Live, const FQLearnerConfig& LearnerConfig, bool bThreaded = true);
+		void Stop(); // joins the worker, unpublished changes are dropped
+		void SeedRandom(uint64_t Seed, uint64_t Stream = 0) { Rng.SetSeed(Seed, Stream); } // before Start - the worker owns the stream
+		bool IsRunning() const { return Worker.joinable(); }
+
+		void Observe(const FQTransition& Transition) { PendingTransitions.push_back(Transition); }
+		size_t Publish(IQTable& Live); // returns the number of (state, action) changes applied
+
+		int32_t Plan(int32_t NumUpdates); // planning on the calling thread when not threaded (FQDynaWorker, tests, tools)
+
+		uint64_t GetNumPlanningUpdates() const { return NumPlanningUpdates.load(std::memory_order_relaxed); }
+		size_t GetModelSize() const { return ModelSize.load(std::memory_order_relaxed); } // observed (state, action) pairs
+
+	private:
+		struct FLiveRow
+		{
+			FQKey State;
+			float Row[RowWidth];	// live row after the real update and the published changes
+		};
+
+		void Run();
+		int32_t ApplyInbox(int32_t MaxUpdates); // Mutex held, returns how many updates may run before the next Publish
+		int32_t PlanBatch(int32_t NumUpdates); // no lock, accumulates into BatchChanges
+		void MergeBatchChanges(int32_t NumUpdates); // Mutex held
+
+		/* Game thread */
+		std::vector<FQTransition> PendingTransitions;
+		std::vector<FQKey> PublishedStates;
+		std::vector<FLiveRow> PublishedRows;
+		std::unordered_map<FQStateAction, float, FQStateActionHash> PublishedChanges;
+
+		/* Worker (or the Plan() caller) */
+		FQLearner Planner; // owns the private table copy
+		FQDynaModel Model;
+		FQRandom Rng;
+		std::unordered_map<FQStateAction, float, FQStateActionHash> BatchChanges;
+
+		/* Shared, guarded by Mutex */
+		mutable std::mutex Mutex;
+		std::condition_variable WakeUp;
+		std::vector<FQTransition> Inbox;
+		std::vector<FLiveRow> InboxRows;
+		std::unordered_map<FQStateAction, float, FQStateActionHash> Outbox; // summed Q changes not yet published
+		int32_t NumUnpublished = 0;
+		bool bStopRequested = false;
+
+		std::atomic<uint64_t> NumPlanningUpdates{ 0 };
+		std::atomic<size_t> ModelSize{ 0 };
+		std::thread Worker;
+	};
+
+	/*
+	 * One planning thread shared by any number of unthreaded FQDynaPlanners
+	 * Each frame BeginFrame grants UpdatesPerFrame simulated updates in total; the worker spends them round-robin,
+	 * one UpdatesPerBatch batch per planner at a time, and sleeps once they are spent (unused updates don't carry
+	 * over) or every planner is waiting for its Publish. The game thread only takes the lock for a few instructions.
+	 */
+	class FQDynaWorker
+	{
+	public:
+		explicit FQDynaWorker(int32_t InUpdatesPerFrame = 4096) : UpdatesPerFrame(InUpdatesPerFrame) {}
+		~FQDynaWorker() { Stop(); }
+
+		FQDynaWorker(const FQDynaWorker&) = delete;
+		FQDynaWorker& operator=(const FQDynaWorker&) = delete;
+
+		int32_t UpdatesPerFrame; // read by BeginFrame
+
+		void Start(); // the planning thread, otherwise PlanFrame() drives the planners
+		void Stop(); // joins the thread and forgets the planners
+
+		void Add(FQDynaPlanner& Planner); // started unthreaded
+		void Remove(FQDynaPlanner& Planner); // returns once the worker no longer plans for Planner
+		void BeginFrame(); // game thread, once per frame
+
+		int32_t PlanFrame(); // one frame's budget on the calling thread when the thread isn't running (tests, tools)
+
+		bool IsRunning() const { return Worker.joinable(); }
+		size_t Num() const;
+		uint64_t GetNumPlanningUpdates() const { return NumPlanningUpdates.load(std::memory_order_relaxed); }
+
+	private:
+		void Run();
+		bool PlanNext(std::unique_lock<std::mutex>& Lock); // one batch, Lock released while planning. False if nothing to do
+
+		mutable std::mutex Mutex;
+		std::condition_variable WakeUp;
+		std::condition_variable BatchDone;
+		std::vector<FQDynaPlanner*> Planners;
+		const FQDynaPlanner* Planning = nullptr; // batch in progress, Mutex not held
+		size_t Next = 0; // round-robin cursor
+		size_t NumIdle = 0; // planners in a row that had nothing to plan
+		int32_t Budget = 0;
+		bool bStopRequested = false;
+
+		std::atomic<uint64_t> NumPlanningUpdates{ 0 };
+		std::thread Worker;
+	};
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "QCore/QTable.h"
+#include "QCore/QRandom.h"
+#include "QCore/QTraces.h"
+
+
+namespace QCore
+{
+	struct FQLearnerConfig
+	{
+		float LearningRate = 0.1f;		// alpha
+		float ExplorationRate = 0.25f;	// epsilon
+		float DiscountFactor = 0.95f;	// gamma
+		float TraceDecay = 0.f;			// lambda - Watkins Q(lambda) when > 0, 0 = one-step Q-learning
+		float TraceThreshold = 0.01f;	// traces below this are pruned
+		float VisitCountExponent = 0.f;	// omega - > 0 on a table with visit counts: alpha = max(1 / N(s,a)^omega, LearningRate)
+	};
+
+	/*
+	 * Tabular Q-learning over an IQTable
+	 * ChooseAction - epsilon-greedy, unseen states act as rows of zeros
+	 *   Exploration draws come from the learner's own FQRandom; SeedRandom(Seed, Stream) makes them reproducible.
+	 * UpdateQValue - Q(s,a) <- Q(s,a) + alpha * (r + gamma * max Q(s',a') - Q(s,a))
+	 * Missing rows are implicit defaults (all 0): a row is only stored on its first non-zero write (or first count),
+	 * so states seen once while exploring, and s' rows that just contribute max 0, cost no memory.
+	 * With TraceDecay > 0 the same TD error is applied to every traced pair, scaled by its eligibility,
+	 * and the traces are cut whenever a non-greedy action is taken (Watkins).
+	 * On a table with visit counts every update counts N(s,a) (found by the same probe as the row), so with
+	 * VisitCountExponent > 0 rarely updated cells take large steps and well-estimated ones settle at LearningRate.
+	 * (A cell loaded without counts starts at N = 0, so its first update replaces the loaded value.)
+	 * The table is shared-owned: learners on an AtomicFloat table may run on different threads
+	 * (each learner itself is single-threaded - own traces and random stream).
+	 */
+	class FQLearner
+	{
+	public:
+		FQLearner();
+
+		FQLearnerConfig Config;
+
+		void SetTable(std::shared_ptr<IQTable> InTable) { Table = std::move(InTable); Traces.Empty(); }
+		IQTable* GetTable() { return Table.get(); }
+		const IQTable* GetTable() const { return Table.get(); }
+		const std::shared_ptr<IQTable>& GetSharedTable() const { return Table; }
+
+		void SeedRandom(uint64_t Seed, uint64_t Stream = 0) { Rng.SetSeed(Seed, Stream); } // one stream per agent
+		FQRandom& GetRandom() { return Rng; }
+
+		int32_t ChooseAction(FQKey State);
+		int32_t ChooseGreedyAction(FQKey State) const; // no exploration, no insertion (0 if unseen)
+		void UpdateQValue(FQKey PrevState, int32_t ActionTaken, float Reward, FQKey NewState);
+		void ReplayQValue(FQKey PrevState, int32_t ActionTaken, float Reward, FQKey NewState); // one-step update, traces untouched (replay, planning)
+		void UpdateQValueToTarget(FQKey State, int32_t Action, float Target); // Q(s,a) += alpha * (Target - Q(s,a)), model-based targets
+
+		float GetQValue(FQKey State, int32_t Action) const; // 0 if unseen (default row)
+		float GetMaxQValue(FQKey State) const; // 0 if unseen
+
+		void EndEpisode() { Traces.Empty(); } // terminal state reached, no credit flows across episodes
+		const FQTraceList& GetTraces() const { return Traces; }
+
+	private:
+		/* Value-type specific row access (float / int16 / atomic float), one instantiation per table value type */
+		template <typename OpsType> int32_t ChooseActionImpl(const OpsType& Ops, FQKey State);
+		template <typename OpsType> void UpdateQValueImpl(const OpsType& Ops, FQKey PrevState, int32_t ActionTaken, float Reward, FQKey NewState);
+		template <typename OpsType> void ApplyTarget(const OpsType& Ops, typename OpsType::FRow Row, uint32_t* Counts, FQKey State, int32_t Action, float Target); // Row may be missing
+
+		float GetStepSize(const uint32_t* Counts, int32_t Action) const; // alpha for the cell, Counts may be null
+		float CountStepSize(uint32_t* Counts, int32_t Action) const; // counts this update, then GetStepSize
+
+		std::shared_ptr<IQTable> Table;
+		FQTraceList Traces;
+		FQRandom Rng;
+	};
+}
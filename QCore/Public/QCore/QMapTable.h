@@ -0,0 +1,96 @@
+#pragma once
+
+#include "QCore/QTable.h"
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+
+namespace QCore
+{
+	/*
+	 * Sparse backend: one hashed node per visited state (the old TMap<FQState, TMap<EQAction, float>>)
+	 * With a memory limit the nodes are also kept in a clock ring (reserved once, a pointer per row): lookups set
+	 * the node's referenced bit, and an insert at the cap evicts the first unreferenced row under the hand.
+	 * Lookups on a capped table write that bit, so it isn't safe for concurrent readers.
+	 */
+	template <typename ValueType>
+	class TQMapTable final : public IQTable
+	{
+	public:
+		explicit TQMapTable(int32_t InNumActions, float InValueScale = 1.f);
+
+		virtual bool Contains(FQKey Key) const override { return Rows.find({ Key }) != Rows.end(); }
+		virtual void* FindOrAddRowData(FQKey Key) override { return FindOrAddNode(Key).second.Values; }
+		virtual const void* FindRowData(FQKey Key) const override;
+
+		virtual size_t Num() const override { return Rows.size(); }
+		virtual void Empty() override;
+		virtual size_t GetAllocatedSize() const override;
+		virtual ETableBackend GetBackend() const override { return ETableBackend::Map; }
+		virtual void ForEachRow(const std::function<void(FQKey, const float*)>& Func) const override;
+
+		virtual bool EnableVisitCounts() override;
+		virtual void* FindOrAddCountedRowData(FQKey Key, uint32_t*& OutCounts) override;
+		virtual const void* FindCountedRowData(FQKey Key, const uint32_t*& OutCounts) const override;
+
+		virtual bool SetMemoryLimit(size_t Bytes, EQEvictionPolicy Policy = EQEvictionPolicy::Clock) override;
+		virtual size_t GetMaxRows() const override { return MaxRows; }
+		virtual uint64_t GetNumEvicted() const override { return NumEvicted; }
+
+	private:
+		static constexpr uint32_t CountChunkRows = 256;
+
+		/* Counts index and referenced bit ride in the padding between the key and the aligned row, the node doesn't grow */
+		struct FKey
+		{
+			FQKey Key;
+			mutable uint32_t CountsIndex : 31; // neither is part of hash / equality
+			mutable uint32_t bReferenced : 1;
+
+			FKey(const FQKey InKey) : Key(InKey), CountsIndex(0), bReferenced(1) {}
+			bool operator==(const FKey& Other) const { return Key == Other.Key; }
+		};
+
+		struct alignas(sizeof(ValueType) * RowWidth) FRow
+		{
+			ValueType Values[RowWidth];
+		};
+
+		struct FKeyHash
+		{
+			size_t operator()(const FKey& Key) const;
+		};
+
+		using FMap = std::unordered_map<FKey, FRow, FKeyHash>;
+		using FNode = typename FMap::value_type; // address stable until erased
+
+		FNode& FindOrAddNode(FQKey Key);
+		void Touch(const FNode& Node) const;
+		size_t FindVictim(); // ring slot to evict
+		void Evict(size_t Slot);
+
+		uint32_t* GetCounts(const uint32_t Index) const { return &CountChunks[Index / CountChunkRows][(Index % CountChunkRows) * NumActions]; }
+		void AddCounts(const FKey& Key); // assigns a free counts slot
+		uint32_t SumCounts(const FKey& Key) const;
+
+		FMap Rows;
+		std::vector<std::unique_ptr<uint32_t[]>> CountChunks; // CountChunkRows rows each, never move
+		std::vector<uint32_t> FreeCounts; // slots of evicted rows
+		uint32_t NumCountRows = 0;
+
+		/* Memory cap, MaxRows 0 - unlimited */
+		size_t MaxRows = 0;
+		EQEvictionPolicy Eviction = EQEvictionPolicy::Clock;
+		std::vector<FNode*> Ring;
+		size_t Hand = 0;
+		mutable const FNode* LastAccessed = nullptr; // never the victim, its handle may be held across the next insert
+		uint64_t NumEvicted = 0;
+	};
+
+	using FQMapTable = TQMapTable<float>;
+	using FQMapTable16 = TQMapTable<int16_t>;
+
+	extern template class TQMapTable<float>;
+	extern template class TQMapTable<int16_t>;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "QCore/QTable.h"
+#include "QCore/QTableView.h"
+#include <memory>
+
+
+namespace QCore
+{
+	/*
+	 * Copy-on-write table over a shared read-only FQTableView
+	 * Reads fall through to the shared rows; the first non-const lookup of a shared row copies it (and its visit
+	 * counts) into a private Map table, which holds every row this table has written. So a hundred enemies on one
+	 * saved table share its rows and only pay for the states each of them actually updated.
+	 * Value type and scale are the view's. No memory cap: evicting a written row would bring back the stale shared one.
+	 */
+	class FQOverlayTable final : public IQTable
+	{
+	public:
+		explicit FQOverlayTable(std::shared_ptr<const FQTableView> InBase); // a valid view
+
+		virtual bool Contains(FQKey Key) const override;
+		virtual void* FindOrAddRowData(FQKey Key) override;
+		virtual const void* FindRowData(FQKey Key) const override;
+		virtual void* FindMutableRowData(FQKey Key) override;
+
+		virtual size_t Num() const override;
+		virtual void Empty() override; // drops the shared rows too
+		virtual size_t GetAllocatedSize() const override { return Rows->GetAllocatedSize(); } // private rows only, the view is shared
+		virtual ETableBackend GetBackend() const override { return ETableBackend::Overlay; }
+		virtual void ForEachRow(const std::function<void(FQKey, const float*)>& Func) const override;
+
+		virtual bool EnableVisitCounts() override;
+		virtual void* FindOrAddCountedRowData(FQKey Key, uint32_t*& OutCounts) override;
+		virtual const void* FindCountedRowData(FQKey Key, const uint32_t*& OutCounts) const override;
+		virtual void* FindMutableCountedRowData(FQKey Key, uint32_t*& OutCounts) override;
+
+		const std::shared_ptr<const FQTableView>& GetBase() const { return Base; }
+		size_t GetNumWritten() const { return Rows->Num(); } // private rows, copied or new
+		size_t GetNumShadowed() const { return NumShadowed; } // shared rows replaced by a private copy
+
+	private:
+		void* CopyOnWrite(FQKey Key, bool bAdd, uint32_t*& OutCounts);
+
+		std::shared_ptr<const FQTableView> Base;
+		std::unique_ptr<IQTable> Rows; // FQMapTable or FQMapTable16 with the view's scale
+		size_t RowBytes;
+		size_t NumShadowed = 0;
+	};
+}
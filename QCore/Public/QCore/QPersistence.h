@@ -0,0 +1,63 @@
+#pragma once
+
+#include "QCore/QStateSchema.h"
+#include "QCore/QTable.h"
+#include <string>
+
+
+/*
+ * Q table storage
+ * JSON layout matches what the UE build wrote with FJsonSerializer, so existing *_QTable.json files still load:
+ *	{ "50_100_0_1_0_0_1": { "0": 0.25, "1": 0, ... }, ... }
+ * Tables with visit counts add an "N:50.100.0.1.0.0.1": { "0": 12, "1": 0, ... } entry after each row
+ * (older readers skip it as an unparseable state).
+ * All-zero rows are the implicit default of every table, they are neither written nor loaded.
+ *
+ * Binary layout ("QTAB", native little-endian) - the saved format, JSON stays for export and older saves:
+ *	40-byte header: magic, version, actions, value type, flags, field count, value scale, row count, checksum
+ *	field layout: per field its name hash, shift, bits, min and max (keys only load under the same layout)
+ *	keys: NumRows uint64 | values: NumRows * NumActions float, or raw int16 (* scale) | counts: NumRows * NumActions uint32
+ * Every section is one contiguous copy; the checksum covers everything after the header.
+ * With aligned rows the values start RowAlignment into the file and every row keeps its RowWidth padding lanes,
+ * so a mapped file can hand rows straight to the row kernels (FQTableView).
+ * The UE adapter does file I/O through FFileHelper and only hands buffers over; the file helpers are for standalone use.
+ */
+namespace QCore
+{
+	std::string WriteTableJson(const IQTable& Table, const FQKeyLayout& Layout);
+
+	/* Replaces the table contents, false on malformed input (table is left empty). Unparseable state keys are skipped. */
+	bool ReadTableJson(IQTable& Table, const FQKeyLayout& Layout, const char* Data, size_t Size);
+
+	std::string WriteTableBinary(const IQTable& Table, const FQKeyLayout& Layout, bool bAlignedRows = false);
+
+	/* Replaces the table contents, false (table left empty) on another layout or action count, a bad checksum or truncation.
+	 * Int16 rows with the table's scale are copied raw, other value types convert through floats. */
+	bool ReadTableBinary(IQTable& Table, const FQKeyLayout& Layout, const char* Data, size_t Size);
+
+	/* Validated binary header: where the sections are, rows RowStride values apart */
+	struct FQTableFileInfo
+	{
+		int32_t NumActions = 0;
+		EQValueType ValueType = EQValueType::Float;
+		float ValueScale = 1.f;
+		bool bVisitCounts = false;
+		bool bAlignedRows = false;
+		int32_t RowStride = 0;
+		size_t NumRows = 0;
+		size_t KeysOffset = 0;
+		size_t ValuesOffset = 0;
+		size_t CountsOffset = 0;
+	};
+
+	/* Header, layout, size and checksum - everything ReadTableBinary checks except the table's action count */
+	bool ParseTableBinary(const char* Data, size_t Size, const FQKeyLayout& Layout, FQTableFileInfo& OutInfo);
+
+	bool IsTableBinary(const char* Data, size_t Size);
+	bool ReadTable(IQTable& Table, const FQKeyLayout& Layout, const char* Data, size_t Size); // either format
+
+	bool SaveTableJsonFile(const IQTable& Table, const FQKeyLayout& Layout, const std::string& Path);
+	bool LoadTableJsonFile(IQTable& Table, const FQKeyLayout& Layout, const std::string& Path);
+	bool SaveTableBinaryFile(const IQTable& Table, const FQKeyLayout& Layout, const std::string& Path, bool bAlignedRows = false);
+	bool LoadTableFile(IQTable& Table, const FQKeyLayout& Layout, const std::string& Path); // either format
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "QCore/QStateIndex.h"
+#include <string>
+#include <vector>
+
+
+namespace QCore
+{
+	class IQTable;
+
+	/*
+	 * Frozen greedy policy - one uint8 action per reachable (bucketed) state, for enemies that no longer learn
+	 * States are numbered densely by FQStateIndex, so FQState's 2M raw keys fold to 3200 bytes with the default
+	 * buckets: the whole policy stays cache-resident and one const copy is shared by every instance.
+	 * Choose is a tiny per-field index lookup plus one byte load - no hashing, no row scan, no allocation.
+	 * Unseen states and ties pick the first action, as FQLearner::ChooseGreedyAction does.
+	 */
+	class FQPolicyTable
+	{
+	public:
+		using FField = FQStateIndex::FField;
+
+		FQPolicyTable() = default;
+		explicit FQPolicyTable(const FQDiscretizer& Discretizer); // every state -> action 0, invalid if the state space can't be indexed
+
+		bool IsValid() const { return !Actions.empty(); }
+		void Build(const IQTable& Table); // greedy action of every reachable state, keys as the table stores them (bucketed)
+
+		/* Raw or bucketed key - buckets are folded by the index lookup. IsValid() */
+		int32_t Choose(const FQKey Key) const { return Actions[GetStateIndex(Key)]; }
+
+		uint32_t GetStateIndex(const FQKey Key) const { return StateIndex.GetStateIndex(Key); }
+		FQKey GetStateKey(const uint32_t State) const { return StateIndex.GetStateKey(State); } // bucketed key of a state index
+
+		size_t GetNumStates() const { return Actions.size(); }
+		int32_t GetNumActions() const { return NumActions; }
+		const uint8_t* GetActions() const { return Actions.data(); } // indexed by GetStateIndex
+		uint64_t GetSignature() const { return StateIndex.GetSignature(); } // layout + buckets, a policy only loads into the same one
+		const std::vector<FField>& GetFields() const { return StateIndex.GetFields(); } // in layout order
+
+		size_t GetAllocatedSize() const { return Actions.capacity() + StateIndex.GetAllocatedSize(); }
+
+		/* Largest state space a policy indexes (16 MB of actions) */
+		static constexpr uint64_t MaxStates = FQStateIndex::MaxStates;
+
+	private:
+		friend bool ReadPolicyBinary(FQPolicyTable& Policy, const char* Data, size_t Size);
+
+		FQStateIndex StateIndex;
+		std::vector<uint8_t> Actions;
+		int32_t NumActions = 0;
+	};
+
+	/*
+	 * Binary policy file: "QPOL", version, action count, state count, layout signature, then one byte per state
+	 * (integers little-endian). Read needs a policy constructed with the same layout and buckets, false otherwise.
+	 */
+	std::string WritePolicyBinary(const FQPolicyTable& Policy);
+	bool ReadPolicyBinary(FQPolicyTable& Policy, const char* Data, size_t Size);
+
+	/*
+	 * C++17 header with the policy compiled in (QPolicyGen): inside namespace Name, constexpr Signature, NumActions,
+	 * NumStates, Actions[NumStates] and StateIndex(Key) / Choose(Key) taking the same raw or bucketed keys as
+	 * FQPolicyTable::Choose. Fields whose buckets are their raw values index arithmetically, the rest through a
+	 * constexpr lookup, so lookups inline and need no startup work. Layout only names the fields in comments.
+	 */
+	std::string WritePolicyHeader(const FQPolicyTable& Policy, const FQKeyLayout& Layout, const char* Name, const char* Source);
+}
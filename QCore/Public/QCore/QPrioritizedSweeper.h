@@ -0,0 +1,62 @@
+#pragma once
+
+#include "QCore/QLearner.h"
+#include "QCore/QTransitionModel.h"
+#include <unordered_map>
+#include <vector>
+
+
+namespace QCore
+{
+	/*
+	 * Prioritized sweeping
+	 * Learns the transition model from real steps and keeps a max-priority queue of (state, action) pairs keyed
+	 * by |TD error| under that model, plus a predecessor index (which pairs lead to a state).
+	 * Sweep pops the largest errors first, moves Q towards the model target
+	 *		mean reward + gamma * sum over successors (count share * max Q(s'))
+	 * and requeues the predecessors of every state it changed, so a large reward (a kill) travels back along
+	 * the states that led to it within a frame or two instead of waiting for them to be revisited.
+	 * The queue holds at most Capacity pairs (allocated once); a push into a full queue replaces the smallest
+	 * queued error if it is larger. The model keeps at most ModelCapacity pairs and the predecessor index only
+	 * the links the model still holds, so memory stays bounded however long the enemy lives.
+	 */
+	class FQPrioritizedSweeper
+	{
+	public:
+		explicit FQPrioritizedSweeper(size_t InCapacity = 4096, size_t ModelCapacity = 65536);
+
+		float PriorityThreshold = 0.01f; // smaller errors aren't queued
+
+		/* After the real update of Transition - records it and queues the pair and its state's predecessors */
+		void Observe(const FQLearner& Learner, const FQTransition& Transition);
+
+		/* Returns the number of updates applied. BudgetMicros <= 0 - no time limit */
+		int32_t Sweep(FQLearner& Learner, int32_t MaxUpdates, float BudgetMicros);
+
+		void Empty();
+		size_t NumQueued() const { return Heap.size(); }
+		float GetTopPriority() const { return Heap.empty() ? 0.f : Heap[0].Priority; }
+		const FQDynaModel& GetModel() const { return Model; }
+
+	private:
+		struct FQueued
+		{
+			float Priority;
+			FQStateAction Pair;
+		};
+
+		float GetModelTarget(const FQLearner& Learner, const FQDynaModel::FEntry& Entry) const;
+		void Push(const FQStateAction& Pair, float Priority); // raises the priority if already queued
+		void QueuePredecessors(const FQLearner& Learner, FQKey State);
+		void RemovePredecessor(FQKey State, const FQStateAction& Pair);
+		void SiftUp(size_t Index);
+		void SiftDown(size_t Index);
+		void Place(size_t Index, const FQueued& Entry) { Heap[Index] = Entry; Positions[Entry.Pair] = static_cast<uint32_t>(Index); }
+
+		FQDynaModel Model;
+		std::unordered_map<FQKey, std::vector<FQStateAction>> Predecessors;
+		std::vector<FQueued> Heap; // binary max-heap on Priority
+		std::unordered_map<FQStateAction, uint32_t, FQStateActionHash> Positions; // Pair -> Heap index
+		size_t Capacity;
+	};
+}
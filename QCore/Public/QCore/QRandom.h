@@ -0,0 +1,82 @@
+#pragma once
+
+#include "QCore/QCoreTypes.h"
+#include <random>
+
+
+namespace QCore
+{
+	/*
+	 * Per-agent random stream - PCG32 (64-bit LCG state, xorshift + random rotation output)
+	 * The same seed and stream give the same draws on every platform and compiler, so a run can be replayed
+	 * bit-exactly. Streams of one seed are independent sequences - one per agent or worker thread, each owning
+	 * its FQRandom: no global state, no locking.
+	 * Constructing one is free (no OS entropy): the owner passes a seed it drew once, or calls SetSeed later.
+	 * Unseeded, every FQRandom (and every learner, replay buffer or planner owning one) draws the same seed-0 stream -
+	 * agents sharing a table must be given distinct streams.
+	 * Also a UniformRandomBitGenerator, for std::shuffle and the <random> distributions.
+	 */
+	class FQRandom
+	{
+	public:
+		using result_type = uint32_t;
+
+		explicit FQRandom(const uint64_t Seed = 0, const uint64_t Stream = 0) { SetSeed(Seed, Stream); }
+
+		void SetSeed(const uint64_t Seed, const uint64_t Stream = 0)
+		{
+			Increment = (Stream << 1) | 1;
+			State = 0;
+			Next();
+			State += Seed;
+			Next();
+		}
+
+		uint32_t Next()
+		{
+			const uint64_t Old = State;
+			State = Old * 6364136223846793005ull + Increment;
+			const uint32_t XorShifted = static_cast<uint32_t>(((Old >> 18) ^ Old) >> 27);
+			const uint32_t Rotation = static_cast<uint32_t>(Old >> 59);
+			return (XorShifted >> Rotation) | (XorShifted << ((32 - Rotation) & 31));
+		}
+
+		/* [0, 1) in steps of 2^-24 - every value is an exact float */
+		float NextFloat() { return static_cast<float>(Next() >> 8) * (1.f / 16777216.f); }
+
+		/* [0, Bound), unbiased (multiply-shift, rejecting the short tail), Bound > 0 */
+		uint32_t NextBounded(const uint32_t Bound)
+		{
+			uint64_t Product = static_cast<uint64_t>(Next()) * Bound;
+			if (static_cast<uint32_t>(Product) < Bound)
+			{
+				const uint32_t Threshold = (0u - Bound) % Bound;
+				while (static_cast<uint32_t>(Product) < Threshold) Product = static_cast<uint64_t>(Next()) * Bound;
+			}
+			return static_cast<uint32_t>(Product >> 32);
+		}
+
+		/* [Min, Max], both inclusive like FMath::RandRange */
+		int32_t RandRange(const int32_t Min, const int32_t Max)
+		{
+			return Min + static_cast<int32_t>(NextBounded(static_cast<uint32_t>(Max) - static_cast<uint32_t>(Min) + 1));
+		}
+
+		bool Chance(const float Probability) { return NextFloat() < Probability; } // true with Probability (0 never, 1 always)
+
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return ~result_type(0); }
+		result_type operator()() { return Next(); }
+
+		/* Non-reproducible seed for agents nobody asked to be replayable - draw once per session, not per stream */
+		static uint64_t MakeRandomSeed()
+		{
+			std::random_device Device;
+			return (static_cast<uint64_t>(Device()) << 32) ^ Device();
+		}
+
+	private:
+		uint64_t State = 0;
+		uint64_t Increment = 1; // odd, selects the stream
+	};
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "QCore/QLearner.h"
+#include <vector>
+
+
+namespace QCore
+{
+	struct FQTransition
+	{
+		FQKey PrevState;
+		FQKey NewState;
+		int32_t ActionTaken;
+		float Reward;
+	};
+
+	/*
+	 * Tabular experience replay
+	 * Fixed-capacity ring of recent transitions (allocated once, oldest overwritten). Replay draws
+	 * uniform samples and applies them as extra one-step TD updates, up to MaxUpdates or until the
+	 * time budget runs out, whichever comes first. Can be shared by several learners over the same key space.
+	 */
+	class FQReplayBuffer
+	{
+	public:
+		explicit FQReplayBuffer(size_t InCapacity = 4096);
+
+		void SetCapacity(size_t InCapacity); // drops stored transitions
+		void Add(const FQTransition& Transition);
+		void Empty() { Transitions.clear(); Next = 0; }
+
+		size_t Num() const { return Transitions.size(); }
+		size_t GetCapacity() const { return Capacity; }
+
+		const FQTransition& Sample(); // Num() > 0
+		void SeedRandom(uint64_t Seed, uint64_t Stream = 0) { Rng.SetSeed(Seed, Stream); }
+
+		/* Returns the number of updates applied. BudgetMicros <= 0 - no time limit */
+		int32_t Replay(FQLearner& Learner, int32_t MaxUpdates, float BudgetMicros);
+
+	private:
+		std::vector<FQTransition> Transitions;
+		size_t Capacity;
+		size_t Next = 0; // slot the next Add overwrites once full
+		FQRandom Rng;
+	};
+}
@@ -0,0 +1,306 @@
+#pragma once
+
+#include "QCore/QCoreTypes.h"
+
+#if defined(__AVX__)
+	#define QCORE_SIMD_AVX 1
+	#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define QCORE_SIMD_SSE 1
+	#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+
+/*
+ * Row kernels
+ * A Q row is RowWidth floats, 32-byte aligned. Actions fill the low lanes and the unused lanes hold
+ * RowPadding (-inf) so they never win a max, which lets greedy selection and the TD target be a single
+ * vector max-reduction instead of a walk over the actions.
+ * Ties resolve to the lowest action index (same as iterating the actions in order with a strict >).
+ * AVX when the compiler targets it, SSE2 on any x64 target, scalar otherwise.
+ */
+namespace QCore
+{
+	/* Sets the action lanes to Value and the padding lanes to RowPadding */
+	inline void InitRow(float* Row, const int32_t NumActions, const float Value = 0.f)
+	{
+		for (int32_t Lane = 0; Lane < RowWidth; ++Lane)
+		{
+			Row[Lane] = Lane < NumActions ? Value : RowPadding;
+		}
+	}
+
+	inline int32_t FirstSetBit(const uint32_t Mask)
+	{
+#if defined(_MSC_VER)
+		unsigned long Index;
+		_BitScanForward(&Index, Mask);
+		return static_cast<int32_t>(Index);
+#else
+		return __builtin_ctz(Mask);
+#endif
+	}
+
+	inline int32_t FirstSetBit64(const uint64_t Mask)
+	{
+#if defined(_MSC_VER)
+		unsigned long Index;
+		_BitScanForward64(&Index, Mask);
+		return static_cast<int32_t>(Index);
+#else
+		return __builtin_ctzll(Mask);
+#endif
+	}
+
+
+	/* --- Scalar reference (fallback + tests) --- */
+	inline float MaxRowScalar(const float* Row)
+	{
+		float Max = Row[0];
+		for (int32_t Lane = 1; Lane < RowWidth; ++Lane)
+		{
+			Max = Row[Lane] > Max ? Row[Lane] : Max;
+		}
+		return Max;
+	}
+
+	inline int32_t ArgMaxRowScalar(const float* Row)
+	{
+		int32_t Best = 0;
+		for (int32_t Lane = 1; Lane < RowWidth; ++Lane)
+		{
+			if (Row[Lane] > Row[Best]) Best = Lane;
+		}
+		return Best;
+	}
+
+
+	/* --- Single row --- */
+	inline float MaxRow(const float* Row)
+	{
+#if QCORE_SIMD_AVX
+		__m256 V = _mm256_load_ps(Row);
+		V = _mm256_max_ps(V, _mm256_permute2f128_ps(V, V, 0x01));
+		V = _mm256_max_ps(V, _mm256_shuffle_ps(V, V, _MM_SHUFFLE(1, 0, 3, 2)));
+		V = _mm256_max_ps(V, _mm256_shuffle_ps(V, V, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm256_cvtss_f32(V);
+#elif QCORE_SIMD_SSE
+		__m128 V = _mm_max_ps(_mm_load_ps(Row), _mm_load_ps(Row + 4));
+		V = _mm_max_ps(V, _mm_shuffle_ps(V, V, _MM_SHUFFLE(1, 0, 3, 2)));
+		V = _mm_max_ps(V, _mm_shuffle_ps(V, V, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_cvtss_f32(V);
+#else
+		return MaxRowScalar(Row);
+#endif
+	}
+
+	inline int32_t ArgMaxRow(const float* Row)
+	{
+#if QCORE_SIMD_AVX
+		const __m256 V = _mm256_load_ps(Row);
+		__m256 Max = _mm256_max_ps(V, _mm256_permute2f128_ps(V, V, 0x01));
+		Max = _mm256_max_ps(Max, _mm256_shuffle_ps(Max, Max, _MM_SHUFFLE(1, 0, 3, 2)));
+		Max = _mm256_max_ps(Max, _mm256_shuffle_ps(Max, Max, _MM_SHUFFLE(2, 3, 0, 1)));
+		const uint32_t Mask = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(V, Max, _CMP_EQ_OQ)));
+		return Mask ? FirstSetBit(Mask) : 0;
+#elif QCORE_SIMD_SSE
+		const __m128 Lo = _mm_load_ps(Row);
+		const __m128 Hi = _mm_load_ps(Row + 4);
+		__m128 Max = _mm_max_ps(Lo, Hi);
+		Max = _mm_max_ps(Max, _mm_shuffle_ps(Max, Max, _MM_SHUFFLE(1, 0, 3, 2)));
+		Max = _mm_max_ps(Max, _mm_shuffle_ps(Max, Max, _MM_SHUFFLE(2, 3, 0, 1)));
+		const uint32_t Mask = static_cast<uint32_t>(_mm_movemask_ps(_mm_cmpeq_ps(Lo, Max)))
+			| (static_cast<uint32_t>(_mm_movemask_ps(_mm_cmpeq_ps(Hi, Max))) << 4);
+		return Mask ? FirstSetBit(Mask) : 0;
+#else
+		return ArgMaxRowScalar(Row);
+#endif
+	}
+
+
+	/* --- Batched: many agents' rows at once (rows need not be contiguous) ---
+	 * Rows are transposed in blocks (8 on AVX, 4 on SSE) so each lane holds a different agent,
+	 * then one pass over the action columns yields every agent's max and argmax together.
+	 * OutActions and OutMax may be null if only one of them is wanted. */
+	inline void ArgMaxRows(const float* const* Rows, const int32_t Count, int32_t* OutActions, float* OutMax = nullptr)
+	{
+		int32_t Index = 0;
+
+#if QCORE_SIMD_AVX
+		for (; Index + 8 <= Count; Index += 8)
+		{
+			const float* const* Block = Rows + Index;
+			// 8x8 transpose: C[Lane] = Lane of every row in the block
+			const __m256 T0 = _mm256_unpacklo_ps(_mm256_load_ps(Block[0]), _mm256_load_ps(Block[1]));
+			const __m256 T1 = _mm256_unpackhi_ps(_mm256_load_ps(Block[0]), _mm256_load_ps(Block[1]));
+			const __m256 T2 = _mm256_unpacklo_ps(_mm256_load_ps(Block[2]), _mm256_load_ps(Block[3]));
+			const __m256 T3 = _mm256_unpackhi_ps(_mm256_load_ps(Block[2]), _mm256_load_ps(Block[3]));
+			const __m256 T4 = _mm256_unpacklo_ps(_mm256_load_ps(Block[4]), _mm256_load_ps(Block[5]));
+			const __m256 T5 = _mm256_unpackhi_ps(_mm256_load_ps(Block[4]), _mm256_load_ps(Block[5]));
+			const __m256 T6 = _mm256_unpacklo_ps(_mm256_load_ps(Block[6]), _mm256_load_ps(Block[7]));
+			const __m256 T7 = _mm256_unpackhi_ps(_mm256_load_ps(Block[6]), _mm256_load_ps(Block[7]));
+			const __m256 S0 = _mm256_shuffle_ps(T0, T2, _MM_SHUFFLE(1, 0, 1, 0));
+			const __m256 S1 = _mm256_shuffle_ps(T0, T2, _MM_SHUFFLE(3, 2, 3, 2));
+			const __m256 S2 = _mm256_shuffle_ps(T1, T3, _MM_SHUFFLE(1, 0, 1, 0));
+			const __m256 S3 = _mm256_shuffle_ps(T1, T3, _MM_SHUFFLE(3, 2, 3, 2));
+			const __m256 S4 = _mm256_shuffle_ps(T4, T6, _MM_SHUFFLE(1, 0, 1, 0));
+			const __m256 S5 = _mm256_shuffle_ps(T4, T6, _MM_SHUFFLE(3, 2, 3, 2));
+			const __m256 S6 = _mm256_shuffle_ps(T5, T7, _MM_SHUFFLE(1, 0, 1, 0));
+			const __m256 S7 = _mm256_shuffle_ps(T5, T7, _MM_SHUFFLE(3, 2, 3, 2));
+			const __m256 C[RowWidth] = {
+				_mm256_permute2f128_ps(S0, S4, 0x20), _mm256_permute2f128_ps(S1, S5, 0x20),
+				_mm256_permute2f128_ps(S2, S6, 0x20), _mm256_permute2f128_ps(S3, S7, 0x20),
+				_mm256_permute2f128_ps(S0, S4, 0x31), _mm256_permute2f128_ps(S1, S5, 0x31),
+				_mm256_permute2f128_ps(S2, S6, 0x31), _mm256_permute2f128_ps(S3, S7, 0x31) };
+
+			__m256 Max = C[0];
+			for (int32_t Lane = 1; Lane < RowWidth; ++Lane) Max = _mm256_max_ps(Max, C[Lane]);
+
+			if (OutActions)
+			{
+				// Walk lanes high to low so the lowest matching action wins
+				__m256 Best = _mm256_setzero_ps();
+				for (int32_t Lane = RowWidth - 1; Lane >= 0; --Lane)
+				{
+					Best = _mm256_blendv_ps(Best, _mm256_set1_ps(static_cast<float>(Lane)), _mm256_cmp_ps(C[Lane], Max, _CMP_EQ_OQ));
+				}
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(OutActions + Index), _mm256_cvtps_epi32(Best));
+			}
+			if (OutMax) _mm256_storeu_ps(OutMax + Index, Max);
+		}
+#elif QCORE_SIMD_SSE
+		for (; Index + 4 <= Count; Index += 4)
+		{
+			const float* const* Block = Rows + Index;
+			__m128 Lo0 = _mm_load_ps(Block[0]), Lo1 = _mm_load_ps(Block[1]), Lo2 = _mm_load_ps(Block[2]), Lo3 = _mm_load_ps(Block[3]);
+			__m128 Hi0 = _mm_load_ps(Block[0] + 4), Hi1 = _mm_load_ps(Block[1] + 4), Hi2 = _mm_load_ps(Block[2] + 4), Hi3 = _mm_load_ps(Block[3] + 4);
+			_MM_TRANSPOSE4_PS(Lo0, Lo1, Lo2, Lo3);
+			_MM_TRANSPOSE4_PS(Hi0, Hi1, Hi2, Hi3);
+			const __m128 C[RowWidth] = { Lo0, Lo1, Lo2, Lo3, Hi0, Hi1, Hi2, Hi3 };
+
+			__m128 Max = C[0];
+			for (int32_t Lane = 1; Lane < RowWidth; ++Lane) Max = _mm_max_ps(Max, C[Lane]);
+
+			if (OutActions)
+			{
+				// Walk lanes high to low so the lowest matching action wins (and/andnot blend, SSE2 has no blendv)
+				__m128i Best = _mm_setzero_si128();
+				for (int32_t Lane = RowWidth - 1; Lane >= 0; --Lane)
+				{
+					const __m128i Match = _mm_castps_si128(_mm_cmpeq_ps(C[Lane], Max));
+					Best = _mm_or_si128(_mm_and_si128(Match, _mm_set1_epi32(Lane)), _mm_andnot_si128(Match, Best));
+				}
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(OutActions + Index), Best);
+			}
+			if (OutMax) _mm_storeu_ps(OutMax + Index, Max);
+		}
+#endif
+
+		for (; Index < Count; ++Index)
+		{
+			if (OutActions) OutActions[Index] = ArgMaxRow(Rows[Index]);
+			if (OutMax) OutMax[Index] = MaxRow(Rows[Index]);
+		}
+	}
+
+	inline void MaxRows(const float* const* Rows, const int32_t Count, float* OutMax)
+	{
+		ArgMaxRows(Rows, Count, nullptr, OutMax);
+	}
+
+	/* Lane-wise sum of Count >= 1 rows (linear Q over active tiles). Padding lanes stay RowPadding: -inf + -inf = -inf */
+	inline void SumRows(const float* const* Rows, const int32_t Count, float* Out)
+	{
+#if QCORE_SIMD_AVX
+		__m256 Sum = _mm256_load_ps(Rows[0]);
+		for (int32_t Index = 1; Index < Count; ++Index) Sum = _mm256_add_ps(Sum, _mm256_load_ps(Rows[Index]));
+		_mm256_store_ps(Out, Sum);
+#elif QCORE_SIMD_SSE
+		__m128 Lo = _mm_load_ps(Rows[0]);
+		__m128 Hi = _mm_load_ps(Rows[0] + 4);
+		for (int32_t Index = 1; Index < Count; ++Index)
+		{
+			Lo = _mm_add_ps(Lo, _mm_load_ps(Rows[Index]));
+			Hi = _mm_add_ps(Hi, _mm_load_ps(Rows[Index] + 4));
+		}
+		_mm_store_ps(Out, Lo);
+		_mm_store_ps(Out + 4, Hi);
+#else
+		for (int32_t Lane = 0; Lane < RowWidth; ++Lane) Out[Lane] = Rows[0][Lane];
+		for (int32_t Index = 1; Index < Count; ++Index)
+		{
+			for (int32_t Lane = 0; Lane < RowWidth; ++Lane) Out[Lane] += Rows[Index][Lane];
+		}
+#endif
+	}
+
+
+	/* --- Int16 rows (quantized tables) ---
+	 * RowWidth int16 values = one 16-byte vector, padding lanes hold RowPadding16.
+	 * The reduction runs on the raw integers (the scale is positive, so the order is the same)
+	 * and only the winning lane is converted and scaled, still in a register. */
+	inline void InitRow(int16_t* Row, const int32_t NumActions, const int16_t Value = 0)
+	{
+		for (int32_t Lane = 0; Lane < RowWidth; ++Lane)
+		{
+			Row[Lane] = Lane < NumActions ? Value : RowPadding16;
+		}
+	}
+
+	inline int16_t MaxRowRaw16Scalar(const int16_t* Row)
+	{
+		int16_t Max = Row[0];
+		for (int32_t Lane = 1; Lane < RowWidth; ++Lane)
+		{
+			Max = Row[Lane] > Max ? Row[Lane] : Max;
+		}
+		return Max;
+	}
+
+	inline int32_t ArgMaxRow16Scalar(const int16_t* Row)
+	{
+		int32_t Best = 0;
+		for (int32_t Lane = 1; Lane < RowWidth; ++Lane)
+		{
+			if (Row[Lane] > Row[Best]) Best = Lane;
+		}
+		return Best;
+	}
+
+#if QCORE_SIMD_AVX || QCORE_SIMD_SSE
+	/* Max of all 8 lanes, broadcast to every lane */
+	inline __m128i MaxLanes16(const __m128i Row)
+	{
+		__m128i V = _mm_max_epi16(Row, _mm_shuffle_epi32(Row, _MM_SHUFFLE(1, 0, 3, 2)));
+		V = _mm_max_epi16(V, _mm_shuffle_epi32(V, _MM_SHUFFLE(2, 3, 0, 1)));
+		V = _mm_max_epi16(V, _mm_shufflelo_epi16(V, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_shuffle_epi32(_mm_shufflelo_epi16(V, 0), 0);
+	}
+#endif
+
+	inline float MaxRow16(const int16_t* Row, const float Scale)
+	{
+#if QCORE_SIMD_AVX || QCORE_SIMD_SSE
+		const __m128i Max = MaxLanes16(_mm_load_si128(reinterpret_cast<const __m128i*>(Row)));
+		const __m128i Widened = _mm_srai_epi32(_mm_slli_epi32(Max, 16), 16); // sign-extend lane 0 to 32 bits
+		return _mm_cvtss_f32(_mm_mul_ss(_mm_cvtepi32_ps(Widened), _mm_set_ss(Scale)));
+#else
+		return static_cast<float>(MaxRowRaw16Scalar(Row)) * Scale;
+#endif
+	}
+
+	inline int32_t ArgMaxRow16(const int16_t* Row)
+	{
+#if QCORE_SIMD_AVX || QCORE_SIMD_SSE
+		const __m128i V = _mm_load_si128(reinterpret_cast<const __m128i*>(Row));
+		const uint32_t Mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi16(V, MaxLanes16(V))));
+		return FirstSetBit(Mask) >> 1; // two mask bits per lane
+#else
+		return ArgMaxRow16Scalar(Row);
+#endif
+	}
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "QCore/QAtomicDenseTable.h"
+#include "QCore/QStateSchema.h"
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+namespace QCore
+{
+	/*
+	 * Sharded backend: concurrent hash table for key spaces too large for Dense (AtomicFloat rows).
+	 * Keys are spread over NumShards shards, each an open-addressing (linear probing) index guarded by its
+	 * own mutex, held only while probing or inserting. Rows live in per-shard chunks that never move, so a
+	 * handle stays valid and its cells are updated lock-free (AtomicAdd) like FQAtomicDenseTable's.
+	 * Empty() invalidates handles and must not race with learners.
+	 */
+	class FQShardedTable final : public IQTable
+	{
+	public:
+		static constexpr int32_t DefaultNumShards = 64;
+
+		explicit FQShardedTable(int32_t InNumActions, int32_t InNumShards = DefaultNumShards); // rounded up to a power of two
+
+		virtual bool Contains(FQKey Key) const override { return FindRowData(Key) != nullptr; }
+		virtual void* FindOrAddRowData(FQKey Key) override;
+		virtual const void* FindRowData(FQKey Key) const override;
+
+		virtual size_t Num() const override { return NumRows.load(std::memory_order_relaxed); }
+		virtual void Empty() override;
+		virtual size_t GetAllocatedSize() const override;
+		virtual ETableBackend GetBackend() const override { return ETableBackend::Sharded; }
+		virtual void ForEachRow(const std::function<void(FQKey, const float*)>& Func) const override; // locks one shard at a time
+
+		int32_t GetNumShards() const { return NumShards; }
+
+	private:
+		static constexpr uint32_t EmptySlot = ~uint32_t(0);
+		static constexpr uint32_t RowsPerChunk = 256;
+		static constexpr size_t InitialSlots = 16;
+
+		struct FSlot
+		{
+			FQKey Key;
+			uint32_t Row; // EmptySlot if unused
+		};
+
+		struct alignas(64) FShard // own cache line, writers on different shards don't share one
+		{
+			mutable std::mutex Mutex;
+			std::vector<FSlot> Slots; // power of two, at most half full
+			std::vector<TQRowArray<std::atomic<float>>> Chunks; // RowsPerChunk rows each
+			uint32_t NumRows = 0;
+		};
+
+		FShard& GetShard(const FQKey Key) const { return Shards[HashKey(Key) & (NumShards - 1)]; }
+		static size_t FindSlot(const FShard& Shard, FQKey Key); // Mutex held - the key's slot or the empty slot it would go in
+		static std::atomic<float>* GetRow(const FShard& Shard, uint32_t Row)
+		{
+			return const_cast<std::atomic<float>*>(&Shard.Chunks[Row / RowsPerChunk][(Row % RowsPerChunk) * RowWidth]);
+		}
+		static void Grow(FShard& Shard);
+		void ResetShard(FShard& Shard) const;
+
+		int32_t NumShards;
+		std::unique_ptr<FShard[]> Shards;
+		std::atomic<size_t> NumRows{ 0 };
+	};
+}
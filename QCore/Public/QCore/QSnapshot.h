@@ -0,0 +1,139 @@
+#pragma once
+
+#include "QCore/QTable.h"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+
+namespace QCore
+{
+	/*
+	 * Immutable copy of a table's visited rows (floats, dequantized) for policy readers.
+	 * Open-addressing key index over packed rows - built once by FQSnapshotPublisher, never written after.
+	 */
+	class FQTableSnapshot
+	{
+	public:
+		FQConstRow FindRow(FQKey Key) const; // empty if the state wasn't in the table
+		int32_t ChooseGreedyAction(FQKey Key) const; // 0 if unseen, as FQLearner::ChooseGreedyAction
+		void ForEachRow(const std::function<void(FQKey, const float*)>& Func) const;
+
+		size_t Num() const { return NumRows; }
+		int32_t GetNumActions() const { return NumActions; }
+		uint64_t GetVersion() const { return Version; } // 1 for the first publish
+		size_t GetAllocatedSize() const { return Slots.capacity() * sizeof(FSlot) + Rows.capacity() * sizeof(float); }
+
+	private:
+		friend class FQSnapshotPublisher;
+
+		static constexpr uint32_t EmptySlot = ~uint32_t(0);
+
+		struct FSlot
+		{
+			FQKey Key;
+			uint32_t Row;
+		};
+
+		void Build(const IQTable& Source, uint64_t InVersion); // reuses this snapshot's buffers
+		size_t FindSlot(FQKey Key) const;
+
+		std::vector<FSlot> Slots; // power of two, at most half full
+		FQRowArray Rows; // Rows[Row * RowWidth + Action]
+		size_t NumRows = 0;
+		int32_t NumActions = 0;
+		uint64_t Version = 0;
+	};
+
+	/* Concurrent readers a publisher can serve at once (one slot per FQSnapshotReader) */
+	constexpr int32_t MaxSnapshotReaders = 64;
+
+	/*
+	 * RCU-style snapshot publishing
+	 * The learner keeps mutating its own table; Publish (one writer thread) copies it into a new snapshot and
+	 * swaps the current pointer atomically. Readers pin the current snapshot without taking any lock:
+	 *	FQSnapshotReader Reader(Publisher);				// claims a reader slot, once per reading thread
+	 *	const FQSnapshotReader::FPin Pin = Reader.Pin();	// consistent until the pin goes out of scope
+	 *	Pin->ChooseGreedyAction(Key);
+	 * A replaced snapshot is retired with the epoch it was current in and reused once every pinned reader has
+	 * moved past that epoch, so a pinned snapshot is never freed or rebuilt underneath its reader.
+	 * All readers must be gone before the publisher is destroyed.
+	 */
+	class FQSnapshotPublisher
+	{
+	public:
+		FQSnapshotPublisher();
+		~FQSnapshotPublisher();
+
+		FQSnapshotPublisher(const FQSnapshotPublisher&) = delete;
+		FQSnapshotPublisher& operator=(const FQSnapshotPublisher&) = delete;
+
+		void Publish(const IQTable& Source);
+		size_t Reclaim(); // also run by Publish, returns how many retired snapshots became reusable
+
+		uint64_t GetVersion() const { return NumPublished; } // writer side
+		size_t GetNumRetired() const { return Retired.size(); }
+
+	private:
+		friend class FQSnapshotReader;
+
+		static constexpr uint64_t FreeSlot = ~uint64_t(0);	// no reader owns the slot
+		static constexpr uint64_t IdleSlot = 0;				// owned, nothing pinned
+
+		struct FRetired
+		{
+			std::unique_ptr<FQTableSnapshot> Snapshot;
+			uint64_t Epoch; // readers pinned at or before this epoch may still use it
+		};
+
+		std::atomic<FQTableSnapshot*> Current{ nullptr };
+		std::atomic<uint64_t> GlobalEpoch{ 1 };
+		std::array<std::atomic<uint64_t>, MaxSnapshotReaders> ReaderEpochs;
+
+		/* Writer only */
+		std::vector<FRetired> Retired;
+		std::vector<std::unique_ptr<FQTableSnapshot>> Reusable; // reclaimed, buffers kept for the next Publish
+		uint64_t NumPublished = 0;
+	};
+
+	class FQSnapshotReader
+	{
+	public:
+		explicit FQSnapshotReader(FQSnapshotPublisher& InPublisher); // IsValid() is false when all slots are taken
+		~FQSnapshotReader();
+
+		FQSnapshotReader(const FQSnapshotReader&) = delete;
+		FQSnapshotReader& operator=(const FQSnapshotReader&) = delete;
+
+		bool IsValid() const { return Slot >= 0; }
+
+		class FPin
+		{
+		public:
+			FPin(FPin&& Other) noexcept : Epoch(Other.Epoch), Snapshot(Other.Snapshot) { Other.Epoch = nullptr; }
+			~FPin() { if (Epoch) Epoch->store(FQSnapshotPublisher::IdleSlot, std::memory_order_release); }
+
+			FPin(const FPin&) = delete;
+			FPin& operator=(const FPin&) = delete;
+			FPin& operator=(FPin&&) = delete;
+
+			explicit operator bool() const { return Snapshot != nullptr; } // false before the first publish
+			const FQTableSnapshot* Get() const { return Snapshot; }
+			const FQTableSnapshot* operator->() const { return Snapshot; }
+
+		private:
+			friend class FQSnapshotReader;
+			FPin(std::atomic<uint64_t>* InEpoch, const FQTableSnapshot* InSnapshot) : Epoch(InEpoch), Snapshot(InSnapshot) {}
+
+			std::atomic<uint64_t>* Epoch;
+			const FQTableSnapshot* Snapshot;
+		};
+
+		FPin Pin(); // one pin per reader at a time
+
+	private:
+		FQSnapshotPublisher& Publisher;
+		int32_t Slot = -1;
+	};
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "QCore/QDiscretizer.h"
+#include <vector>
+
+
+namespace QCore
+{
+	/*
+	 * Dense numbering of a discretizer's reachable states
+	 * States are numbered in mixed radix over the buckets (bucketed fields count buckets, the rest their raw range),
+	 * so FQState's 2M raw keys fold to ~3200 states with the default buckets. Used by FQPolicyTable (one action per
+	 * state) and the Dense tables (one row per state).
+	 * GetStateIndex is a tiny per-field lookup; raw and bucketed keys of the same bucket share an index.
+	 */
+	class FQStateIndex
+	{
+	public:
+		struct FField
+		{
+			uint32_t Shift;
+			uint64_t Mask;
+			uint32_t Radix; // buckets (or raw values) of the field
+			uint32_t Stride; // state index step per bucket
+			std::vector<uint32_t> Strides; // raw offset -> bucket * Stride
+			std::vector<uint32_t> Bounds; // bucket -> raw offset of its lower bound
+		};
+
+		FQStateIndex() = default;
+		explicit FQStateIndex(const FQDiscretizer& Discretizer); // invalid if the state space can't be indexed
+
+		bool IsValid() const { return NumStates > 0; }
+
+		/* Raw or bucketed key - buckets are folded by the lookup. IsValid() */
+		uint32_t GetStateIndex(const FQKey Key) const
+		{
+			uint32_t Index = 0;
+			for (const FField& Field : Fields) Index += Field.Strides[(Key >> Field.Shift) & Field.Mask];
+			return Index;
+		}
+		FQKey GetStateKey(uint32_t Index) const; // bucketed key of a state index
+
+		uint64_t GetNumStates() const { return NumStates; }
+		uint64_t GetSignature() const { return Signature; } // layout + buckets
+		const std::vector<FField>& GetFields() const { return Fields; } // in layout order
+
+		size_t GetAllocatedSize() const;
+
+		/* Largest state space indexed (MaxDenseKeys), widest field (its lookup holds one entry per raw value) */
+		static constexpr uint64_t MaxStates = uint64_t(1) << 24;
+		static constexpr uint32_t MaxFieldBits = 16;
+
+	private:
+		std::vector<FField> Fields;
+		uint64_t NumStates = 0;
+		uint64_t Signature = 0;
+	};
+}
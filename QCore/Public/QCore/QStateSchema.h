@@ -0,0 +1,274 @@
+#pragma once
+
+#include "QCore/QCoreTypes.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+
+/*
+ * Compile-time state schema
+ * A state struct lists its fields once (member, name, inclusive range) and TQStateSchema generates
+ * everything else from that list: the packed 64-bit key, hash, equality, binary codec, DQN float
+ * vector and the legacy "a_b_c" text form. No engine dependency, so both UE projects share it.
+ *
+ *	struct FQState
+ *	{
+ *		int8 HealthPercent;
+ *		bool bWasHitRecently;
+ *
+ *		static constexpr auto Fields = std::make_tuple(
+ *			QCore::QField(&FQState::HealthPercent, "HealthPercent", 0, 100),
+ *			QCore::QField(&FQState::bWasHitRecently, "bWasHitRecently"));
+ *		using Schema = QCore::TQStateSchema<FQState, Fields>;
+ *	};
+ *
+ * Fields are packed first-field-highest, so keys sort by the first field.
+ */
+namespace QCore
+{
+	constexpr uint32_t BitsForSpan(uint64_t Span)
+	{
+		uint32_t Bits = 0;
+		while (Span) { ++Bits; Span >>= 1; }
+		return Bits;
+	}
+
+	/* 64 -> 32 bit finalizer (MurmurHash3 fmix64), good enough spread for packed keys */
+	constexpr uint32_t HashKey(uint64_t Key)
+	{
+		Key ^= Key >> 33;
+		Key *= 0xff51afd7ed558ccdULL;
+		Key ^= Key >> 33;
+		Key *= 0xc4ceb9fe1a85ec53ULL;
+		Key ^= Key >> 33;
+		return static_cast<uint32_t>(Key);
+	}
+
+	template <typename StructType, typename FieldType>
+	struct TQField
+	{
+		FieldType StructType::* Member;
+		const char* Name;
+		int32_t Min;
+		int32_t Max;
+
+		constexpr uint32_t GetBits() const { return BitsForSpan(static_cast<uint64_t>(static_cast<int64_t>(Max) - Min)); }
+		constexpr uint64_t GetMask() const { return (uint64_t(1) << GetBits()) - 1; }
+	};
+
+	template <typename StructType, typename FieldType>
+	constexpr TQField<StructType, FieldType> QField(FieldType StructType::* Member, const char* Name, int32_t Min, int32_t Max)
+	{
+		return { Member, Name, Min, Max };
+	}
+
+	template <typename StructType>
+	constexpr TQField<StructType, bool> QField(bool StructType::* Member, const char* Name)
+	{
+		return { Member, Name, 0, 1 };
+	}
+
+	/* Runtime view of one field - used by persistence headers and tooling that can't see the template */
+	struct FQFieldLayout
+	{
+		const char* Name;
+		uint32_t Shift;
+		uint32_t Bits;
+		int32_t Min;
+		int32_t Max;
+	};
+
+	/* Runtime view of a whole schema (see MakeKeyLayout) */
+	struct FQKeyLayout
+	{
+		const FQFieldLayout* Fields = nullptr;
+		size_t NumFields = 0;
+	};
+
+	/* Key <-> "a_b_c" text form for code that only has a layout (JSON persistence, tools) */
+	size_t WriteKeyString(FQKey Key, const FQKeyLayout& Layout, char* Out, size_t Capacity);
+	bool ParseKeyString(const char* Str, const char* End, const FQKeyLayout& Layout, FQKey& OutKey);
+
+
+	template <typename StructType, const auto& Fields>
+	struct TQStateSchema
+	{
+		static constexpr size_t NumFields = std::tuple_size_v<std::decay_t<decltype(Fields)>>;
+
+		template <size_t I>
+		static constexpr uint32_t GetShift()
+		{
+			if constexpr (I + 1 >= NumFields) return 0;
+			else return std::get<I + 1>(Fields).GetBits() + GetShift<I + 1>();
+		}
+
+		static constexpr uint32_t TotalBits = std::get<0>(Fields).GetBits() + GetShift<0>();
+		static_assert(TotalBits <= 64, "State schema does not fit a 64-bit key");
+
+		static constexpr uint64_t NumKeys = TotalBits < 64 ? (uint64_t(1) << TotalBits) : 0; // dense key space, 0 if it is the full 64 bits
+		static constexpr size_t NumBytes = (TotalBits + 7) / 8;
+
+
+		/* --- Key --- */
+		static constexpr uint64_t Pack(const StructType& State)
+		{
+			return PackImpl(State, std::make_index_sequence<NumFields>{});
+		}
+
+		static constexpr StructType Unpack(const uint64_t Key)
+		{
+			StructType State{};
+			UnpackImpl(Key, State, std::make_index_sequence<NumFields>{});
+			return State;
+		}
+
+		static constexpr uint32_t Hash(const StructType& State) { return HashKey(Pack(State)); }
+		static constexpr bool Equals(const StructType& A, const StructType& B) { return Pack(A) == Pack(B); }
+
+
+		/* --- Binary codec (little-endian packed key, NumBytes wide) --- */
+		static void WriteBytes(const StructType& State, uint8_t* Out)
+		{
+			const uint64_t Key = Pack(State);
+			for (size_t Byte = 0; Byte < NumBytes; ++Byte)
+			{
+				Out[Byte] = static_cast<uint8_t>(Key >> (8 * Byte));
+			}
+		}
+
+		static StructType ReadBytes(const uint8_t* In)
+		{
+			uint64_t Key = 0;
+			for (size_t Byte = 0; Byte < NumBytes; ++Byte)
+			{
+				Key |= static_cast<uint64_t>(In[Byte]) << (8 * Byte);
+			}
+			return Unpack(Key);
+		}
+
+
+		/* --- DQN input (raw field values as floats, bools 0/1) --- */
+		static void ToFloats(const StructType& State, float* Out)
+		{
+			ToFloatsImpl(State, Out, std::make_index_sequence<NumFields>{});
+		}
+
+
+		/* --- Text form "a_b_c" (debug output + legacy JSON keys), no allocation --- */
+		template <typename CharType>
+		static size_t WriteString(const StructType& State, CharType* Out, size_t Capacity)
+		{
+			size_t Length = 0;
+			WriteStringImpl(State, Out, Capacity, Length, std::make_index_sequence<NumFields>{});
+			if (Length < Capacity) Out[Length] = CharType(0);
+			return Length;
+		}
+
+		/* Parses the text form, false if there are fewer than NumFields numbers (State is left default) */
+		template <typename CharType>
+		static bool ParseString(const CharType* Str, StructType& OutState)
+		{
+			int32_t Values[NumFields] = {};
+			size_t Parsed = 0;
+			while (*Str && Parsed < NumFields)
+			{
+				while (*Str == CharType('_')) ++Str;
+				if (!*Str) break;
+
+				const bool bNegative = *Str == CharType('-');
+				if (bNegative) ++Str;
+				int32_t Value = 0;
+				while (*Str >= CharType('0') && *Str <= CharType('9'))
+				{
+					Value = Value * 10 + static_cast<int32_t>(*Str - CharType('0'));
+					++Str;
+				}
+				Values[Parsed++] = bNegative ? -Value : Value;
+				while (*Str && *Str != CharType('_')) ++Str; // ignore trailing junk, like Atoi
+			}
+			if (Parsed < NumFields) return false;
+
+			AssignImpl(Values, OutState, std::make_index_sequence<NumFields>{});
+			return true;
+		}
+
+		static constexpr size_t MaxStringLength = NumFields * 12;
+
+
+		/* --- Runtime layout --- */
+		static constexpr std::array<FQFieldLayout, NumFields> GetLayout()
+		{
+			return LayoutImpl(std::make_index_sequence<NumFields>{});
+		}
+
+	private:
+		template <size_t I>
+		static constexpr int32_t ClampedValue(const StructType& State)
+		{
+			constexpr auto& Field = std::get<I>(Fields);
+			const int32_t Value = static_cast<int32_t>(State.*(Field.Member));
+			return Value < Field.Min ? Field.Min : (Value > Field.Max ? Field.Max : Value);
+		}
+
+		template <size_t... I>
+		static constexpr uint64_t PackImpl(const StructType& State, std::index_sequence<I...>)
+		{
+			return (... | (static_cast<uint64_t>(ClampedValue<I>(State) - std::get<I>(Fields).Min) << GetShift<I>()));
+		}
+
+		template <size_t... I>
+		static constexpr void UnpackImpl(const uint64_t Key, StructType& State, std::index_sequence<I...>)
+		{
+			((State.*(std::get<I>(Fields).Member) = static_cast<std::remove_reference_t<decltype(State.*(std::get<I>(Fields).Member))>>(
+				static_cast<int32_t>((Key >> GetShift<I>()) & std::get<I>(Fields).GetMask()) + std::get<I>(Fields).Min)), ...);
+		}
+
+		template <size_t... I>
+		static void ToFloatsImpl(const StructType& State, float* Out, std::index_sequence<I...>)
+		{
+			((Out[I] = static_cast<float>(State.*(std::get<I>(Fields).Member))), ...);
+		}
+
+		template <typename CharType>
+		static void AppendInt(int32_t Value, CharType* Out, const size_t Capacity, size_t& Length)
+		{
+			CharType Digits[12];
+			size_t NumDigits = 0;
+			const bool bNegative = Value < 0;
+			uint32_t Magnitude = bNegative ? 0u - static_cast<uint32_t>(Value) : static_cast<uint32_t>(Value);
+			do { Digits[NumDigits++] = CharType('0' + Magnitude % 10); Magnitude /= 10; } while (Magnitude);
+
+			if (bNegative && Length < Capacity) Out[Length++] = CharType('-');
+			while (NumDigits && Length < Capacity) Out[Length++] = Digits[--NumDigits];
+		}
+
+		template <typename CharType, size_t... I>
+		static void WriteStringImpl(const StructType& State, CharType* Out, const size_t Capacity, size_t& Length, std::index_sequence<I...>)
+		{
+			((I > 0 && Length < Capacity ? (void)(Out[Length++] = CharType('_')) : (void)0,
+			  AppendInt(static_cast<int32_t>(State.*(std::get<I>(Fields).Member)), Out, Capacity, Length)), ...);
+		}
+
+		template <size_t... I>
+		static void AssignImpl(const int32_t* Values, StructType& State, std::index_sequence<I...>)
+		{
+			((State.*(std::get<I>(Fields).Member) = static_cast<std::remove_reference_t<decltype(State.*(std::get<I>(Fields).Member))>>(Values[I])), ...);
+		}
+
+		template <size_t... I>
+		static constexpr std::array<FQFieldLayout, NumFields> LayoutImpl(std::index_sequence<I...>)
+		{
+			return {{ FQFieldLayout{ std::get<I>(Fields).Name, GetShift<I>(), std::get<I>(Fields).GetBits(), std::get<I>(Fields).Min, std::get<I>(Fields).Max }... }};
+		}
+	};
+
+	template <typename SchemaType>
+	FQKeyLayout MakeKeyLayout()
+	{
+		static constexpr auto Layout = SchemaType::GetLayout();
+		return { Layout.data(), Layout.size() };
+	}
+}
@@ -0,0 +1,228 @@
+#pragma once
+
+#include "QCore/QCoreTypes.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <type_traits>
+
+
+namespace QCore
+{
+	class FQStateIndex;
+
+	enum class ETableBackend : uint8_t
+	{
+		Map,	// FQMapTable - hashed, only holds visited states
+		Dense,	// FQDenseTable - flat row array indexed by the packed key or a FQStateIndex
+		Sharded,	// FQShardedTable - concurrent hashed table, AtomicFloat only
+		Overlay		// FQOverlayTable - private copy-on-write rows over a shared read-only FQTableView
+	};
+
+	/* Which row a memory-capped table gives up for a new one */
+	enum class EQEvictionPolicy : uint8_t
+	{
+		Clock,			// approximate LRU - rows used since the clock hand last passed them get a second chance
+		LeastVisited	// fewest visit counts among the next EvictionSamples rows (Clock without visit counts)
+	};
+
+	constexpr int32_t EvictionSamples = 8;
+
+	/*
+	 * Row handle - what a single table probe hands back
+	 * A contiguous span over the row's NumActions values; GetData() is the full RowWidth block
+	 * (padding included) for the row kernels. Empty (false) when the row is missing.
+	 */
+	template <typename ValueType>
+	class TQRow
+	{
+	public:
+		TQRow() = default;
+		TQRow(ValueType* InData, const int32_t InNum) : Data(InData), NumValues(InNum) {}
+
+		template <typename OtherType, typename = std::enable_if_t<std::is_convertible_v<OtherType*, ValueType*>>>
+		TQRow(const TQRow<OtherType>& Other) : Data(Other.GetData()), NumValues(Other.Num()) {}
+
+		explicit operator bool() const { return Data != nullptr; }
+		bool operator==(const TQRow& Other) const { return Data == Other.Data; }
+
+		ValueType* GetData() const { return Data; }
+		int32_t Num() const { return NumValues; }
+		ValueType& operator[](const int32_t Action) const { return Data[Action]; }
+
+		ValueType* begin() const { return Data; }
+		ValueType* end() const { return Data + NumValues; }
+
+	private:
+		ValueType* Data = nullptr;
+		int32_t NumValues = 0;
+	};
+
+	using FQRow = TQRow<float>;
+	using FQConstRow = TQRow<const float>;
+	using FQRow16 = TQRow<int16_t>;
+	using FQConstRow16 = TQRow<const int16_t>;
+	using FQAtomicRow = TQRow<std::atomic<float>>;
+	using FQConstAtomicRow = TQRow<const std::atomic<float>>;
+
+	template <typename ValueType> struct TQValueType;
+	template <> struct TQValueType<float> { static constexpr EQValueType Value = EQValueType::Float; };
+	template <> struct TQValueType<int16_t> { static constexpr EQValueType Value = EQValueType::Int16; };
+	template <> struct TQValueType<std::atomic<float>> { static constexpr EQValueType Value = EQValueType::AtomicFloat; };
+
+
+	/*
+	 * Q table interface
+	 * Rows are RowWidth values: NumActions values followed by padding. New rows start at 0.
+	 * Every lookup is one probe that returns a row handle; use the handle rather than looking the key up again.
+	 * Non-const lookups hand out rows that may be written; read through a const table where nothing is written
+	 * (an Overlay table copies a shared row on its first non-const lookup).
+	 * Row handles stay valid until the row is removed or the table is emptied. On a memory-capped table an insert
+	 * may evict any row except the one returned by the lookup just before it.
+	 *
+	 * Float tables hand out FQRow, Int16 tables FQRow16 (Q = stored value * GetValueScale()), AtomicFloat
+	 * tables FQAtomicRow; asking for another type gives an empty handle.
+	 * LoadRow/StoreRow/ForEachRow work in floats for any value type.
+	 */
+	class IQTable
+	{
+	public:
+		IQTable(const int32_t InNumActions, const EQValueType InValueType = EQValueType::Float, const float InValueScale = 1.f)
+			: NumActions(InNumActions)
+			, StoredType(InValueType)
+			, ValueScale(InValueScale)
+		{
+		}
+		virtual ~IQTable() = default;
+
+		virtual bool Contains(FQKey Key) const = 0;
+		virtual void* FindOrAddRowData(FQKey Key) = 0; // the existing row, or a new default row
+		virtual const void* FindRowData(FQKey Key) const = 0; // nullptr if missing
+		virtual void* FindMutableRowData(FQKey Key) { return const_cast<void*>(FindRowData(Key)); } // nullptr if missing, the row may be written
+
+		virtual size_t Num() const = 0;
+		virtual void Empty() = 0;
+		virtual size_t GetAllocatedSize() const = 0;
+		virtual ETableBackend GetBackend() const = 0;
+
+		/* Visits every stored row - Func(Key, Row), Row as RowWidth floats (dequantized for Int16) */
+		virtual void ForEachRow(const std::function<void(FQKey, const float*)>& Func) const = 0;
+
+		/* --- Typed row handles (hot path) --- */
+		template <typename RowValueType>
+		TQRow<RowValueType> FindOrAddRowAs(const FQKey Key)
+		{
+			void* Data = FindOrAddRowData(Key);
+			return { IsValueType<RowValueType>() ? static_cast<RowValueType*>(Data) : nullptr, NumActions };
+		}
+
+		template <typename RowValueType>
+		TQRow<RowValueType> FindRowAs(const FQKey Key)
+		{
+			return { IsValueType<RowValueType>() ? static_cast<RowValueType*>(FindMutableRowData(Key)) : nullptr, NumActions };
+		}
+
+		template <typename RowValueType>
+		TQRow<const RowValueType> FindRowAs(const FQKey Key) const
+		{
+			return { IsValueType<RowValueType>() ? static_cast<const RowValueType*>(FindRowData(Key)) : nullptr, NumActions };
+		}
+
+		/* Same probe, also hands back the row's visit counts (nullptr when the table has none) */
+		template <typename RowValueType>
+		TQRow<RowValueType> FindOrAddRowAs(const FQKey Key, uint32_t*& OutCounts)
+		{
+			void* Data = FindOrAddCountedRowData(Key, OutCounts);
+			if (!IsValueType<RowValueType>()) OutCounts = nullptr;
+			return { IsValueType<RowValueType>() ? static_cast<RowValueType*>(Data) : nullptr, NumActions };
+		}
+
+		template <typename RowValueType>
+		TQRow<RowValueType> FindRowAs(const FQKey Key, uint32_t*& OutCounts)
+		{
+			void* Data = FindMutableCountedRowData(Key, OutCounts);
+			if (!IsValueType<RowValueType>()) OutCounts = nullptr;
+			return { IsValueType<RowValueType>() ? static_cast<RowValueType*>(Data) : nullptr, NumActions };
+		}
+
+		FQRow FindOrAddRow(const FQKey Key) { return FindOrAddRowAs<float>(Key); }
+		FQRow FindRow(const FQKey Key) { return FindRowAs<float>(Key); }
+		FQConstRow FindRow(const FQKey Key) const { return FindRowAs<float>(Key); }
+
+		/* --- Value-type independent row access (persistence, merging, tools) --- */
+		bool LoadRow(FQKey Key, float* OutRow) const; // RowWidth floats, false if missing
+		void StoreRow(FQKey Key, const float* Row); // NumActions floats, adds the row if missing (quantized for Int16)
+
+		/* --- Visit counts N(s,a) (optional) ---
+		 * NumActions uint32 per row in a companion array beside the values, reached through the same probe as the row
+		 * and stable like row handles. Map and Dense float/int16 tables support them, AtomicFloat tables don't. */
+		virtual bool EnableVisitCounts() { return false; } // allocates the counts (0 for existing rows), false if unsupported
+		bool HasVisitCounts() const { return bVisitCounts; }
+		virtual void* FindOrAddCountedRowData(FQKey Key, uint32_t*& OutCounts) { OutCounts = nullptr; return FindOrAddRowData(Key); }
+		virtual const void* FindCountedRowData(FQKey Key, const uint32_t*& OutCounts) const { OutCounts = nullptr; return FindRowData(Key); }
+		virtual void* FindMutableCountedRowData(FQKey Key, uint32_t*& OutCounts)
+		{
+			const uint32_t* Counts;
+			void* Data = const_cast<void*>(FindCountedRowData(Key, Counts));
+			OutCounts = const_cast<uint32_t*>(Counts);
+			return Data;
+		}
+
+		uint32_t GetVisitCount(FQKey Key, int32_t Action) const; // 0 for a missing row or without counts
+
+		/* --- Memory cap (optional) ---
+		 * Once the rows reach the cap every insert evicts one row first (evicted rows read as defaults again).
+		 * Map tables support it; Dense tables are fixed-size and Sharded rows are read without locks. */
+		virtual bool SetMemoryLimit(size_t Bytes, EQEvictionPolicy /*Policy*/ = EQEvictionPolicy::Clock) { return Bytes == 0; } // 0 - no cap, false if unsupported
+		virtual size_t GetMaxRows() const { return 0; } // 0 - unlimited
+		virtual uint64_t GetNumEvicted() const { return 0; }
+		void StoreVisitCounts(FQKey Key, const uint32_t* Counts); // NumActions counts, adds the row if missing, ignored without counts
+
+		int32_t GetNumActions() const { return NumActions; }
+		EQValueType GetValueType() const { return StoredType; }
+		float GetValueScale() const { return ValueScale; }
+
+	protected:
+		template <typename RowValueType>
+		bool IsValueType() const { return TQValueType<std::remove_const_t<RowValueType>>::Value == StoredType; }
+
+		int32_t NumActions;
+		EQValueType StoredType;
+		float ValueScale;
+		bool bVisitCounts = false;
+	};
+
+
+	/* Largest key space the Dense backend will allocate up front (rows * RowWidth floats) */
+	constexpr uint64_t MaxDenseKeys = uint64_t(1) << 24;
+	inline bool CanUseDenseTable(const uint64_t NumKeys) { return NumKeys != 0 && NumKeys <= MaxDenseKeys; }
+
+	/* NumKeys is the schema's key space (TQStateSchema::NumKeys), only used by the Dense backend.
+	 * Int16 tables quantize [-ValueRange, ValueRange] with a scale of ValueRange / 32767.
+	 * AtomicFloat tables are Dense (FQAtomicDenseTable) or Sharded (FQShardedTable), Sharded needs AtomicFloat.
+	 * Returns nullptr for Dense when CanUseDenseTable(NumKeys) is false, for Overlay (see FQOverlayTable) and for any other mismatch. */
+	std::unique_ptr<IQTable> MakeTable(ETableBackend Backend, int32_t NumActions, uint64_t NumKeys,
+		EQValueType ValueType = EQValueType::Float, float ValueRange = DefaultQuantizedRange);
+
+	/* Same, but a Dense table gets one row per state of StateIndex (the discretizer's reachable states) instead of
+	 * one per key. Null or invalid StateIndex - nullptr for Dense */
+	std::unique_ptr<IQTable> MakeTable(ETableBackend Backend, int32_t NumActions, const std::shared_ptr<const FQStateIndex>& StateIndex,
+		EQValueType ValueType = EQValueType::Float, float ValueRange = DefaultQuantizedRange);
+
+	/* QManager merge: rows missing in Into are copied, shared rows are averaged per action */
+	void MergeAverage(IQTable& Into, const IQTable& From);
+
+	/* Accuracy of Other against Reference over the rows both hold (e.g. an Int16 table trained beside a Float one) */
+	struct FQTableComparison
+	{
+		size_t NumCompared = 0;
+		size_t NumMissing = 0;		// Reference rows Other doesn't have
+		size_t NumGreedyMatches = 0;	// rows where both pick the same greedy action
+		float MaxAbsError = 0.f;
+		float MeanAbsError = 0.f;
+
+		float GetGreedyAgreement() const { return NumCompared ? static_cast<float>(NumGreedyMatches) / static_cast<float>(NumCompared) : 1.f; }
+	};
+
+	FQTableComparison CompareTables(const IQTable& Reference, const IQTable& Other);
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "QCore/QPersistence.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace QCore
+{
+	class FQDiscretizer;
+
+	/*
+	 * Read-only Q table over a binary table file saved with aligned rows (WriteTableBinary(..., true))
+	 * Rows are used in place: the values section is RowAlignment aligned and every row keeps its padding lanes,
+	 * so FindRowData hands the row kernels a pointer into the file. The only allocation is a uint32 open-addressing
+	 * index over the keys (~8 bytes per row). Nothing is ever written, so one view is shared by any number of
+	 * tables (FQOverlayTable) and threads without locking.
+	 * Owner keeps the bytes alive (a mapping, a buffer) for as long as the view exists.
+	 */
+	class FQTableView
+	{
+	public:
+		static constexpr uint32_t NoRow = ~uint32_t(0);
+
+		/* Data must be RowAlignment aligned and hold a valid aligned-rows file for Layout, IsValid() false otherwise */
+		FQTableView(const char* Data, size_t Size, const FQKeyLayout& Layout, std::shared_ptr<const void> InOwner = nullptr);
+
+		bool IsValid() const { return bValid; }
+
+		uint32_t FindRowIndex(FQKey Key) const; // NoRow if missing
+		const void* GetRowData(const uint32_t Row) const { return RowsData + static_cast<size_t>(Row) * RowBytes; } // RowWidth values
+		const uint32_t* GetVisitCounts(uint32_t Row) const; // NumActions counts, nullptr without counts
+		FQKey GetKey(uint32_t Row) const;
+
+		const void* FindRowData(const FQKey Key) const
+		{
+			const uint32_t Row = FindRowIndex(Key);
+			return Row != NoRow ? GetRowData(Row) : nullptr;
+		}
+
+		/* Func(Key, Row), Row as RowWidth floats (dequantized for Int16) */
+		void ForEachRow(const std::function<void(FQKey, const float*)>& Func) const;
+
+		/* Every stored key is already bucketed by Discretizer - the rows can be used as they are */
+		bool IsDiscretizedBy(const FQDiscretizer& Discretizer) const;
+
+		size_t Num() const { return Info.NumRows; }
+		int32_t GetNumActions() const { return Info.NumActions; }
+		EQValueType GetValueType() const { return Info.ValueType; }
+		float GetValueScale() const { return Info.ValueScale; }
+		bool HasVisitCounts() const { return Info.bVisitCounts; }
+		size_t GetIndexSize() const { return Index.capacity() * sizeof(uint32_t); } // heap bytes, the rows stay in the file
+
+	private:
+		std::shared_ptr<const void> Owner;
+		const char* Data = nullptr;
+		const char* RowsData = nullptr;
+		size_t RowBytes = 0;
+		FQTableFileInfo Info;
+		std::vector<uint32_t> Index; // power of two slots, row index or NoRow
+		bool bValid = false;
+	};
+
+	/* Maps a table file read-only (mmap where available, otherwise reads it into an aligned buffer).
+	 * nullptr if the file is missing or not a valid aligned-rows file for Layout. */
+	std::shared_ptr<const FQTableView> MapTableFile(const std::string& Path, const FQKeyLayout& Layout);
+}
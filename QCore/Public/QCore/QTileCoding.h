@@ -0,0 +1,100 @@
+#pragma once
+
+#include "QCore/QLearner.h"
+#include <string>
+#include <vector>
+
+
+namespace QCore
+{
+	/* One input feature: values are clamped to [Min, Max], which is cut into Resolution tiles (bools: 0, 1, 1) */
+	struct FQTileDimension
+	{
+		float Min;
+		float Max;
+		float Resolution;
+	};
+
+	struct FQTileCodingConfig
+	{
+		int32_t NumTilings = 8;			// overlapping grids, each offset by a fraction of a tile - finer generalization
+		uint32_t MemorySize = 1 << 14;	// hashed tiles (power of two), NumActions weights each - 512 KB at the default
+	};
+
+	/*
+	 * Tile coding - each tiling maps a feature vector to one tile of an offset grid, hashed into MemorySize slots
+	 * Offsets follow the asymmetric (1, 3, 5, ...) displacement, so tilings don't line up along the diagonals.
+	 * Nearby inputs share most of their tiles, which is where the generalization comes from.
+	 */
+	class FQTileCoder
+	{
+	public:
+		static constexpr int32_t MaxTilings = 32;
+		static constexpr int32_t MaxDimensions = 16;
+
+		FQTileCoder(std::vector<FQTileDimension> InDimensions, const FQTileCodingConfig& InConfig);
+
+		bool IsValid() const { return bValid; } // tilings, dimensions and memory size within limits
+		void GetActiveTiles(const float* Features, uint32_t* OutTiles) const; // GetNumDimensions() features -> GetNumTilings() tiles
+
+		int32_t GetNumTilings() const { return Config.NumTilings; }
+		int32_t GetNumDimensions() const { return static_cast<int32_t>(Dimensions.size()); }
+		uint32_t GetMemorySize() const { return Config.MemorySize; }
+		const std::vector<FQTileDimension>& GetDimensions() const { return Dimensions; }
+
+	private:
+		std::vector<FQTileDimension> Dimensions;
+		std::vector<float> Scales; // per dimension, tiles per unit
+		std::vector<int32_t> Offsets; // [Tiling * NumDimensions + Dimension], in 1/NumTilings of a tile
+		FQTileCodingConfig Config;
+		bool bValid = false;
+	};
+
+	/*
+	 * Linear Q-learning over tile-coded features - the middle tier between the exact table and the DQN server
+	 * Q(s, a) is the sum of the active tiles' weights for a; every tile holds a padded row of per-action weights,
+	 * so all actions are evaluated together with one SIMD row add per tiling (SumRows) and one max reduction.
+	 * Updates spread alpha / NumTilings over the active tiles: Q(s,a) moves by alpha * TD error, as in the table.
+	 * Memory is fixed at construction, nothing allocates per step. Single-threaded, own random stream.
+	 */
+	class FQTileLearner
+	{
+	public:
+		FQTileLearner(int32_t InNumActions, std::vector<FQTileDimension> Dimensions, const FQTileCodingConfig& Coding = {});
+
+		FQLearnerConfig Config; // LearningRate, ExplorationRate, DiscountFactor (traces and visit counts are table-only)
+
+		bool IsValid() const { return Coder.IsValid() && NumActions > 0 && NumActions <= RowWidth; }
+
+		int32_t ChooseAction(const float* Features);
+		int32_t ChooseGreedyAction(const float* Features) const;
+		void UpdateQValue(const float* PrevFeatures, int32_t ActionTaken, float Reward, const float* NewFeatures);
+
+		float GetQValue(const float* Features, int32_t Action) const;
+		void GetQValues(const float* Features, float* OutRow) const; // RowWidth floats, 32-byte aligned, padding lanes RowPadding
+
+		void SeedRandom(uint64_t Seed, uint64_t Stream = 0) { Rng.SetSeed(Seed, Stream); }
+		void ResetWeights();
+
+		const FQTileCoder& GetCoder() const { return Coder; }
+		int32_t GetNumActions() const { return NumActions; }
+		const float* GetWeights() const { return Weights.data(); } // [Tile * RowWidth + Action]
+		float* GetWeights() { return Weights.data(); }
+		size_t GetAllocatedSize() const { return Weights.capacity() * sizeof(float); }
+
+	private:
+		void SumActiveRows(const uint32_t* Tiles, float* OutRow) const;
+
+		FQTileCoder Coder;
+		int32_t NumActions;
+		FQRowArray Weights; // padding lanes hold RowPadding, so summed rows stay padded
+		FQRandom Rng;
+	};
+
+	/*
+	 * Binary weights file: "QTIL", version, actions, tilings, memory size, dimensions (Min, Max, Resolution each),
+	 * then MemorySize * actions weights (little-endian). Read only loads into a learner with the same coding.
+	 */
+	std::string WriteTileWeightsBinary(const FQTileLearner& Learner);
+	bool ReadTileWeightsBinary(FQTileLearner& Learner, const char* Data, size_t Size);
+}
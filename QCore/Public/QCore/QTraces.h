@@ -0,0 +1,65 @@
+#pragma once
+
+#include "QCore/QCoreTypes.h"
+#include <array>
+
+
+namespace QCore
+{
+	/* Traces kept at most - with gamma * lambda = 0.855 a trace falls below 0.01 after ~30 steps */
+	constexpr int32_t MaxEligibilityTraces = 64;
+
+	/*
+	 * Sparse eligibility traces for Watkins Q(lambda)
+	 * Only recently visited (state, action) pairs are held, in a fixed-size array (no allocation, ever).
+	 * Replacing traces: marking a pair sets it to 1. When full, the weakest trace is dropped.
+	 */
+	class FQTraceList
+	{
+	public:
+		struct FTrace
+		{
+			FQKey Key;
+			int32_t Action;
+			float Eligibility;
+		};
+
+		void Mark(const FQKey Key, const int32_t Action)
+		{
+			int32_t Weakest = 0;
+			for (int32_t Index = 0; Index < NumTraces; ++Index)
+			{
+				if (Traces[Index].Key == Key && Traces[Index].Action == Action)
+				{
+					Traces[Index].Eligibility = 1.f;
+					return;
+				}
+				if (Traces[Index].Eligibility < Traces[Weakest].Eligibility) Weakest = Index;
+			}
+
+			if (NumTraces < MaxEligibilityTraces) Traces[NumTraces++] = { Key, Action, 1.f };
+			else Traces[Weakest] = { Key, Action, 1.f };
+		}
+
+		/* Scales every trace by Decay (gamma * lambda) and drops the ones below Threshold */
+		void Decay(const float Decay, const float Threshold)
+		{
+			for (int32_t Index = 0; Index < NumTraces; )
+			{
+				Traces[Index].Eligibility *= Decay;
+				if (Traces[Index].Eligibility < Threshold) Traces[Index] = Traces[--NumTraces];
+				else ++Index;
+			}
+		}
+
+		void Empty() { NumTraces = 0; }
+
+		int32_t Num() const { return NumTraces; }
+		const FTrace* begin() const { return Traces.data(); }
+		const FTrace* end() const { return Traces.data() + NumTraces; }
+
+	private:
+		std::array<FTrace, MaxEligibilityTraces> Traces;
+		int32_t NumTraces = 0;
+	};
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "QCore/QReplayBuffer.h"
+#include "QCore/QStateSchema.h"
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+
+namespace QCore
+{
+	struct FQStateAction
+	{
+		FQKey State;
+		int32_t Action;
+
+		bool operator==(const FQStateAction& Other) const { return State == Other.State && Action == Other.Action; }
+	};
+
+	struct FQStateActionHash
+	{
+		size_t operator()(const FQStateAction& Pair) const { return HashKey(Pair.State * RowWidth + static_cast<uint64_t>(Pair.Action)); }
+	};
+
+	/* Successors kept per (state, action) - past this the least seen one is replaced */
+	constexpr int32_t MaxDynaSuccessors = 4;
+
+	/*
+	 * Learned transition model (Dyna-Q planning, prioritized sweeping)
+	 * Per observed (state, action): visit count, running mean reward and up to MaxDynaSuccessors next states
+	 * with their counts. Sample picks an observed pair uniformly and a successor in proportion to its count.
+	 * With a capacity, a new pair past it takes the slot of the oldest pair.
+	 */
+	class FQDynaModel
+	{
+	public:
+		explicit FQDynaModel(size_t InCapacity = 0) : Capacity(InCapacity) {} // 0 - unbounded
+
+		struct FSuccessor
+		{
+			FQKey State;
+			uint32_t Count;
+		};
+
+		struct FEntry
+		{
+			FQStateAction Pair;
+			float MeanReward = 0.f;
+			uint32_t Count = 0;
+			int32_t NumSuccessors = 0;
+			std::array<FSuccessor, MaxDynaSuccessors> Successors;
+		};
+
+		/* (Pair -> successor) links an Observe removed: a replaced successor, or every successor of an evicted pair */
+		struct FDroppedLinks
+		{
+			FQStateAction Pair;
+			int32_t NumStates = 0;
+			std::array<FQKey, MaxDynaSuccessors> States;
+		};
+
+		void Observe(const FQTransition& Transition, FDroppedLinks* OutDropped = nullptr);
+		bool Sample(FQRandom& Rng, FQTransition& OutTransition) const; // false if nothing observed yet
+		const FEntry* Find(const FQStateAction& Pair) const;
+
+		size_t Num() const { return Entries.size(); } // observed (state, action) pairs
+		size_t GetCapacity() const { return Capacity; }
+		void Empty() { Entries.clear(); Index.clear(); NextEvicted = 0; }
+
+	private:
+		std::vector<FEntry> Entries; // flat for uniform sampling
+		std::unordered_map<FQStateAction, uint32_t, FQStateActionHash> Index;
+		size_t Capacity;
+		size_t NextEvicted = 0; // slots are reused in insertion order once full
+	};
+}
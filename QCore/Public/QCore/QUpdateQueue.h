@@ -0,0 +1,63 @@
+#pragma once
+
+#include "QCore/QLearner.h"
+#include <vector>
+
+
+namespace QCore
+{
+	class FQPrioritizedSweeper;
+
+	/*
+	 * Deferred TD updates
+	 * Transitions are pushed during the frame (no table access) and applied together by one Flush,
+	 * grouped by table and sorted by state key so consecutive updates hit neighbouring rows - across every learner
+	 * sharing the table, updates of one state keep their push order.
+	 * Storage is reserved once; Push fails when the queue is full so the caller can update inline.
+	 * Learners using traces (TraceDecay > 0) keep their push order, their updates are order dependent.
+	 * max Q(s') of every other update on a Float table is read up front by one batched MaxRows call; an update whose s'
+	 * row an earlier update of the flush writes (or on a table that may evict) reads it inline instead, as before.
+	 * A transition pushed with a sweeper is observed by it right after its update, as an inline update would be.
+	 * A learner must not be destroyed with transitions still queued.
+	 */
+	class FQUpdateQueue
+	{
+	public:
+		explicit FQUpdateQueue(size_t Capacity = 256);
+
+		bool Push(FQLearner& Learner, FQKey PrevState, int32_t ActionTaken, float Reward, FQKey NewState, FQPrioritizedSweeper* Sweeper = nullptr);
+		bool PushEndEpisode(FQLearner& Learner); // FQLearner::EndEpisode, applied in order after the learner's earlier pushes
+
+		/* Applies and clears everything queued, returns the number of TD updates applied */
+		size_t Flush();
+
+		size_t Num() const { return Entries.size(); }
+		size_t GetCapacity() const { return Entries.capacity(); }
+		bool IsEmpty() const { return Entries.empty(); }
+
+	private:
+		struct FEntry
+		{
+			FQLearner* Learner;
+			FQPrioritizedSweeper* Sweeper;	// optional, observes the transition after its update
+			const IQTable* Table;	// group key
+			bool bKeepOrder;		// learner uses traces
+			FQKey PrevState;
+			FQKey NewState;
+			int32_t ActionTaken;	// EndEpisodeAction marks an EndEpisode entry
+			float Reward;
+			uint32_t Sequence;		// push order, tie-break + order for trace learners
+			uint32_t FutureSlot;	// index into FutureMax, NoFutureSlot - read s' inline
+		};
+
+		static constexpr int32_t EndEpisodeAction = -1;
+		static constexpr uint32_t NoFutureSlot = ~uint32_t(0);
+
+		bool PushEntry(const FEntry& Entry);
+		void GatherMaxFutureQ(); // Entries sorted, before any update
+
+		std::vector<FEntry> Entries;
+		std::vector<const float*> FutureRows; // s' rows of the batched updates
+		std::vector<float> FutureMax;
+	};
+}
@@ -0,0 +1,103 @@
+#include "QTest.h"
+#include "QTestState.h"
+#include "QCore/QDiscretizer.h"
+#include "QCore/QTable.h"
+
+using namespace QCore;
+
+QTEST(Discretizer, HealthBands)
+{
+	FQDiscretizer Discretizer(MakeKeyLayout<FTestState::Schema>());
+	QCHECK(Discretizer.IsIdentity());
+	QCHECK(Discretizer.Apply(MakeState(37, 99, 3).ToKey()) == MakeState(37, 99, 3).ToKey());
+
+	const int32_t Edges[] = { 20, 40, 60, 80 };
+	QCHECK(Discretizer.SetBucketEdges("HealthPercent", Edges, 4));
+	QCHECK(Discretizer.SetBucketEdges("TargetHealthPercent", Edges, 4));
+
+	const FTestState Out = FTestState::Schema::Unpack(Discretizer.Apply(MakeState(37, 99, 3, false, true).ToKey()));
+	QCHECK(Out.HealthPercent == 20);
+	QCHECK(Out.TargetHealthPercent == 80);
+	QCHECK(Out.HealsLeft == 3 && Out.bIsTargetAttacking && !Out.bWasHitRecently); // untouched fields
+
+	QCHECK(Discretizer.Apply(MakeState(0, 19, 0).ToKey()) == MakeState(0, 0, 0).ToKey());
+	QCHECK(Discretizer.Apply(MakeState(20, 100, 0).ToKey()) == MakeState(20, 80, 0).ToKey());
+	QCHECK(Discretizer.CountReachableKeys() == 5 * 5 * 8 * 16);
+
+	QCHECK(Discretizer.SetBucketEdges("HealthPercent", nullptr, 0)); // cleared
+	QCHECK(Discretizer.Apply(MakeState(37, 99, 3).ToKey()) == MakeState(37, 80, 3).ToKey());
+}
+
+QTEST(Discretizer, SameBucketsIgnoresOrder)
+{
+	const int32_t Edges[] = { 20, 40, 60, 80 };
+	const int32_t Heals[] = { 2 };
+	FQDiscretizer A(MakeKeyLayout<FTestState::Schema>());
+	FQDiscretizer B(MakeKeyLayout<FTestState::Schema>());
+	QCHECK(A.HasSameBuckets(B));
+
+	A.SetBucketEdges("HealthPercent", Edges, 4);
+	A.SetBucketEdges("HealsLeft", Heals, 1);
+	QCHECK(!A.HasSameBuckets(B));
+	B.SetBucketEdges("HealsLeft", Heals, 1);
+	B.SetBucketEdges("HealthPercent", Edges, 4);
+	QCHECK(A.HasSameBuckets(B));
+
+	B.SetBucketEdges("HealthPercent", Edges, 3);
+	QCHECK(!A.HasSameBuckets(B));
+}
+
+QTEST(Discretizer, RejectsInvalidEdges)
+{
+	FQDiscretizer Discretizer(MakeKeyLayout<FTestState::Schema>());
+	const int32_t Unsorted[] = { 40, 20 };
+	const int32_t AtMin[] = { 0, 50 };
+	const int32_t AboveMax[] = { 50, 101 };
+	const int32_t Valid[] = { 50 };
+
+	QCHECK(!Discretizer.SetBucketEdges("HealthPercent", Unsorted, 2));
+	QCHECK(!Discretizer.SetBucketEdges("HealthPercent", AtMin, 2));
+	QCHECK(!Discretizer.SetBucketEdges("HealthPercent", AboveMax, 2));
+	QCHECK(!Discretizer.SetBucketEdges("NoSuchField", Valid, 1));
+	QCHECK(Discretizer.IsIdentity());
+}
+
+QTEST(Discretizer, DiscretizeTableAveragesCollisions)
+{
+	FQDiscretizer Discretizer(MakeKeyLayout<FTestState::Schema>());
+	const int32_t Edges[] = { 50 };
+	Discretizer.SetBucketEdges("HealthPercent", Edges, 1);
+
+	const std::unique_ptr<IQTable> Table = MakeTable(ETableBackend::Map, TestNumActions, 0);
+	Table->FindOrAddRow(MakeState(10, 0, 0).ToKey())[0] = 1.f;
+	Table->FindOrAddRow(MakeState(30, 0, 0).ToKey())[0] = 3.f;
+	Table->FindOrAddRow(MakeState(70, 0, 0).ToKey())[2] = 5.f;
+
+	DiscretizeTable(*Table, Discretizer);
+	QCHECK(Table->Num() == 2);
+	QCHECK_NEAR(Table->FindRow(MakeState(0, 0, 0).ToKey())[0], 2.f, 1e-6f);
+	QCHECK_NEAR(Table->FindRow(MakeState(50, 0, 0).ToKey())[2], 5.f, 1e-6f);
+	QCHECK(Table->FindRow(MakeState(50, 0, 0).ToKey())[TestNumActions] == RowPadding);
+}
+
+QTEST(Discretizer, DiscretizeTableSumsVisitCounts)
+{
+	FQDiscretizer Discretizer(MakeKeyLayout<FTestState::Schema>());
+	const int32_t Edges[] = { 50 };
+	Discretizer.SetBucketEdges("HealthPercent", Edges, 1);
+
+	const std::unique_ptr<IQTable> Table = MakeTable(ETableBackend::Map, TestNumActions, 0);
+	QCHECK(Table->EnableVisitCounts());
+	const uint32_t Low[TestNumActions] = { 3, 1 };
+	const uint32_t Lower[TestNumActions] = { 2, 0, 4 };
+	Table->StoreVisitCounts(MakeState(10, 0, 0).ToKey(), Low);
+	Table->StoreVisitCounts(MakeState(30, 0, 0).ToKey(), Lower);
+	Table->StoreVisitCounts(MakeState(70, 0, 0).ToKey(), Low);
+
+	DiscretizeTable(*Table, Discretizer);
+	QCHECK(Table->Num() == 2);
+	QCHECK(Table->GetVisitCount(MakeState(0, 0, 0).ToKey(), 0) == 5);
+	QCHECK(Table->GetVisitCount(MakeState(0, 0, 0).ToKey(), 1) == 1);
+	QCHECK(Table->GetVisitCount(MakeState(0, 0, 0).ToKey(), 2) == 4);
+	QCHECK(Table->GetVisitCount(MakeState(50, 0, 0).ToKey(), 0) == 3);
+}
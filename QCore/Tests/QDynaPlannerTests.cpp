@@ -0,0 +1,227 @@
+#include "QTest.h"
+#include "QTestState.h"
+#include "QCore/QDynaPlanner.h"
+#include <chrono>
+
+using namespace QCore;
+
+QTEST(DynaModel, TracksMeanRewardAndSuccessorCounts)
+{
+	FQDynaModel Model;
+	Model.Observe({ 1, 2, 0, 1.f });
+	Model.Observe({ 1, 2, 0, 3.f });
+	Model.Observe({ 1, 3, 0, 2.f });
+	for (FQKey Next = 10; Next < 10 + MaxDynaSuccessors; ++Next) Model.Observe({ 1, Next, 0, 2.f });
+
+	const FQDynaModel::FEntry* Entry = Model.Find({ 1, 0 });
+	QCHECK(Entry && Model.Num() == 1 && !Model.Find({ 1, 1 }));
+	QCHECK(Entry->Count == 3 + MaxDynaSuccessors);
+	QCHECK_NEAR(Entry->MeanReward, 2.f, 1e-5f);
+	QCHECK(Entry->NumSuccessors == MaxDynaSuccessors);
+	QCHECK(Entry->Successors[0].State == 2 && Entry->Successors[0].Count == 2); // most seen successor survives
+
+	FQRandom Rng(3);
+	FQTransition Sampled;
+	for (int32_t Draw = 0; Draw < 50; ++Draw)
+	{
+		QCHECK(Model.Sample(Rng, Sampled));
+		QCHECK(Sampled.PrevState == 1 && Sampled.ActionTaken == 0 && Sampled.NewState != 3);
+	}
+}
+
+QTEST(DynaModel, CapacityEvictsTheOldestPair)
+{
+	FQDynaModel Model(2);
+	FQDynaModel::FDroppedLinks Dropped;
+	Model.Observe({ 1, 2, 0, 1.f }, &Dropped);
+	Model.Observe({ 1, 3, 0, 1.f }, &Dropped);
+	Model.Observe({ 4, 5, 1, 1.f }, &Dropped);
+	QCHECK(Dropped.NumStates == 0);
+
+	Model.Observe({ 6, 7, 0, 1.f }, &Dropped);
+	QCHECK(Model.Num() == 2 && !Model.Find({ 1, 0 }) && Model.Find({ 4, 1 }) && Model.Find({ 6, 0 }));
+	QCHECK(Dropped.Pair == (FQStateAction{ 1, 0 }) && Dropped.NumStates == 2);
+	QCHECK(Dropped.States[0] == 2 && Dropped.States[1] == 3);
+}
+
+QTEST(DynaPlanner, PlanningPropagatesRewardOnPublish)
+{
+	FQLearnerConfig Config;
+	Config.LearningRate = 0.5f;
+	Config.DiscountFactor = 0.9f;
+	const std::unique_ptr<IQTable> Live = MakeTable(ETableBackend::Dense, TestNumActions, FTestState::Schema::NumKeys);
+	Live->FindOrAddRow(1);
+	Live->FindOrAddRow(2);
+
+	FQDynaPlanner Planner;
+	Planner.Config.MaxUnpublishedUpdates = 100;
+	Planner.Start(*Live, Config, false);
+	Planner.Observe({ 1, 2, 0, 0.f });
+	Planner.Observe({ 2, 3, 1, 10.f });
+	QCHECK(Planner.Publish(*Live) == 0);
+
+	QCHECK(Planner.Plan(1000) == 100); // staleness bound
+	QCHECK(Planner.Plan(1) == 0);
+	QCHECK(Live->FindRow(2)[1] == 0.f); // nothing reaches the live table before Publish
+
+	QCHECK(Planner.Publish(*Live) == 2);
+	QCHECK_NEAR(Live->FindRow(2)[1], 10.f, 1e-3f);
+	QCHECK_NEAR(Live->FindRow(1)[0], 9.f, 1e-2f);
+	QCHECK(Planner.GetNumPlanningUpdates() == 100 && Planner.GetModelSize() == 2);
+}
+
+QTEST(DynaPlanner, PublishKeepsRealUpdatesMadeMeanwhile)
+{
+	FQLearnerConfig Config;
+	const std::unique_ptr<IQTable> Live = MakeTable(ETableBackend::Map, TestNumActions, 0);
+	Live->FindOrAddRow(1);
+
+	FQDynaPlanner Planner;
+	Planner.Start(*Live, Config, false);
+	Planner.Observe({ 1, 1, 0, 1.f });
+	Planner.Publish(*Live);
+	Planner.Plan(1);
+	const float Planned = 0.1f; // alpha * (1 + gamma * 0 - 0)
+
+	Live->FindRow(1)[0] = 5.f; // real update on the game thread before the next Publish
+	Planner.Publish(*Live);
+	QCHECK_NEAR(Live->FindRow(1)[0], 5.f + Planned, 1e-5f);
+}
+
+QTEST(DynaPlanner, WorkerPlansInBackground)
+{
+	FQLearnerConfig Config;
+	Config.LearningRate = 0.5f;
+	const std::unique_ptr<IQTable> Live = MakeTable(ETableBackend::Map, TestNumActions, 0);
+	Live->FindOrAddRow(1);
+
+	FQDynaPlanner Planner;
+	Planner.Config.MaxUnpublishedUpdates = 256;
+	Planner.Start(*Live, Config);
+	QCHECK(Planner.IsRunning());
+	Planner.Observe({ 1, 1, 2, 1.f });
+
+	const std::chrono::steady_clock::time_point Deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (Live->FindRow(1)[2] < 5.f && std::chrono::steady_clock::now() < Deadline)
+	{
+		Planner.Publish(*Live);
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	Planner.Stop();
+
+	QCHECK(!Planner.IsRunning());
+	QCHECK(Live->FindRow(1)[2] >= 5.f); // converges towards 1 / (1 - gamma) = 20
+	QCHECK(Live->FindRow(1)[2] <= 20.f + 1e-3f);
+}
+
+QTEST(DynaWorker, FrameBudgetIsSharedRoundRobin)
+{
+	FQLearnerConfig Config;
+	const std::unique_ptr<IQTable> LiveA = MakeTable(ETableBackend::Map, TestNumActions, 0);
+	const std::unique_ptr<IQTable> LiveB = MakeTable(ETableBackend::Map, TestNumActions, 0);
+	LiveA->FindOrAddRow(1);
+	LiveB->FindOrAddRow(1);
+
+	FQDynaPlanner A, B, Idle;
+	A.Config.UpdatesPerBatch = B.Config.UpdatesPerBatch = 50;
+	A.Start(*LiveA, Config, false);
+	B.Start(*LiveB, Config, false);
+	Idle.Start(*LiveB, Config, false); // nothing observed, never plans
+	A.Observe({ 1, 1, 0, 1.f });
+	B.Observe({ 1, 1, 0, 1.f });
+	A.Publish(*LiveA);
+	B.Publish(*LiveB);
+
+	FQDynaWorker Worker(200);
+	Worker.Add(A);
+	Worker.Add(Idle);
+	Worker.Add(B);
+	QCHECK(Worker.PlanFrame() == 200); // budget bound, unused updates don't carry over
+	QCHECK(A.GetNumPlanningUpdates() == 100 && B.GetNumPlanningUpdates() == 100);
+
+	A.Config.MaxUnpublishedUpdates = 150; // A stops at its staleness bound, B takes the rest
+	QCHECK(Worker.PlanFrame() == 200);
+	QCHECK(A.GetNumPlanningUpdates() == 150 && B.GetNumPlanningUpdates() == 250);
+
+	Worker.Remove(B);
+	QCHECK(Worker.Num() == 2 && Worker.PlanFrame() == 0); // A waits for its Publish, Idle has nothing
+	A.Publish(*LiveA);
+	QCHECK(Worker.PlanFrame() == 150);
+}
+
+QTEST(DynaWorker, OneThreadPlansForEveryPlanner)
+{
+	FQLearnerConfig Config;
+	Config.LearningRate = 0.5f;
+	std::unique_ptr<IQTable> Live[3];
+	FQDynaPlanner Planners[3];
+	FQDynaWorker Worker(512);
+	for (int32_t Index = 0; Index < 3; ++Index)
+	{
+		Live[Index] = MakeTable(ETableBackend::Map, TestNumActions, 0);
+		Live[Index]->FindOrAddRow(1);
+		Planners[Index].Config.MaxUnpublishedUpdates = 256;
+		Planners[Index].Start(*Live[Index], Config, false);
+		Planners[Index].Observe({ 1, 1, 2, 1.f });
+		Worker.Add(Planners[Index]);
+	}
+	Worker.Start();
+	QCHECK(Worker.IsRunning());
+
+	const auto Converged = [&Live]() { return Live[0]->FindRow(1)[2] >= 5.f && Live[1]->FindRow(1)[2] >= 5.f && Live[2]->FindRow(1)[2] >= 5.f; };
+	const std::chrono::steady_clock::time_point Deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (!Converged() && std::chrono::steady_clock::now() < Deadline)
+	{
+		for (int32_t Index = 0; Index < 3; ++Index) Planners[Index].Publish(*Live[Index]);
+		Worker.BeginFrame();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	for (FQDynaPlanner& Planner : Planners) Worker.Remove(Planner);
+	Worker.Stop();
+
+	QCHECK(!Worker.IsRunning() && Converged());
+}
+
+QTEST(DynaPlanner, PlannersSharingALiveTableSettle)
+{
+	for (const int32_t NumPlanners : { 1, 4, 8 })
+	{
+		FQLearnerConfig Config;
+		Config.LearningRate = 0.5f;
+		Config.DiscountFactor = 0.9f;
+		const std::shared_ptr<IQTable> Live = MakeTable(ETableBackend::Map, TestNumActions, 0);
+		FQLearner Real;
+		Real.Config = Config;
+		Real.SetTable(Live);
+
+		std::vector<std::unique_ptr<FQDynaPlanner>> Planners;
+		for (int32_t Index = 0; Index < NumPlanners; ++Index)
+		{
+			Planners.push_back(std::make_unique<FQDynaPlanner>());
+			Planners.back()->SeedRandom(1, static_cast<uint64_t>(Index));
+			Planners.back()->Start(*Live, Config, false);
+		}
+
+		float Low = 1e9f, High = -1e9f;
+		for (int32_t Frame = 0; Frame < 200; ++Frame)
+		{
+			if (Frame % 5 == 0)
+			{
+				Real.UpdateQValue(1, 0, 10.f, 2); // s' = 2 is never updated, so the target stays at 10
+				for (const std::unique_ptr<FQDynaPlanner>& Planner : Planners) Planner->Observe({ 1, 2, 0, 10.f });
+			}
+			for (const std::unique_ptr<FQDynaPlanner>& Planner : Planners)
+			{
+				Planner->Publish(*Live);
+				Planner->Plan(64);
+			}
+			if (Frame >= 150)
+			{
+				Low = std::min(Low, Live->FindRow(1)[0]);
+				High = std::max(High, Live->FindRow(1)[0]);
+			}
+		}
+		QCHECK(Low > 9.9f && High < 10.1f); // each planner's base is the live row, corrections don't stack
+		for (const std::unique_ptr<FQDynaPlanner>& Planner : Planners) Planner->Stop();
+	}
+}
@@ -0,0 +1,241 @@
+#include "QTest.h"
+#include "QTestState.h"
+#include "QCore/QLearner.h"
+#include <thread>
+
+using namespace QCore;
+
+static FQLearner MakeLearner(const ETableBackend Backend, const float Epsilon)
+{
+	FQLearner Learner;
+	Learner.Config.ExplorationRate = Epsilon;
+	Learner.SetTable(MakeTable(Backend, TestNumActions, FTestState::Schema::NumKeys));
+	return Learner;
+}
+
+QTEST(Learner, ChooseActionIsGreedyWithoutExplorationAndStoresNothing)
+{
+	FQLearner Learner = MakeLearner(ETableBackend::Map, 0.f);
+	QCHECK(Learner.ChooseAction(10) == 0); // implicit zero row -> first action
+	QCHECK(!Learner.GetTable()->Contains(10));
+
+	Learner.GetTable()->FindOrAddRow(10)[3] = 1.f;
+	QCHECK(Learner.ChooseAction(10) == 3);
+	QCHECK(Learner.ChooseGreedyAction(10) == 3);
+	QCHECK(Learner.ChooseGreedyAction(11) == 0);
+	QCHECK(!Learner.GetTable()->Contains(11));
+}
+
+QTEST(Learner, ExplorationStaysInActionRange)
+{
+	FQLearner Learner = MakeLearner(ETableBackend::Map, 1.f);
+	for (int32_t Step = 0; Step < 200; ++Step)
+	{
+		const int32_t Action = Learner.ChooseAction(1);
+		QCHECK(Action >= 0 && Action < TestNumActions);
+	}
+}
+
+QTEST(Learner, ExplorationRateIsAProbability)
+{
+	FQLearner Learner = MakeLearner(ETableBackend::Map, 0.25f);
+	Learner.SeedRandom(17);
+	Learner.GetTable()->FindOrAddRow(1)[3] = 1.f;
+
+	constexpr int32_t NumDraws = 20000;
+	int32_t NumNonGreedy = 0;
+	for (int32_t Step = 0; Step < NumDraws; ++Step) NumNonGreedy += Learner.ChooseAction(1) != 3;
+
+	// 25% random picks, 1 in TestNumActions of them happens to be the greedy action
+	const float Expected = 0.25f * (TestNumActions - 1) / TestNumActions;
+	QCHECK_NEAR(static_cast<float>(NumNonGreedy) / NumDraws, Expected, 0.02f);
+}
+
+QTEST(Learner, SeededLearnersReplayExactly)
+{
+	FQLearner First = MakeLearner(ETableBackend::Map, 0.5f);
+	FQLearner Second = MakeLearner(ETableBackend::Map, 0.5f);
+	FQLearner OtherAgent = MakeLearner(ETableBackend::Map, 0.5f);
+	First.SeedRandom(42, 7);
+	Second.SeedRandom(42, 7);
+	OtherAgent.SeedRandom(42, 8);
+
+	bool bSame = true, bOtherDiffers = false;
+	for (int32_t Step = 0; Step < 500; ++Step)
+	{
+		const FQKey State = static_cast<FQKey>(Step % 13);
+		const int32_t Action = First.ChooseAction(State);
+		bSame &= Action == Second.ChooseAction(State);
+		bOtherDiffers |= Action != OtherAgent.ChooseAction(State);
+		First.UpdateQValue(State, Action, static_cast<float>(Action), State + 1);
+		Second.UpdateQValue(State, Action, static_cast<float>(Action), State + 1);
+	}
+	QCHECK(bSame && bOtherDiffers);
+	QCHECK(First.GetQValue(3, 2) == Second.GetQValue(3, 2));
+}
+
+static void CheckTdUpdate(const ETableBackend Backend)
+{
+	FQLearner Learner = MakeTestLearner(Backend);
+
+	// Unseen previous state, zero target: Q stays at the implicit default, nothing is stored
+	Learner.UpdateQValue(1, 2, 0.f, 2);
+	QCHECK(Learner.GetTable()->Num() == 0);
+
+	Learner.ChooseAction(1);
+	Learner.UpdateQValue(1, 2, 10.f, 2);
+	QCHECK(Learner.GetTable()->Contains(1) && !Learner.GetTable()->Contains(2)); // first non-zero write, s' only read as max 0
+	QCHECK_NEAR(Learner.GetTable()->FindRow(1)[2], 5.f, 1e-6);	// 0 + 0.5 * (10 + 0.9 * 0 - 0)
+
+	Learner.GetTable()->FindOrAddRow(2)[4] = 2.f;
+	Learner.UpdateQValue(1, 2, 0.f, 2);
+	QCHECK_NEAR(Learner.GetTable()->FindRow(1)[2], 5.f + 0.5f * (0.9f * 2.f - 5.f), 1e-6);
+}
+
+QTEST(Learner, TdUpdateMap) { CheckTdUpdate(ETableBackend::Map); }
+QTEST(Learner, TdUpdateDense) { CheckTdUpdate(ETableBackend::Dense); }
+
+QTEST(Learner, VisitCountStepSizeAveragesSamples)
+{
+	FQLearner Learner = MakeLearner(ETableBackend::Map, 0.f);
+	Learner.Config.LearningRate = 0.01f;
+	Learner.Config.DiscountFactor = 0.f;
+	Learner.Config.VisitCountExponent = 1.f; // alpha = 1/N - Q is the sample mean
+	QCHECK(Learner.GetTable()->EnableVisitCounts());
+
+	Learner.ChooseAction(1);
+	const float Rewards[] = { 4.f, 0.f, 2.f, 6.f };
+	for (const float Reward : Rewards) Learner.UpdateQValue(1, 2, Reward, 9);
+	QCHECK_NEAR(Learner.GetQValue(1, 2), 3.f, 1e-5f);
+	QCHECK(Learner.GetTable()->GetVisitCount(1, 2) == 4 && Learner.GetTable()->GetVisitCount(1, 0) == 0);
+
+	for (int32_t Step = 0; Step < 1000; ++Step) Learner.UpdateQValue(1, 2, 10.f, 9); // floor: settles at LearningRate
+	QCHECK(Learner.GetTable()->GetVisitCount(1, 2) == 1004);
+	const float Before = Learner.GetQValue(1, 2);
+	Learner.UpdateQValue(1, 2, 0.f, 9);
+	QCHECK_NEAR(Learner.GetQValue(1, 2), Before * (1.f - 0.01f), 1e-4f);
+}
+
+QTEST(Learner, TracesPropagateTerminalReward)
+{
+	// Chain 1 -> 2 -> 3 -> 4, reward only on the last step, always the greedy action 0
+	FQLearner Learner = MakeTestLearner(ETableBackend::Map, 0.8f);
+	for (FQKey State = 1; State <= 3; ++State) Learner.ChooseAction(State);
+
+	Learner.UpdateQValue(1, 0, 0.f, 2);
+	Learner.UpdateQValue(2, 0, 0.f, 3);
+	Learner.UpdateQValue(3, 0, 10.f, 4);
+	QCHECK(Learner.GetTraces().Num() == 3);
+
+	const float Gl = 0.9f * 0.8f;
+	QCHECK_NEAR(Learner.GetTable()->FindRow(3)[0], 5.f, 1e-5);
+	QCHECK_NEAR(Learner.GetTable()->FindRow(2)[0], 5.f * Gl, 1e-5);
+	QCHECK_NEAR(Learner.GetTable()->FindRow(1)[0], 5.f * Gl * Gl, 1e-5);
+
+	Learner.EndEpisode();
+	QCHECK(Learner.GetTraces().Num() == 0);
+}
+
+QTEST(Learner, TracesCutOnExploratoryAction)
+{
+	FQLearner Learner = MakeTestLearner(ETableBackend::Dense, 1.f);
+	Learner.ChooseAction(1);
+	Learner.ChooseAction(2);
+	Learner.GetTable()->FindOrAddRow(2)[0] = 1.f;
+
+	Learner.UpdateQValue(1, 0, 0.f, 2);
+	const float Q1 = Learner.GetTable()->FindRow(1)[0];
+	Learner.UpdateQValue(2, 3, 10.f, 3); // action 3 is not greedy in state 2
+	QCHECK(Learner.GetTraces().Num() == 1);
+	QCHECK(Learner.GetTable()->FindRow(1)[0] == Q1);
+	QCHECK_NEAR(Learner.GetTable()->FindRow(2)[3], 5.f, 1e-6);
+}
+
+QTEST(Learner, TracesArePrunedAndBounded)
+{
+	FQLearner Learner = MakeLearner(ETableBackend::Map, 0.f);
+	Learner.Config.DiscountFactor = 0.5f;
+	Learner.Config.TraceDecay = 0.5f;
+	Learner.Config.TraceThreshold = 0.1f;
+	for (FQKey State = 0; State < 10; ++State)
+	{
+		Learner.ChooseAction(State);
+		Learner.UpdateQValue(State, 0, 0.f, State + 1);
+	}
+	QCHECK(Learner.GetTraces().Num() == 1); // 0.25 survives, 0.0625 is pruned
+
+	Learner.Config.TraceThreshold = 0.f;
+	Learner.Config.DiscountFactor = 1.f;
+	Learner.Config.TraceDecay = 1.f;
+	for (FQKey State = 0; State < 2 * MaxEligibilityTraces; ++State)
+	{
+		Learner.ChooseAction(State);
+		Learner.UpdateQValue(State, 0, 0.f, State + 1);
+	}
+	QCHECK(Learner.GetTraces().Num() == MaxEligibilityTraces);
+}
+
+QTEST(Learner, Int16AccuracyAgainstFloat)
+{
+	// Same transition stream into a Float and an Int16 learner, then compare the tables
+	FQLearner Float = MakeLearner(ETableBackend::Dense, 0.f);
+	FQLearner Int16;
+	Int16.Config = Float.Config;
+	Int16.SetTable(MakeTable(ETableBackend::Dense, TestNumActions, FTestState::Schema::NumKeys, EQValueType::Int16));
+
+	std::mt19937 Rng(5);
+	std::uniform_int_distribution<int32_t> State(0, 199);
+	std::uniform_int_distribution<int32_t> Action(0, TestNumActions - 1);
+	std::uniform_real_distribution<float> Reward(-1.f, 1.f);
+	for (int32_t Step = 0; Step < 50000; ++Step)
+	{
+		const FQKey Prev = static_cast<FQKey>(State(Rng));
+		const FQKey Next = static_cast<FQKey>(State(Rng));
+		const int32_t Taken = Action(Rng);
+		const float R = Reward(Rng) + (Prev % 7 == 0 && Taken == 1 ? 10.f : 0.f); // a few clearly better actions
+		Float.ChooseAction(Prev);
+		Int16.ChooseAction(Prev);
+		Float.UpdateQValue(Prev, Taken, R, Next);
+		Int16.UpdateQValue(Prev, Taken, R, Next);
+	}
+
+	const FQTableComparison Comparison = CompareTables(*Float.GetTable(), *Int16.GetTable());
+	QCHECK(Comparison.NumCompared == Float.GetTable()->Num() && Comparison.NumMissing == 0);
+	QCHECK(Comparison.MeanAbsError < 0.05f);
+	QCHECK(Comparison.GetGreedyAgreement() > 0.9f);
+	for (FQKey Key = 0; Key < 200; Key += 7)
+	{
+		QCHECK(Int16.ChooseGreedyAction(Key) == 1);
+	}
+}
+
+QTEST(Learner, SharedAtomicTableLearnsFromEveryThread)
+{
+	const std::shared_ptr<IQTable> Shared = MakeTable(ETableBackend::Dense, TestNumActions, FTestState::Schema::NumKeys, EQValueType::AtomicFloat);
+	constexpr int32_t NumLearners = 4;
+
+	std::vector<std::thread> Threads;
+	for (int32_t Index = 0; Index < NumLearners; ++Index)
+	{
+		Threads.emplace_back([&Shared, Index]()
+		{
+			FQLearner Learner;
+			Learner.Config.ExplorationRate = 0.f;
+			Learner.Config.TraceDecay = Index % 2 ? 0.5f : 0.f; // traces stay per learner
+			Learner.SetTable(Shared);
+			for (int32_t Step = 0; Step < 20000; ++Step)
+			{
+				const FQKey State = static_cast<FQKey>(Step % 64);
+				Learner.ChooseAction(State);
+				Learner.UpdateQValue(State, 3, State == 0 ? 1.f : 0.f, (State + 1) % 64);
+			}
+		});
+	}
+	for (std::thread& Thread : Threads) Thread.join();
+
+	FQLearner Reader;
+	Reader.SetTable(Shared);
+	QCHECK(Shared->Num() == 64);
+	QCHECK(Reader.ChooseGreedyAction(0) == 3);
+	QCHECK(Shared->FindRowAs<std::atomic<float>>(0)[3].load() > 0.5f);
+}
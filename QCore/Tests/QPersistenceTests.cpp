@@ -0,0 +1,188 @@
+#include "QTest.h"
+#include "QTestState.h"
+#include "QCore/QPersistence.h"
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+using namespace QCore;
+
+QTEST(Persistence, JsonRoundTrip)
+{
+	const FQKeyLayout Layout = MakeKeyLayout<FTestState::Schema>();
+	const std::unique_ptr<IQTable> Table = MakeTable(ETableBackend::Map, TestNumActions, 0);
+
+	FTestState State;
+	State.HealthPercent = 75;
+	State.bIsTargetAttacking = true;
+	const FQRow Row = Table->FindOrAddRow(State.ToKey());
+	Row[0] = 0.125f;
+	Row[4] = -3.5f;
+	Table->FindOrAddRow(FTestState().ToKey());
+
+	const std::string Json = WriteTableJson(*Table, Layout);
+	QCHECK(Json.find("\"75_0_0_0_1_0_0\"") != std::string::npos);
+	QCHECK(std::count(Json.begin(), Json.end(), '{') == 2); // the all-zero default row isn't saved
+
+	const std::unique_ptr<IQTable> Loaded = MakeTable(ETableBackend::Dense, TestNumActions, FTestState::Schema::NumKeys);
+	QCHECK(ReadTableJson(*Loaded, Layout, Json.data(), Json.size()));
+	QCHECK(Loaded->Num() == 1);
+	QCHECK(Loaded->FindRow(State.ToKey())[0] == 0.125f);
+	QCHECK(Loaded->FindRow(State.ToKey())[4] == -3.5f);
+}
+
+QTEST(Persistence, ReadsUnrealPrettyPrintedJson)
+{
+	// As written by TJsonWriterFactory<>::Create (pretty printed, actions in any order)
+	const char* Json =
+		"{\r\n\t\"50_100_3_1_0_0_1\":\r\n\t{\r\n\t\t\"0\": 0.5,\r\n\t\t\"4\": -1.25,\r\n\t\t\"2\": 1e-3\r\n\t},\r\n"
+		"\t\"bad_key\": { \"0\": 1 }\r\n}";
+	const FQKeyLayout Layout = MakeKeyLayout<FTestState::Schema>();
+	const std::unique_ptr<IQTable> Table = MakeTable(ETableBackend::Map, TestNumActions, 0);
+
+	QCHECK(ReadTableJson(*Table, Layout, Json, std::strlen(Json)));
+	QCHECK(Table->Num() == 1);
+
+	FTestState State;
+	FTestState::Schema::ParseString("50_100_3_1_0_0_1", State);
+	const FQRow Row = Table->FindRow(State.ToKey());
+	QCHECK(Row && Row[0] == 0.5f && Row[4] == -1.25f && Row[1] == 0.f);
+	QCHECK_NEAR(Row[2], 0.001, 1e-7);
+}
+
+QTEST(Persistence, MalformedJsonLeavesTableEmpty)
+{
+	const char* Json = "{ \"1_2_3_0_0_0_0\": { \"0\": 1 }, \"4_5_6_0_0_0_0\": { \"0\": ";
+	const FQKeyLayout Layout = MakeKeyLayout<FTestState::Schema>();
+	const std::unique_ptr<IQTable> Table = MakeTable(ETableBackend::Map, TestNumActions, 0);
+
+	QCHECK(!ReadTableJson(*Table, Layout, Json, std::strlen(Json)));
+	QCHECK(Table->Num() == 0);
+}
+
+QTEST(Persistence, Int16RoundTripIsExact)
+{
+	const FQKeyLayout Layout = MakeKeyLayout<FTestState::Schema>();
+	const std::unique_ptr<IQTable> Table = MakeTable(ETableBackend::Map, TestNumActions, 0, EQValueType::Int16);
+	const float Values[TestNumActions] = { 0.3f, -17.125f, 200.f, 1e-3f, -255.9f };
+	Table->StoreRow(12345, Values);
+
+	const std::string Json = WriteTableJson(*Table, Layout);
+	const std::unique_ptr<IQTable> Loaded = MakeTable(ETableBackend::Dense, TestNumActions, FTestState::Schema::NumKeys, EQValueType::Int16);
+	QCHECK(ReadTableJson(*Loaded, Layout, Json.data(), Json.size()));
+
+	const FQConstRow16 Original = static_cast<const IQTable&>(*Table).FindRowAs<int16_t>(12345);
+	const FQConstRow16 Reloaded = static_cast<const IQTable&>(*Loaded).FindRowAs<int16_t>(12345);
+	QCHECK(Original && Reloaded);
+	for (int32_t Action = 0; Action < TestNumActions; ++Action) QCHECK(Original[Action] == Reloaded[Action]);
+}
+
+QTEST(Persistence, VisitCountsRoundTrip)
+{
+	const FQKeyLayout Layout = MakeKeyLayout<FTestState::Schema>();
+	const std::unique_ptr<IQTable> Table = MakeTable(ETableBackend::Map, TestNumActions, 0);
+	QCHECK(Table->EnableVisitCounts());
+	const float Values[TestNumActions] = { 1.f, 2.f, 3.f, 4.f, 5.f };
+	const uint32_t Counts[TestNumActions] = { 0, 7, 4000000000u, 1, 0 };
+	Table->StoreRow(12345, Values);
+	Table->StoreVisitCounts(12345, Counts);
+
+	const std::string Json = WriteTableJson(*Table, Layout);
+	const std::unique_ptr<IQTable> Loaded = MakeTable(ETableBackend::Dense, TestNumActions, FTestState::Schema::NumKeys);
+	QCHECK(Loaded->EnableVisitCounts());
+	QCHECK(ReadTableJson(*Loaded, Layout, Json.data(), Json.size()));
+	QCHECK(Loaded->Num() == 1 && Loaded->FindRow(12345)[4] == 5.f);
+	for (int32_t Action = 0; Action < TestNumActions; ++Action) QCHECK(Loaded->GetVisitCount(12345, Action) == Counts[Action]);
+
+	const size_t CountsKey = Json.find("\"N:");
+	QCHECK(CountsKey != std::string::npos);
+	FQKey Key;
+	const char* KeyBegin = Json.data() + CountsKey + 1;
+	QCHECK(!ParseKeyString(KeyBegin, std::strchr(KeyBegin, '"'), Layout, Key)); // what an older reader does with it
+
+	const std::unique_ptr<IQTable> Plain = MakeTable(ETableBackend::Map, TestNumActions, 0); // counts entries are skipped
+	QCHECK(ReadTableJson(*Plain, Layout, Json.data(), Json.size()));
+	QCHECK(Plain->Num() == 1 && Plain->FindRow(12345)[2] == 3.f);
+}
+
+QTEST(Persistence, BinaryRoundTrip)
+{
+	const FQKeyLayout Layout = MakeKeyLayout<FTestState::Schema>();
+	const std::unique_ptr<IQTable> Table = MakeTable(ETableBackend::Map, TestNumActions, 0);
+	QCHECK(Table->EnableVisitCounts());
+	for (FQKey Key = 1; Key <= 100; ++Key)
+	{
+		const float Values[TestNumActions] = { 0.1f * Key, -1.f, 0.f, 3.5f, 1e-6f };
+		Table->StoreRow(Key * 977, Values);
+	}
+	const uint32_t Counts[TestNumActions] = { 3, 0, 4000000000u, 1, 0 };
+	Table->StoreVisitCounts(977, Counts);
+	Table->FindOrAddRow(5); // default row, not saved
+
+	const std::string Bytes = WriteTableBinary(*Table, Layout);
+	QCHECK(IsTableBinary(Bytes.data(), Bytes.size()) && !IsTableBinary("{}", 2));
+	QCHECK(Bytes.size() == 40 + Layout.NumFields * 16 + 100 * (8 + TestNumActions * 4 + TestNumActions * 4));
+
+	const std::unique_ptr<IQTable> Loaded = MakeTable(ETableBackend::Dense, TestNumActions, FTestState::Schema::NumKeys);
+	QCHECK(Loaded->EnableVisitCounts());
+	QCHECK(ReadTable(*Loaded, Layout, Bytes.data(), Bytes.size()));
+	QCHECK(Loaded->Num() == 100);
+	const FQTableComparison Comparison = CompareTables(*Table, *Loaded);
+	QCHECK(Comparison.NumCompared == 100 && Comparison.MaxAbsError == 0.f);
+	for (int32_t Action = 0; Action < TestNumActions; ++Action) QCHECK(Loaded->GetVisitCount(977, Action) == Counts[Action]);
+
+	// Same bytes through the JSON export
+	const std::string Json = WriteTableJson(*Loaded, Layout);
+	const std::unique_ptr<IQTable> FromJson = MakeTable(ETableBackend::Map, TestNumActions, 0);
+	QCHECK(ReadTable(*FromJson, Layout, Json.data(), Json.size()) && FromJson->Num() == 100);
+}
+
+QTEST(Persistence, BinaryInt16KeepsRawValues)
+{
+	const FQKeyLayout Layout = MakeKeyLayout<FTestState::Schema>();
+	const std::unique_ptr<IQTable> Table = MakeTable(ETableBackend::Map, TestNumActions, 0, EQValueType::Int16);
+	const float Values[TestNumActions] = { 0.3f, -17.125f, 200.f, 1e-3f, -255.9f };
+	Table->StoreRow(12345, Values);
+
+	const std::string Bytes = WriteTableBinary(*Table, Layout);
+	QCHECK(Bytes.size() == 40 + Layout.NumFields * 16 + 8 + TestNumActions * 2);
+
+	const std::unique_ptr<IQTable> Loaded = MakeTable(ETableBackend::Dense, TestNumActions, FTestState::Schema::NumKeys, EQValueType::Int16);
+	QCHECK(ReadTableBinary(*Loaded, Layout, Bytes.data(), Bytes.size()));
+	const FQConstRow16 Original = static_cast<const IQTable&>(*Table).FindRowAs<int16_t>(12345);
+	const FQConstRow16 Reloaded = static_cast<const IQTable&>(*Loaded).FindRowAs<int16_t>(12345);
+	QCHECK(Original && Reloaded);
+	for (int32_t Action = 0; Action < TestNumActions; ++Action) QCHECK(Original[Action] == Reloaded[Action]);
+
+	// Into a float table: dequantized with the file's scale
+	const std::unique_ptr<IQTable> AsFloat = MakeTable(ETableBackend::Map, TestNumActions, 0);
+	QCHECK(ReadTableBinary(*AsFloat, Layout, Bytes.data(), Bytes.size()));
+	QCHECK_NEAR(AsFloat->FindRow(12345)[1], -17.125f, Table->GetValueScale());
+}
+
+QTEST(Persistence, BinaryRejectsMismatchAndCorruption)
+{
+	const FQKeyLayout Layout = MakeKeyLayout<FTestState::Schema>();
+	const std::unique_ptr<IQTable> Table = MakeTable(ETableBackend::Map, TestNumActions, 0);
+	const float Values[TestNumActions] = { 1.f, 2.f, 3.f, 4.f, 5.f };
+	Table->StoreRow(42, Values);
+	Table->StoreRow(43, Values);
+	const std::string Bytes = WriteTableBinary(*Table, Layout);
+
+	const std::unique_ptr<IQTable> Loaded = MakeTable(ETableBackend::Map, TestNumActions, 0);
+	Loaded->StoreRow(7, Values);
+	std::string Corrupt = Bytes;
+	Corrupt[Corrupt.size() - 3] ^= 1;
+	QCHECK(!ReadTableBinary(*Loaded, Layout, Corrupt.data(), Corrupt.size()));
+	QCHECK(Loaded->Num() == 0); // left empty, like a malformed JSON
+	QCHECK(!ReadTableBinary(*Loaded, Layout, Bytes.data(), Bytes.size() - 4));
+	QCHECK(!ReadTableBinary(*Loaded, Layout, Bytes.data(), 20));
+
+	const std::unique_ptr<IQTable> OtherActions = MakeTable(ETableBackend::Map, TestNumActions + 1, 0);
+	QCHECK(!ReadTableBinary(*OtherActions, Layout, Bytes.data(), Bytes.size()));
+
+	static constexpr FQFieldLayout OtherFields[] = { { "HealthPercent", 0, 21, 0, (1 << 21) - 1 } };
+	QCHECK(!ReadTableBinary(*Loaded, FQKeyLayout{ OtherFields, 1 }, Bytes.data(), Bytes.size()));
+
+	QCHECK(ReadTableBinary(*Loaded, Layout, Bytes.data(), Bytes.size()) && Loaded->Num() == 2);
+}
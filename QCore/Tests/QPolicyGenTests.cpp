@@ -0,0 +1,53 @@
+#include "QTest.h"
+#include "QTestState.h"
+#include "QCore/QPersistence.h"
+#include "QCore/QPolicyTable.h"
+#include "QTestPolicy.h" // QPolicyGen output for Data/PolicyGenTable.json, generated at build time
+
+using namespace QCore;
+
+static_assert(QTestPolicy::Choose(0) == 3, "lookups are usable at compile time"); // 0_0_0_0_0_0_0 -> action 3
+
+QTEST(PolicyGen, GeneratedHeaderMatchesRuntimePolicy)
+{
+	FQDiscretizer Discretizer(MakeKeyLayout<FTestState::Schema>());
+	const int32_t Edges[] = { 20, 40, 60, 80 }; // QPolicyGen defaults
+	Discretizer.SetBucketEdges("HealthPercent", Edges, 4);
+	Discretizer.SetBucketEdges("TargetHealthPercent", Edges, 4);
+
+	const std::unique_ptr<IQTable> Table = MakeTable(ETableBackend::Map, TestNumActions, 0);
+	QCHECK(LoadTableJsonFile(*Table, MakeKeyLayout<FTestState::Schema>(), QTEST_DATA_DIR "/PolicyGenTable.json"));
+	DiscretizeTable(*Table, Discretizer);
+	FQPolicyTable Policy(Discretizer);
+	Policy.Build(*Table);
+
+	QCHECK(QTestPolicy::Signature == Policy.GetSignature());
+	QCHECK(QTestPolicy::NumStates == Policy.GetNumStates() && QTestPolicy::NumActions == TestNumActions);
+	for (uint32_t Index = 0; Index < Policy.GetNumStates(); ++Index)
+	{
+		const FQKey Key = Policy.GetStateKey(Index);
+		QCHECK(QTestPolicy::StateIndex(Key) == Index && QTestPolicy::Choose(Key) == Policy.Choose(Key));
+	}
+
+	// Raw keys fold onto their buckets, as with FQPolicyTable
+	QCHECK(QTestPolicy::Choose(MakeState(37, 99, 7, false, true, true, true).ToKey()) == 4);
+	QCHECK(QTestPolicy::Choose(MakeState(25, 95, 3, true, true, false, false).ToKey()) == 1);
+	QCHECK(QTestPolicy::Choose(MakeState(99, 30, 1, true, false, false, true).ToKey()) == 2);
+	QCHECK(QTestPolicy::Choose(MakeState(50, 50, 5, false, false, false, false).ToKey()) == 0); // unseen
+}
+
+QTEST(PolicyGen, HeaderIndexesArithmeticallyWherePossible)
+{
+	FQDiscretizer Discretizer(MakeKeyLayout<FTestState::Schema>());
+	const int32_t Edges[] = { 50 };
+	Discretizer.SetBucketEdges("HealthPercent", Edges, 1);
+	FQPolicyTable Policy(Discretizer);
+	Policy.Build(*MakeTable(ETableBackend::Map, TestNumActions, 0));
+
+	const std::string Header = WritePolicyHeader(Policy, MakeKeyLayout<FTestState::Schema>(), "QSmall", "Small.json");
+	QCHECK(Header.find("namespace QSmall") != std::string::npos);
+	QCHECK(Header.find("HealthPercentIndex[128]") != std::string::npos); // bucketed -> lookup
+	QCHECK(Header.find("TargetHealthPercentIndex[128]") != std::string::npos); // 101-127 clamp to 100 -> lookup
+	QCHECK(Header.find("HealsLeftIndex") == std::string::npos && Header.find("/* HealsLeft */") != std::string::npos); // 0-7 fills its bits
+	QCHECK(Header.find("/* bWasHitRecently */") != std::string::npos);
+}
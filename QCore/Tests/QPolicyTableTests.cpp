@@ -0,0 +1,94 @@
+#include "QTest.h"
+#include "QTestState.h"
+#include "QCore/QLearner.h"
+#include "QCore/QPolicyTable.h"
+
+using namespace QCore;
+
+static FQDiscretizer MakeBandedDiscretizer()
+{
+	FQDiscretizer Discretizer(MakeKeyLayout<FTestState::Schema>());
+	const int32_t Edges[] = { 20, 40, 60, 80 };
+	Discretizer.SetBucketEdges("HealthPercent", Edges, 4);
+	Discretizer.SetBucketEdges("TargetHealthPercent", Edges, 4);
+	return Discretizer;
+}
+
+QTEST(PolicyTable, OneBytePerBucketedState)
+{
+	const FQDiscretizer Discretizer = MakeBandedDiscretizer();
+	const FQPolicyTable Policy(Discretizer);
+	QCHECK(Policy.IsValid());
+	QCHECK(Policy.GetNumStates() == Discretizer.CountReachableKeys()); // 3200, not the 2M raw keys
+
+	// Every state index round-trips through its (bucketed) key, raw keys fold onto their bucket
+	for (uint32_t Index = 0; Index < Policy.GetNumStates(); ++Index)
+	{
+		const FQKey Key = Policy.GetStateKey(Index);
+		QCHECK(Discretizer.Apply(Key) == Key && Policy.GetStateIndex(Key) == Index);
+	}
+	const FQKey Raw = MakeState(37, 99, 0, false, true).ToKey();
+	QCHECK(Policy.GetStateIndex(Raw) == Policy.GetStateIndex(Discretizer.Apply(Raw)));
+	QCHECK(Policy.GetStateIndex(MakeState(19, 0, 0, false, true).ToKey()) != Policy.GetStateIndex(MakeState(20, 0, 0, false, true).ToKey()));
+}
+
+QTEST(PolicyTable, MatchesGreedyLearner)
+{
+	const FQDiscretizer Discretizer = MakeBandedDiscretizer();
+	FQLearner Learner;
+	Learner.Config.ExplorationRate = 0.f;
+	Learner.SetTable(MakeTable(ETableBackend::Map, TestNumActions, 0));
+	Learner.GetTable()->FindOrAddRow(Discretizer.Apply(MakeState(30, 90, 0, false, true).ToKey()))[2] = 1.f;
+	Learner.GetTable()->FindOrAddRow(Discretizer.Apply(MakeState(90, 10, 0, false, false).ToKey()))[4] = 0.5f;
+	const FQRow Tied = Learner.GetTable()->FindOrAddRow(Discretizer.Apply(MakeState(50, 50, 0, false, false).ToKey()));
+	Tied[1] = Tied[3] = 2.f; // ties -> first
+
+	FQPolicyTable Policy(Discretizer);
+	Policy.Build(*Learner.GetTable());
+	QCHECK(Policy.GetNumActions() == TestNumActions);
+	QCHECK(Policy.Choose(MakeState(35, 85, 0, false, true).ToKey()) == 2); // raw key, same bucket as (30, 90)
+	QCHECK(Policy.Choose(MakeState(50, 50, 0, false, false).ToKey()) == 1);
+	for (uint32_t Index = 0; Index < Policy.GetNumStates(); ++Index)
+	{
+		const FQKey Key = Policy.GetStateKey(Index);
+		QCHECK(Policy.Choose(Key) == Learner.ChooseGreedyAction(Key));
+	}
+}
+
+QTEST(PolicyTable, BinaryRoundTripChecksLayout)
+{
+	const FQDiscretizer Discretizer = MakeBandedDiscretizer();
+	const std::unique_ptr<IQTable> Table = MakeTable(ETableBackend::Map, TestNumActions, 0);
+	Table->FindOrAddRow(Discretizer.Apply(MakeState(70, 30, 0, false, true).ToKey()))[3] = 1.f;
+	FQPolicyTable Policy(Discretizer);
+	Policy.Build(*Table);
+
+	const std::string Bytes = WritePolicyBinary(Policy);
+	QCHECK(Bytes.size() == 24 + Policy.GetNumStates());
+
+	FQPolicyTable Loaded(Discretizer);
+	QCHECK(ReadPolicyBinary(Loaded, Bytes.data(), Bytes.size()));
+	QCHECK(Loaded.GetNumActions() == TestNumActions);
+	QCHECK(Loaded.Choose(MakeState(70, 30, 0, false, true).ToKey()) == 3);
+
+	// Other buckets, truncated files and out-of-range actions are rejected
+	FQDiscretizer Other(MakeKeyLayout<FTestState::Schema>());
+	const int32_t Edges[] = { 50 };
+	Other.SetBucketEdges("HealthPercent", Edges, 1);
+	FQPolicyTable Mismatched(Other);
+	QCHECK(!ReadPolicyBinary(Mismatched, Bytes.data(), Bytes.size()));
+	QCHECK(!ReadPolicyBinary(Loaded, Bytes.data(), Bytes.size() - 1));
+	std::string Corrupt = Bytes;
+	Corrupt.back() = static_cast<char>(TestNumActions);
+	QCHECK(!ReadPolicyBinary(Loaded, Corrupt.data(), Corrupt.size()));
+}
+
+QTEST(PolicyTable, UnbucketedSchemaFitsAndOversizedFails)
+{
+	const FQPolicyTable Raw(FQDiscretizer(MakeKeyLayout<FTestState::Schema>()));
+	QCHECK(Raw.IsValid() && Raw.GetNumStates() == 101ull * 101 * 8 * 16);
+
+	static constexpr FQFieldLayout WideFields[] = { { "A", 20, 20, 0, (1 << 20) - 1 }, { "B", 0, 20, 0, (1 << 20) - 1 } };
+	const FQPolicyTable Wide(FQDiscretizer(FQKeyLayout{ WideFields, 2 }));
+	QCHECK(!Wide.IsValid());
+}
@@ -0,0 +1,73 @@
+#include "QTest.h"
+#include "QTestState.h"
+#include "QCore/QPrioritizedSweeper.h"
+
+using namespace QCore;
+
+QTEST(PrioritizedSweeper, LargestErrorFirst)
+{
+	FQLearner Learner = MakeTestLearner(ETableBackend::Dense);
+	FQPrioritizedSweeper Sweeper(2);
+	for (FQKey State = 1; State <= 3; ++State) Learner.ChooseAction(State);
+
+	Sweeper.Observe(Learner, { 1, 50, 0, 1.f });
+	Sweeper.Observe(Learner, { 2, 50, 0, 5.f });
+	Sweeper.Observe(Learner, { 2, 50, 0, 5.f }); // already queued, not duplicated
+	QCHECK(Sweeper.NumQueued() == 2 && Sweeper.GetTopPriority() == 5.f);
+
+	QCHECK(Sweeper.Sweep(Learner, 1, 0.f) == 1);
+	QCHECK(Learner.GetQValue(2, 0) == 2.5f && Learner.GetQValue(1, 0) == 0.f);
+	QCHECK(Sweeper.GetTopPriority() == 2.5f); // half of the error remains at alpha 0.5
+}
+
+QTEST(PrioritizedSweeper, FullQueueKeepsTheLargestErrors)
+{
+	FQLearner Learner = MakeTestLearner(ETableBackend::Dense);
+	FQPrioritizedSweeper Sweeper(2);
+	for (FQKey State = 1; State <= 4; ++State) Learner.ChooseAction(State);
+
+	Sweeper.Observe(Learner, { 1, 50, 0, 1.f });
+	Sweeper.Observe(Learner, { 2, 50, 0, 5.f });
+	Sweeper.Observe(Learner, { 3, 50, 0, 3.f }); // full - replaces the 1
+	Sweeper.Observe(Learner, { 4, 50, 0, 2.f }); // smaller than everything queued - dropped
+	QCHECK(Sweeper.NumQueued() == 2);
+
+	QCHECK(Sweeper.Sweep(Learner, 2, 0.f) == 2);
+	QCHECK(Learner.GetQValue(2, 0) == 2.5f && Learner.GetQValue(3, 0) == 1.5f);
+	QCHECK(Learner.GetQValue(1, 0) == 0.f && Learner.GetQValue(4, 0) == 0.f);
+}
+
+QTEST(PrioritizedSweeper, ModelCapacityBoundsMemory)
+{
+	FQLearner Learner = MakeTestLearner(ETableBackend::Dense);
+	FQPrioritizedSweeper Sweeper(4, 3);
+	for (FQKey State = 0; State < 100; ++State)
+	{
+		Learner.ChooseAction(State);
+		Sweeper.Observe(Learner, { State, State + 1, 0, 1.f });
+	}
+	QCHECK(Sweeper.GetModel().Num() == 3);
+	QCHECK(Sweeper.GetModel().Find({ 99, 0 }) && !Sweeper.GetModel().Find({ 96, 0 })); // oldest pairs evicted
+	QCHECK(Sweeper.NumQueued() <= 4);
+}
+
+QTEST(PrioritizedSweeper, KillRewardReachesTheStartOfTheChain)
+{
+	// One pass through 0 -> 1 -> ... -> 9 -> kill: real updates alone only move Q(9)
+	constexpr int32_t ChainLength = 10;
+	FQLearner Learner = MakeTestLearner(ETableBackend::Dense);
+	FQPrioritizedSweeper Sweeper;
+	for (FQKey State = 0; State < ChainLength; ++State)
+	{
+		const float Reward = State == ChainLength - 1 ? 10.f : 0.f;
+		Learner.ChooseAction(State);
+		Learner.UpdateQValue(State, 1, Reward, State + 1);
+		Sweeper.Observe(Learner, { State, State + 1, 1, Reward });
+	}
+	QCHECK(Learner.GetQValue(0, 1) == 0.f);
+
+	const int32_t NumUpdates = Sweeper.Sweep(Learner, 2000, 0.f);
+	QCHECK(NumUpdates < 2000 && Sweeper.NumQueued() == 0); // converged below the threshold
+	QCHECK_NEAR(Learner.GetQValue(0, 1), 10.f * std::pow(0.9f, ChainLength - 1), 0.1f); // each link stops within PriorityThreshold
+	QCHECK(Learner.ChooseGreedyAction(0) == 1);
+}
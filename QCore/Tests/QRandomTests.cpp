@@ -0,0 +1,74 @@
+#include "QTest.h"
+#include "QCore/QRandom.h"
+#include <algorithm>
+#include <array>
+#include <vector>
+
+using namespace QCore;
+
+QTEST(Random, MatchesPcg32Reference)
+{
+	FQRandom Rng(42, 54); // pcg32_srandom(42, 54) from the PCG reference demo
+	const uint32_t Expected[] = { 0xa15c02b7u, 0x7b47f409u, 0xba1d3330u, 0x83d2f293u, 0xbfa4784bu, 0xcbed606eu };
+	for (const uint32_t Value : Expected) QCHECK(Rng.Next() == Value);
+}
+
+QTEST(Random, SeedAndStreamSelectTheSequence)
+{
+	FQRandom First(7, 1), Second(7, 1), OtherStream(7, 2), OtherSeed(8, 1);
+	int32_t NumSameStream = 0, NumSameSeed = 0;
+	for (int32_t Draw = 0; Draw < 64; ++Draw)
+	{
+		const uint32_t Value = First.Next();
+		QCHECK(Value == Second.Next());
+		NumSameStream += Value == OtherStream.Next();
+		NumSameSeed += Value == OtherSeed.Next();
+	}
+	QCHECK(NumSameStream == 0 && NumSameSeed == 0);
+
+	First.SetSeed(7, 1); // reseeding restarts the sequence
+	Second.SetSeed(7, 1);
+	QCHECK(First.Next() == Second.Next());
+}
+
+QTEST(Random, DrawsStayInRangeAndAreUniform)
+{
+	FQRandom Rng(3);
+	std::array<int32_t, 5> Buckets{};
+	double FloatSum = 0.0;
+	constexpr int32_t NumDraws = 50000;
+	for (int32_t Draw = 0; Draw < NumDraws; ++Draw)
+	{
+		const float Value = Rng.NextFloat();
+		QCHECK(Value >= 0.f && Value < 1.f);
+		FloatSum += Value;
+
+		const uint32_t Bounded = Rng.NextBounded(5);
+		QCHECK(Bounded < 5);
+		++Buckets[Bounded];
+
+		const int32_t Ranged = Rng.RandRange(-2, 2);
+		QCHECK(Ranged >= -2 && Ranged <= 2);
+	}
+	QCHECK_NEAR(FloatSum / NumDraws, 0.5, 0.01);
+	for (const int32_t Count : Buckets) QCHECK_NEAR(static_cast<float>(Count) / NumDraws, 0.2f, 0.01f);
+
+	QCHECK(Rng.NextBounded(1) == 0 && Rng.RandRange(4, 4) == 4);
+	QCHECK(!Rng.Chance(0.f) && Rng.Chance(1.f));
+}
+
+QTEST(Random, WorksWithStandardAlgorithms)
+{
+	std::vector<int32_t> Values = { 0, 1, 2, 3, 4, 5, 6, 7 };
+	FQRandom First(9), Second(9);
+	std::vector<int32_t> Shuffled = Values;
+	std::shuffle(Shuffled.begin(), Shuffled.end(), First);
+	std::shuffle(Values.begin(), Values.end(), Second);
+	QCHECK(Shuffled == Values);
+}
+
+QTEST(Random, DefaultIsSeedZero)
+{
+	FQRandom Default, Zero(0, 0);
+	for (int32_t Draw = 0; Draw < 8; ++Draw) QCHECK(Default.Next() == Zero.Next()); // owners seed it, construction draws no entropy
+}
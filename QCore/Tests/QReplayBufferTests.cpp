@@ -0,0 +1,52 @@
+#include "QTest.h"
+#include "QTestState.h"
+#include "QCore/QReplayBuffer.h"
+
+using namespace QCore;
+
+QTEST(ReplayBuffer, RingOverwritesOldest)
+{
+	FQReplayBuffer Buffer(4);
+	for (int32_t Step = 0; Step < 6; ++Step) Buffer.Add({ FQKey(Step), FQKey(Step + 1), 0, 0.f });
+	QCHECK(Buffer.Num() == 4 && Buffer.GetCapacity() == 4);
+
+	for (int32_t Draw = 0; Draw < 100; ++Draw)
+	{
+		QCHECK(Buffer.Sample().PrevState >= 2); // 0 and 1 were overwritten
+	}
+
+	Buffer.Empty();
+	QCHECK(Buffer.Num() == 0);
+}
+
+QTEST(ReplayBuffer, ReplayPropagatesRewardWithoutTouchingTraces)
+{
+	FQLearner Learner = MakeTestLearner(ETableBackend::Dense, 0.5f);
+	Learner.ChooseAction(1);
+	Learner.ChooseAction(2);
+	Learner.UpdateQValue(1, 0, 0.f, 2);
+	const int32_t NumTraces = Learner.GetTraces().Num();
+
+	// 1 -> 2 (no reward), 2 -> 3 (reward): replay alone carries the reward back to state 1
+	FQReplayBuffer Buffer(8);
+	Buffer.Add({ 1, 2, 0, 0.f });
+	Buffer.Add({ 2, 3, 0, 10.f });
+	QCHECK(Buffer.Replay(Learner, 200, 0.f) == 200);
+	QCHECK(Learner.GetTraces().Num() == NumTraces);
+	QCHECK_NEAR(Learner.GetTable()->FindRow(2)[0], 10.f, 1e-3);
+	QCHECK_NEAR(Learner.GetTable()->FindRow(1)[0], 9.f, 1e-3);
+}
+
+QTEST(ReplayBuffer, ReplayRespectsLimits)
+{
+	FQLearner Learner;
+	Learner.SetTable(MakeTable(ETableBackend::Map, TestNumActions, 0));
+	FQReplayBuffer Buffer;
+	QCHECK(Buffer.Replay(Learner, 10, 0.f) == 0); // empty
+
+	Buffer.Add({ 1, 2, 0, 1.f });
+	QCHECK(Buffer.Replay(Learner, 0, 0.f) == 0);
+	QCHECK(Buffer.Replay(Learner, 5, 1e6f) == 5);
+	const int32_t Applied = Buffer.Replay(Learner, 1 << 30, 50.f); // stopped by the 50us budget
+	QCHECK(Applied >= 1 && Applied < (1 << 30));
+}
@@ -0,0 +1,99 @@
+#include "QTest.h"
+#include "QCore/QRowKernels.h"
+#include <random>
+
+using namespace QCore;
+
+QTEST(RowKernels, PaddingNeverWins)
+{
+	alignas(RowAlignment) float Row[RowWidth];
+	InitRow(Row, 5, -100.f);
+	QCHECK(MaxRow(Row) == -100.f);
+	QCHECK(ArgMaxRow(Row) == 0);
+
+	Row[4] = -1.f;
+	QCHECK(ArgMaxRow(Row) == 4);
+}
+
+QTEST(RowKernels, TiesPickLowestAction)
+{
+	alignas(RowAlignment) float Row[RowWidth];
+	InitRow(Row, 5);
+	QCHECK(ArgMaxRow(Row) == 0);
+
+	Row[2] = 1.f;
+	Row[3] = 1.f;
+	QCHECK(ArgMaxRow(Row) == 2);
+}
+
+QTEST(RowKernels, MatchesScalarAndBatched)
+{
+	constexpr int32_t NumRows = 61; // not a multiple of the block size
+	std::vector<float, TAlignedAllocator<float, RowAlignment>> Storage(NumRows * RowWidth);
+	std::vector<const float*> Rows(NumRows);
+	std::mt19937 Rng(7);
+	std::uniform_int_distribution<int32_t> Value(-3, 3); // small range -> plenty of ties
+
+	for (int32_t Index = 0; Index < NumRows; ++Index)
+	{
+		float* Row = &Storage[Index * RowWidth];
+		InitRow(Row, 5);
+		for (int32_t Action = 0; Action < 5; ++Action) Row[Action] = static_cast<float>(Value(Rng));
+		Rows[Index] = Row;
+	}
+
+	std::vector<int32_t> Actions(NumRows);
+	std::vector<float> Maxes(NumRows);
+	ArgMaxRows(Rows.data(), NumRows, Actions.data(), Maxes.data());
+
+	for (int32_t Index = 0; Index < NumRows; ++Index)
+	{
+		QCHECK(ArgMaxRow(Rows[Index]) == ArgMaxRowScalar(Rows[Index]));
+		QCHECK(MaxRow(Rows[Index]) == MaxRowScalar(Rows[Index]));
+		QCHECK(Actions[Index] == ArgMaxRowScalar(Rows[Index]));
+		QCHECK(Maxes[Index] == MaxRowScalar(Rows[Index]));
+	}
+}
+
+QTEST(RowKernels, SumRowsKeepsPadding)
+{
+	alignas(RowAlignment) float Storage[3][RowWidth];
+	const float* Rows[3] = { Storage[0], Storage[1], Storage[2] };
+	for (int32_t Index = 0; Index < 3; ++Index)
+	{
+		InitRow(Storage[Index], 5);
+		for (int32_t Action = 0; Action < 5; ++Action) Storage[Index][Action] = static_cast<float>(Index * 10 + Action);
+	}
+
+	alignas(RowAlignment) float Sum[RowWidth];
+	SumRows(Rows, 3, Sum);
+	for (int32_t Action = 0; Action < 5; ++Action) QCHECK(Sum[Action] == static_cast<float>(30 + 3 * Action));
+	QCHECK(Sum[5] == RowPadding && Sum[RowWidth - 1] == RowPadding);
+	QCHECK(ArgMaxRow(Sum) == 4);
+
+	SumRows(Rows, 1, Sum);
+	QCHECK(Sum[2] == 2.f);
+}
+
+QTEST(RowKernels, Int16MatchesScalar)
+{
+	std::mt19937 Rng(11);
+	std::uniform_int_distribution<int32_t> Value(-4, 4);
+	for (int32_t NumActions = 1; NumActions <= RowWidth; ++NumActions)
+	{
+		for (int32_t Trial = 0; Trial < 50; ++Trial)
+		{
+			alignas(16) int16_t Row[RowWidth];
+			InitRow(Row, NumActions);
+			for (int32_t Action = 0; Action < NumActions; ++Action) Row[Action] = static_cast<int16_t>(Value(Rng) * 8000);
+
+			QCHECK(ArgMaxRow16(Row) == ArgMaxRow16Scalar(Row));
+			QCHECK(MaxRow16(Row, 0.5f) == static_cast<float>(MaxRowRaw16Scalar(Row)) * 0.5f);
+		}
+	}
+
+	alignas(16) int16_t Row[RowWidth];
+	InitRow(Row, 5, -MaxQuantized16); // padding (RowPadding16) stays below the lowest quantized value
+	QCHECK(ArgMaxRow16(Row) == 0);
+	QCHECK(MaxRow16(Row, 1.f) == -static_cast<float>(MaxQuantized16));
+}
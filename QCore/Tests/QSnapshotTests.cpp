@@ -0,0 +1,98 @@
+#include "QTest.h"
+#include "QTestState.h"
+#include "QCore/QSnapshot.h"
+#include <thread>
+#include <vector>
+
+using namespace QCore;
+
+QTEST(Snapshot, PublishedCopyIsUnaffectedByLaterWrites)
+{
+	const std::unique_ptr<IQTable> Table = MakeTable(ETableBackend::Map, TestNumActions, 0);
+	Table->FindOrAddRow(7)[2] = 1.f;
+
+	FQSnapshotPublisher Publisher;
+	FQSnapshotReader Reader(Publisher);
+	QCHECK(Reader.IsValid() && !Reader.Pin());
+
+	Publisher.Publish(*Table);
+	Table->FindOrAddRow(7)[4] = 5.f;
+	Table->FindOrAddRow(8);
+
+	const FQSnapshotReader::FPin Pin = Reader.Pin();
+	QCHECK(Pin && Pin->GetVersion() == 1 && Pin->Num() == 1);
+	QCHECK(Pin->ChooseGreedyAction(7) == 2 && Pin->FindRow(7)[4] == 0.f);
+	QCHECK(!Pin->FindRow(8) && Pin->ChooseGreedyAction(8) == 0);
+	QCHECK(Pin->FindRow(7).GetData()[RowWidth - 1] == RowPadding);
+}
+
+QTEST(Snapshot, PinnedSnapshotIsNotReclaimed)
+{
+	const std::unique_ptr<IQTable> Table = MakeTable(ETableBackend::Dense, TestNumActions, FTestState::Schema::NumKeys, EQValueType::Int16);
+	float Values[TestNumActions] = { 0.f, 0.f, 0.f, 3.f, 0.f };
+	Table->StoreRow(1, Values);
+
+	FQSnapshotPublisher Publisher;
+	FQSnapshotReader Reader(Publisher);
+	Publisher.Publish(*Table);
+	{
+		const FQSnapshotReader::FPin Pin = Reader.Pin();
+		const FQTableSnapshot* First = Pin.Get();
+		for (int32_t Publish = 0; Publish < 3; ++Publish) Publisher.Publish(*Table);
+		QCHECK(Publisher.GetNumRetired() == 3); // the pinned v1 holds back every later retirement
+		QCHECK(First->GetVersion() == 1 && First->ChooseGreedyAction(1) == 3);
+	}
+
+	QCHECK(Publisher.Reclaim() == 3 && Publisher.GetNumRetired() == 0);
+	Publisher.Publish(*Table); // reuses a reclaimed snapshot
+	QCHECK(Reader.Pin()->GetVersion() == 5);
+}
+
+QTEST(Snapshot, ReaderSlotsAreLimited)
+{
+	FQSnapshotPublisher Publisher;
+	std::vector<std::unique_ptr<FQSnapshotReader>> Readers;
+	for (int32_t Index = 0; Index < MaxSnapshotReaders; ++Index) Readers.push_back(std::make_unique<FQSnapshotReader>(Publisher));
+	FQSnapshotReader Extra(Publisher);
+	QCHECK(Readers.back()->IsValid() && !Extra.IsValid() && !Extra.Pin());
+
+	Readers.pop_back();
+	QCHECK(FQSnapshotReader(Publisher).IsValid());
+}
+
+QTEST(Snapshot, ReadersAlwaysSeeAConsistentTable)
+{
+	// Every row of a given version holds that version's value: a torn or recycled snapshot would mix them
+	const std::unique_ptr<IQTable> Table = MakeTable(ETableBackend::Map, TestNumActions, 0);
+	FQSnapshotPublisher Publisher;
+	std::atomic<bool> bDone{ false };
+	std::atomic<int32_t> NumBad{ 0 };
+
+	std::vector<std::thread> Threads;
+	for (int32_t Thread = 0; Thread < 4; ++Thread)
+	{
+		Threads.emplace_back([&]()
+		{
+			FQSnapshotReader Reader(Publisher);
+			while (!bDone.load())
+			{
+				const FQSnapshotReader::FPin Pin = Reader.Pin();
+				if (!Pin) continue;
+				const float Expected = static_cast<float>(Pin->GetVersion());
+				Pin->ForEachRow([&](FQKey, const float* Row) { if (Row[0] != Expected) ++NumBad; });
+			}
+		});
+	}
+
+	for (int32_t Version = 1; Version <= 2000; ++Version)
+	{
+		for (FQKey Key = 0; Key < 32; ++Key) Table->FindOrAddRow(Key)[0] = static_cast<float>(Version);
+		Publisher.Publish(*Table);
+	}
+	bDone = true;
+	for (std::thread& Thread : Threads) Thread.join();
+
+	QCHECK(NumBad.load() == 0);
+	Publisher.Reclaim();
+	QCHECK(Publisher.GetNumRetired() == 0); // nothing pinned any more
+}
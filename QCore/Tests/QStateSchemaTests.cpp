@@ -0,0 +1,85 @@
+#include "QTest.h"
+#include "QTestState.h"
+#include <cstring>
+
+using Schema = FTestState::Schema;
+
+static const FTestState Sample = MakeState(50, 100, 3, true, false, false, true);
+
+static_assert(Schema::TotalBits == 21, "7 + 7 + 3 + 4 bools");
+static_assert(Schema::NumKeys == (1u << 21), "dense key space");
+static_assert(Schema::NumBytes == 3, "binary key width");
+
+QTEST(StateSchema, PackUnpackRoundTrip)
+{
+	const FTestState State = Sample;
+	const FTestState Unpacked = Schema::Unpack(Schema::Pack(State));
+	QCHECK(Schema::Equals(State, Unpacked));
+	QCHECK(Unpacked.HealthPercent == 50);
+	QCHECK(Unpacked.HealsLeft == 3);
+	QCHECK(Unpacked.bWasHitRecently);
+	QCHECK(!Unpacked.bIsTargetGuarding);
+}
+
+QTEST(StateSchema, FirstFieldIsMostSignificant)
+{
+	FTestState Low;
+	FTestState High;
+	High.HealthPercent = 1;
+	Low.TargetHealthPercent = 100;
+	Low.HealsLeft = 7;
+	QCHECK(Schema::Pack(High) > Schema::Pack(Low));
+}
+
+QTEST(StateSchema, OutOfRangeValuesClamp)
+{
+	FTestState State;
+	State.HealthPercent = 127;
+	State.HealsLeft = -3;
+	const FTestState Unpacked = Schema::Unpack(Schema::Pack(State));
+	QCHECK(Unpacked.HealthPercent == 100);
+	QCHECK(Unpacked.HealsLeft == 0);
+}
+
+QTEST(StateSchema, TextFormMatchesLegacyFormat)
+{
+	char Buffer[Schema::MaxStringLength];
+	Schema::WriteString(Sample, Buffer, sizeof(Buffer));
+	QCHECK(std::strcmp(Buffer, "50_100_3_1_0_0_1") == 0);
+
+	FTestState Parsed;
+	QCHECK(Schema::ParseString(Buffer, Parsed));
+	QCHECK(Schema::Equals(Parsed, Sample));
+
+	FTestState Short;
+	QCHECK(!Schema::ParseString("1_2_3", Short));
+	QCHECK(Schema::Pack(Short) == 0);
+}
+
+QTEST(StateSchema, LayoutKeyStringMatchesTemplate)
+{
+	const QCore::FQKeyLayout Layout = QCore::MakeKeyLayout<Schema>();
+	QCHECK(Layout.NumFields == 7);
+
+	char Buffer[64];
+	QCore::WriteKeyString(Schema::Pack(Sample), Layout, Buffer, sizeof(Buffer));
+	QCHECK(std::strcmp(Buffer, "50_100_3_1_0_0_1") == 0);
+
+	QCore::FQKey Key = 0;
+	QCHECK(QCore::ParseKeyString(Buffer, Buffer + std::strlen(Buffer), Layout, Key));
+	QCHECK(Key == Schema::Pack(Sample));
+}
+
+QTEST(StateSchema, BinaryCodecAndFloats)
+{
+	uint8_t Bytes[Schema::NumBytes];
+	Schema::WriteBytes(Sample, Bytes);
+	QCHECK(Schema::Equals(Schema::ReadBytes(Bytes), Sample));
+
+	float Floats[Schema::NumFields];
+	Schema::ToFloats(Sample, Floats);
+	QCHECK(Floats[0] == 50.f);
+	QCHECK(Floats[1] == 100.f);
+	QCHECK(Floats[3] == 1.f);
+	QCHECK(Floats[4] == 0.f);
+}
@@ -0,0 +1,317 @@
+#include "QTest.h"
+#include "QTestState.h"
+#include "QCore/QAtomicDenseTable.h"
+#include "QCore/QShardedTable.h"
+#include "QCore/QStateIndex.h"
+#include "QCore/QTable.h"
+#include <thread>
+
+using namespace QCore;
+
+static void CheckBackend(const ETableBackend Backend)
+{
+	const std::unique_ptr<IQTable> Table = MakeTable(Backend, TestNumActions, FTestState::Schema::NumKeys);
+	QCHECK(Table && Table->GetBackend() == Backend);
+	QCHECK(Table->Num() == 0);
+	QCHECK(!Table->Contains(42));
+	QCHECK(!Table->FindRow(42));
+
+	const FQRow Row = Table->FindOrAddRow(42);
+	QCHECK(Table->Contains(42));
+	QCHECK(Table->Num() == 1);
+	QCHECK(Row[0] == 0.f && Row[TestNumActions - 1] == 0.f);
+	QCHECK(Row[TestNumActions] == RowPadding);
+
+	Row[1] = 2.5f;
+	QCHECK(Table->FindOrAddRow(42) == Row); // existing row
+	QCHECK(Table->FindRow(42)[1] == 2.5f);
+	QCHECK(Table->Num() == 1);
+
+	const FQConstRow ConstRow = static_cast<const IQTable&>(*Table).FindRow(42); // handle spans the actions only
+	QCHECK(ConstRow == FQConstRow(Row) && ConstRow.Num() == TestNumActions);
+	float Sum = 0.f;
+	for (const float Value : ConstRow) Sum += Value;
+	QCHECK(Sum == 2.5f);
+	QCHECK(ConstRow.GetData()[RowWidth - 1] == RowPadding);
+
+	Table->FindOrAddRow(7);
+	int32_t Visited = 0;
+	Table->ForEachRow([&Visited](const FQKey Key, const float*) { Visited += (Key == 7 || Key == 42) ? 1 : 100; });
+	QCHECK(Visited == 2);
+
+	Table->Empty();
+	QCHECK(Table->Num() == 0);
+	QCHECK(!Table->Contains(42));
+}
+
+QTEST(Table, MapBackend) { CheckBackend(ETableBackend::Map); }
+QTEST(Table, DenseBackend) { CheckBackend(ETableBackend::Dense); }
+
+static void CheckVisitCounts(const ETableBackend Backend, const EQValueType ValueType)
+{
+	const std::unique_ptr<IQTable> Table = MakeTable(Backend, TestNumActions, FTestState::Schema::NumKeys, ValueType);
+	Table->FindOrAddRow(3);
+	QCHECK(!Table->HasVisitCounts() && Table->GetVisitCount(3, 0) == 0);
+	QCHECK(Table->EnableVisitCounts() && Table->HasVisitCounts());
+
+	uint32_t* Counts;
+	QCHECK(Table->FindOrAddCountedRowData(3, Counts) && Counts && Counts[0] == 0); // existing rows start at 0
+	Counts[1] = 5;
+	for (FQKey Key = 100; Key < 2000; ++Key) Table->FindOrAddRow(Key); // counts never move
+	QCHECK(Table->GetVisitCount(3, 1) == 5 && Table->GetVisitCount(1999, 1) == 0 && Table->GetVisitCount(2000, 1) == 0);
+
+	const uint32_t Stored[TestNumActions] = { 1, 2, 3, 4, 5 };
+	Table->StoreVisitCounts(4000, Stored);
+	QCHECK(Table->Contains(4000) && Table->GetVisitCount(4000, 4) == 5);
+
+	Table->Empty();
+	QCHECK(Table->FindOrAddCountedRowData(3, Counts) && Counts[1] == 0);
+}
+
+QTEST(Table, MapVisitCounts) { CheckVisitCounts(ETableBackend::Map, EQValueType::Float); }
+QTEST(Table, DenseVisitCounts) { CheckVisitCounts(ETableBackend::Dense, EQValueType::Int16); }
+
+QTEST(Table, AtomicTablesHaveNoVisitCounts)
+{
+	const std::unique_ptr<IQTable> Table = MakeTable(ETableBackend::Dense, TestNumActions, FTestState::Schema::NumKeys, EQValueType::AtomicFloat);
+	QCHECK(!Table->EnableVisitCounts() && !Table->HasVisitCounts());
+
+	uint32_t* Counts;
+	QCHECK(Table->FindOrAddCountedRowData(3, Counts) && !Counts);
+}
+
+QTEST(Table, MemoryCapEvictsRowsNotUsedSinceTheLastSweep)
+{
+	const std::unique_ptr<IQTable> Table = MakeTable(ETableBackend::Map, TestNumActions, 0);
+	QCHECK(Table->SetMemoryLimit(16 * 1024));
+	const FQKey MaxRows = Table->GetMaxRows();
+	QCHECK(MaxRows > 8 && MaxRows < 1024);
+
+	for (FQKey Key = 0; Key <= MaxRows; ++Key) Table->FindOrAddRow(Key)[0] = 1.f; // the last insert sweeps every bit clear, evicts 0
+	QCHECK(Table->Num() == MaxRows && Table->GetNumEvicted() == 1 && !Table->Contains(0));
+
+	const FQKey NumUsed = MaxRows / 2;
+	for (FQKey Key = 1; Key <= NumUsed; ++Key) QCHECK(Table->FindRow(Key));
+	const FQKey NumUnused = MaxRows - 2 - NumUsed; // also kept: MaxRows (new rows start referenced) and MaxRows - 1 (spared as the last lookup)
+	for (FQKey Key = 0; Key < NumUnused; ++Key) Table->FindOrAddRow(1000 + Key);
+
+	QCHECK(Table->Num() == MaxRows && Table->GetNumEvicted() == 1 + NumUnused);
+	for (FQKey Key = 1; Key <= MaxRows; ++Key) QCHECK(Table->Contains(Key) == (Key <= NumUsed || Key >= MaxRows - 1));
+	QCHECK(Table->GetAllocatedSize() <= 16 * 1024 + 1024); // bucket array rounding
+
+	const FQRow Held = Table->FindRow(MaxRows); // the last lookup survives the next insert
+	Table->FindOrAddRow(5000);
+	QCHECK(Table->FindRow(MaxRows) == Held);
+
+	Table->Empty();
+	for (FQKey Key = 0; Key < 10 * MaxRows; ++Key) Table->FindOrAddRow(Key);
+	QCHECK(Table->Num() == MaxRows);
+}
+
+QTEST(Table, MemoryCapLeastVisitedKeepsWellVisitedRows)
+{
+	const std::unique_ptr<IQTable> Table = MakeTable(ETableBackend::Map, TestNumActions, 0, EQValueType::Int16);
+	QCHECK(Table->EnableVisitCounts());
+	QCHECK(Table->SetMemoryLimit(4 * 1024, EQEvictionPolicy::LeastVisited));
+	const FQKey MaxRows = Table->GetMaxRows();
+
+	const uint32_t Visited[TestNumActions] = { 3, 0, 0, 0, 0 };
+	for (FQKey Key = 0; Key < MaxRows; ++Key)
+	{
+		if (Key % EvictionSamples != 5) Table->StoreVisitCounts(Key, Visited);
+		else Table->FindOrAddRow(Key);
+	}
+	for (FQKey Key = 0; Key < MaxRows / EvictionSamples; ++Key) Table->FindOrAddRow(1000 + Key); // one unvisited row per window
+
+	QCHECK(Table->GetNumEvicted() == MaxRows / EvictionSamples);
+	for (FQKey Key = 0; Key < MaxRows; ++Key) QCHECK(Table->Contains(Key) == (Key % EvictionSamples != 5 || Key >= MaxRows / EvictionSamples * EvictionSamples));
+	QCHECK(Table->GetVisitCount(1000, 0) == 0); // freed counts are reset for the new row
+}
+
+QTEST(Table, MemoryCapUnsupportedBackends)
+{
+	QCHECK(!MakeTable(ETableBackend::Dense, TestNumActions, FTestState::Schema::NumKeys)->SetMemoryLimit(1024));
+	QCHECK(!MakeTable(ETableBackend::Sharded, TestNumActions, 0, EQValueType::AtomicFloat)->SetMemoryLimit(1024));
+	QCHECK(MakeTable(ETableBackend::Dense, TestNumActions, FTestState::Schema::NumKeys)->SetMemoryLimit(0));
+}
+
+QTEST(Table, DenseRejectsHugeKeySpace)
+{
+	QCHECK(MakeTable(ETableBackend::Dense, TestNumActions, 0) == nullptr);
+	QCHECK(MakeTable(ETableBackend::Dense, TestNumActions, MaxDenseKeys + 1) == nullptr);
+}
+
+QTEST(Table, DenseIndexedByBuckets)
+{
+	FQDiscretizer Discretizer(MakeKeyLayout<FTestState::Schema>());
+	const int32_t Edges[] = { 20, 40, 60, 80 };
+	Discretizer.SetBucketEdges("HealthPercent", Edges, 4);
+	Discretizer.SetBucketEdges("TargetHealthPercent", Edges, 4);
+	const std::shared_ptr<const FQStateIndex> Index = std::make_shared<FQStateIndex>(Discretizer);
+	QCHECK(Index->GetNumStates() == Discretizer.CountReachableKeys());
+
+	const EQValueType ValueTypes[] = { EQValueType::Float, EQValueType::Int16, EQValueType::AtomicFloat };
+	for (const EQValueType ValueType : ValueTypes)
+	{
+		const std::unique_ptr<IQTable> Table = MakeTable(ETableBackend::Dense, TestNumActions, Index, ValueType);
+		const std::unique_ptr<IQTable> Unindexed = MakeTable(ETableBackend::Dense, TestNumActions, FTestState::Schema::NumKeys, ValueType);
+		QCHECK(Table && Table->GetAllocatedSize() * 100 < Unindexed->GetAllocatedSize()); // 3200 rows, not 2M
+
+		const FQKey Key = Discretizer.Apply(FTestState{ 37, 99, 3 }.ToKey());
+		const float Values[TestNumActions] = { 1.f, 2.f, 3.f, 4.f, 5.f };
+		Table->StoreRow(Key, Values);
+		QCHECK(Table->Contains(Key) && !Table->Contains(Discretizer.Apply(FTestState{ 90, 99, 3 }.ToKey())) && Table->Num() == 1);
+
+		float Loaded[RowWidth];
+		QCHECK(Table->LoadRow(Key, Loaded) && Loaded[TestNumActions] == RowPadding);
+		QCHECK_NEAR(Loaded[4], 5.f, 0.01f); // Int16 quantizes
+		int32_t Visited = 0;
+		Table->ForEachRow([&](const FQKey RowKey, const float*) { Visited += RowKey == Key; }); // bucketed key reported back
+		QCHECK(Visited == 1);
+	}
+	QCHECK(!MakeTable(ETableBackend::Dense, TestNumActions, std::shared_ptr<const FQStateIndex>()));
+}
+
+QTEST(Table, MergeAverage)
+{
+	const std::unique_ptr<IQTable> Merged = MakeTable(ETableBackend::Map, TestNumActions, 0);
+	const std::unique_ptr<IQTable> Enemy = MakeTable(ETableBackend::Dense, TestNumActions, FTestState::Schema::NumKeys);
+
+	Merged->FindOrAddRow(1)[0] = 4.f;
+	Enemy->FindOrAddRow(1)[0] = 2.f;
+	Enemy->FindOrAddRow(2)[3] = -1.f;
+
+	MergeAverage(*Merged, *Enemy);
+	QCHECK(Merged->Num() == 2);
+	QCHECK(Merged->FindRow(1)[0] == 3.f);
+	QCHECK(Merged->FindRow(2)[3] == -1.f);
+}
+
+static void CheckInt16Backend(const ETableBackend Backend)
+{
+	const std::unique_ptr<IQTable> Table = MakeTable(Backend, TestNumActions, FTestState::Schema::NumKeys, EQValueType::Int16, 100.f);
+	QCHECK(Table->GetValueType() == EQValueType::Int16);
+	QCHECK(!Table->FindOrAddRow(3)); // float handle on an Int16 table
+	QCHECK(Table->Contains(3));
+
+	const FQRow16 Row = Table->FindOrAddRowAs<int16_t>(3);
+	QCHECK(Row && Row[0] == 0 && Row.GetData()[RowWidth - 1] == RowPadding16);
+
+	const float Values[TestNumActions] = { 1.f, -2.5f, 99.99f, 150.f, 0.001f };
+	Table->StoreRow(3, Values);
+	float Loaded[RowWidth];
+	QCHECK(Table->LoadRow(3, Loaded));
+	for (int32_t Action = 0; Action < 3; ++Action) QCHECK_NEAR(Loaded[Action], Values[Action], Table->GetValueScale() / 2.f);
+	QCHECK_NEAR(Loaded[3], 100.f, 1e-4f); // saturates at the range
+	QCHECK(Loaded[TestNumActions] == RowPadding);
+
+	int32_t Visited = 0;
+	Table->ForEachRow([&](const FQKey Key, const float* Dequantized) { Visited += Key == 3 && Dequantized[1] == Loaded[1]; });
+	QCHECK(Visited == 1);
+}
+
+QTEST(Table, Int16MapBackend) { CheckInt16Backend(ETableBackend::Map); }
+QTEST(Table, Int16DenseBackend) { CheckInt16Backend(ETableBackend::Dense); }
+
+QTEST(Table, Int16HalvesDenseMemory)
+{
+	const std::unique_ptr<IQTable> Float = MakeTable(ETableBackend::Dense, TestNumActions, FTestState::Schema::NumKeys);
+	const std::unique_ptr<IQTable> Int16 = MakeTable(ETableBackend::Dense, TestNumActions, FTestState::Schema::NumKeys, EQValueType::Int16);
+	const size_t BitsetBytes = FTestState::Schema::NumKeys / 8;
+	QCHECK((Int16->GetAllocatedSize() - BitsetBytes) * 2 == Float->GetAllocatedSize() - BitsetBytes);
+}
+
+QTEST(Table, AtomicDenseBackend)
+{
+	QCHECK(!MakeTable(ETableBackend::Map, TestNumActions, 0, EQValueType::AtomicFloat));
+
+	const std::unique_ptr<IQTable> Table = MakeTable(ETableBackend::Dense, TestNumActions, FTestState::Schema::NumKeys, EQValueType::AtomicFloat);
+	QCHECK(Table && Table->GetValueType() == EQValueType::AtomicFloat);
+	QCHECK(!Table->FindOrAddRow(3)); // float handle on an AtomicFloat table
+	QCHECK(Table->Contains(3) && Table->Num() == 1);
+
+	const FQAtomicRow Row = Table->FindOrAddRowAs<std::atomic<float>>(4);
+	QCHECK(Row && Row[0].load() == 0.f && Row.GetData()[RowWidth - 1].load() == RowPadding);
+	AtomicAdd(Row[2], 1.5f);
+
+	float Loaded[RowWidth];
+	QCHECK(Table->LoadRow(4, Loaded) && Loaded[2] == 1.5f && Loaded[TestNumActions] == RowPadding);
+	QCHECK(!Table->LoadRow(5, Loaded));
+}
+
+QTEST(Table, AtomicDenseConcurrentUpdatesAreNotLost)
+{
+	FQAtomicDenseTable Table(TestNumActions, 1024);
+	constexpr int32_t NumThreads = 4;
+	constexpr int32_t NumAdds = 100000;
+
+	std::vector<std::thread> Threads;
+	for (int32_t Thread = 0; Thread < NumThreads; ++Thread)
+	{
+		Threads.emplace_back([&Table]()
+		{
+			for (int32_t Add = 0; Add < NumAdds; ++Add)
+			{
+				std::atomic<float>* Row = static_cast<std::atomic<float>*>(Table.FindOrAddRowData(static_cast<FQKey>(Add % 1024)));
+				AtomicAdd(Row[1], 1.f);
+			}
+		});
+	}
+	for (std::thread& Thread : Threads) Thread.join();
+
+	QCHECK(Table.Num() == 1024); // each new row counted once
+	double Sum = 0.0;
+	Table.ForEachRow([&Sum](FQKey, const float* Row) { Sum += Row[1]; });
+	QCHECK(Sum == static_cast<double>(NumThreads) * NumAdds);
+}
+
+QTEST(Table, ShardedBackendWideKeys)
+{
+	QCHECK(!MakeTable(ETableBackend::Sharded, TestNumActions, 0)); // AtomicFloat only
+	const std::unique_ptr<IQTable> Table = MakeTable(ETableBackend::Sharded, TestNumActions, 0, EQValueType::AtomicFloat);
+	QCHECK(Table && Table->GetBackend() == ETableBackend::Sharded);
+
+	// Keys well past any dense key space; the first handle must survive every shard growing
+	const FQKey FirstKey = uint64_t(1) << 60;
+	const FQAtomicRow First = Table->FindOrAddRowAs<std::atomic<float>>(FirstKey);
+	AtomicAdd(First[4], 2.f);
+	for (uint64_t Index = 1; Index < 20000; ++Index) Table->FindOrAddRowData(FirstKey + Index * 0x10001);
+
+	QCHECK(Table->Num() == 20000);
+	QCHECK(Table->FindRowAs<std::atomic<float>>(FirstKey) == First && First[4].load() == 2.f);
+	QCHECK(Table->Contains(FirstKey + 19999 * 0x10001) && !Table->Contains(FirstKey + 1));
+	QCHECK(First.GetData()[RowWidth - 1].load() == RowPadding);
+
+	size_t Visited = 0;
+	Table->ForEachRow([&Visited](FQKey, const float*) { ++Visited; });
+	QCHECK(Visited == 20000);
+
+	Table->Empty();
+	QCHECK(Table->Num() == 0 && !Table->Contains(FirstKey));
+}
+
+QTEST(Table, ShardedConcurrentInsertsAndUpdates)
+{
+	FQShardedTable Table(TestNumActions, 8);
+	constexpr int32_t NumThreads = 8;
+	constexpr int32_t NumKeys = 5000;
+
+	std::vector<std::thread> Threads;
+	for (int32_t Thread = 0; Thread < NumThreads; ++Thread)
+	{
+		Threads.emplace_back([&Table, Thread]()
+		{
+			for (int32_t Step = 0; Step < NumKeys * 4; ++Step)
+			{
+				const FQKey Key = static_cast<FQKey>((Step * 7 + Thread) % NumKeys) << 40; // every thread inserts every key
+				AtomicAdd(static_cast<std::atomic<float>*>(Table.FindOrAddRowData(Key))[0], 1.f);
+			}
+		});
+	}
+	for (std::thread& Thread : Threads) Thread.join();
+
+	QCHECK(Table.Num() == NumKeys);
+	double Sum = 0.0;
+	Table.ForEachRow([&Sum](FQKey, const float* Row) { Sum += Row[0]; });
+	QCHECK(Sum == static_cast<double>(NumThreads) * NumKeys * 4);
+}
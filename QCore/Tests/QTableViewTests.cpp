@@ -0,0 +1,217 @@
+#include "QTest.h"
+#include "QTestState.h"
+#include "QCore/QDiscretizer.h"
+#include "QCore/QLearner.h"
+#include "QCore/QMapTable.h"
+#include "QCore/QOverlayTable.h"
+#include "QCore/QPersistence.h"
+#include <cstdio>
+
+using namespace QCore;
+
+using FAlignedBytes = std::vector<char, TAlignedAllocator<char, RowAlignment>>;
+
+/* The saved bytes in an aligned buffer, as a mapping would hand them over */
+static std::shared_ptr<const FQTableView> MakeView(const IQTable& Table, const FQKeyLayout& Layout)
+{
+	const std::string Bytes = WriteTableBinary(Table, Layout, true);
+	const std::shared_ptr<FAlignedBytes> Buffer = std::make_shared<FAlignedBytes>(Bytes.begin(), Bytes.end());
+	return std::make_shared<FQTableView>(Buffer->data(), Buffer->size(), Layout, Buffer);
+}
+
+static std::unique_ptr<IQTable> MakeFilledTable(const EQValueType ValueType = EQValueType::Float)
+{
+	std::unique_ptr<IQTable> Table = MakeTable(ETableBackend::Map, TestNumActions, 0, ValueType);
+	for (FQKey Key = 1; Key <= 50; ++Key)
+	{
+		const float Values[TestNumActions] = { 0.5f * Key, -1.f, 0.f, 2.f, -0.25f * Key };
+		Table->StoreRow(Key * 131, Values);
+	}
+	return Table;
+}
+
+QTEST(TableView, AlignedRowsAreUsedInPlace)
+{
+	const FQKeyLayout Layout = MakeKeyLayout<FTestState::Schema>();
+	const std::unique_ptr<IQTable> Table = MakeFilledTable();
+
+	const std::string Aligned = WriteTableBinary(*Table, Layout, true);
+	QCHECK(Aligned.size() == 576 + 50 * RowWidth * 4); // 40 + 7 * 16 header and fields + 400 of keys = 552, aligned to 576
+
+	const std::unique_ptr<IQTable> Loaded = MakeTable(ETableBackend::Dense, TestNumActions, FTestState::Schema::NumKeys);
+	QCHECK(ReadTable(*Loaded, Layout, Aligned.data(), Aligned.size()) && Loaded->Num() == 50);
+	QCHECK(CompareTables(*Table, *Loaded).MaxAbsError == 0.f);
+
+	const std::shared_ptr<const FQTableView> View = MakeView(*Table, Layout);
+	QCHECK(View->IsValid() && View->Num() == 50 && View->GetIndexSize() == 128 * sizeof(uint32_t));
+	const float* Row = static_cast<const float*>(View->FindRowData(7 * 131));
+	QCHECK(Row && reinterpret_cast<uintptr_t>(Row) % RowAlignment == 0);
+	QCHECK(Row[0] == 3.5f && Row[4] == -1.75f && Row[TestNumActions] == RowPadding && Row[RowWidth - 1] == RowPadding);
+	QCHECK(!View->FindRowData(7) && !View->GetVisitCounts(0));
+
+	size_t NumVisited = 0;
+	View->ForEachRow([&](const FQKey Key, const float* Values) { NumVisited += Table->FindRow(Key)[0] == Values[0]; });
+	QCHECK(NumVisited == 50);
+}
+
+QTEST(TableView, RejectsPackedMisalignedAndCorruptFiles)
+{
+	const FQKeyLayout Layout = MakeKeyLayout<FTestState::Schema>();
+	const std::unique_ptr<IQTable> Table = MakeFilledTable();
+
+	const std::string Packed = WriteTableBinary(*Table, Layout);
+	const FAlignedBytes PackedBuffer(Packed.begin(), Packed.end());
+	QCHECK(!FQTableView(PackedBuffer.data(), PackedBuffer.size(), Layout).IsValid()); // rows aren't where the kernels can use them
+
+	const std::string Aligned = WriteTableBinary(*Table, Layout, true);
+	FAlignedBytes Shifted(Aligned.size() + 8);
+	std::copy(Aligned.begin(), Aligned.end(), Shifted.begin() + 8);
+	QCHECK(!FQTableView(Shifted.data() + 8, Aligned.size(), Layout).IsValid());
+
+	FAlignedBytes Corrupt(Aligned.begin(), Aligned.end());
+	Corrupt[Corrupt.size() - 5] ^= 1;
+	const FQTableView CorruptView(Corrupt.data(), Corrupt.size(), Layout);
+	QCHECK(!CorruptView.IsValid() && !CorruptView.FindRowData(131) && CorruptView.Num() == 0);
+}
+
+QTEST(TableView, OverlaysCopyOnWriteAndShareTheBase)
+{
+	const FQKeyLayout Layout = MakeKeyLayout<FTestState::Schema>();
+	const std::shared_ptr<const FQTableView> View = MakeView(*MakeFilledTable(), Layout);
+	FQOverlayTable First(View);
+	FQOverlayTable Second(View);
+	QCHECK(First.GetBackend() == ETableBackend::Overlay && First.Num() == 50);
+	QCHECK(First.GetAllocatedSize() == FQMapTable(TestNumActions).GetAllocatedSize()); // the shared rows aren't counted
+
+	// Const reads come straight from the view
+	const IQTable& ConstFirst = First;
+	QCHECK(ConstFirst.FindRow(131).GetData() == View->FindRowData(131));
+	QCHECK(First.GetNumWritten() == 0);
+
+	First.FindRow(131)[0] = 99.f; // non-const lookup: a private copy
+	First.FindOrAddRow(5)[1] = 1.f; // a new row
+	QCHECK(First.GetNumWritten() == 2 && First.GetNumShadowed() == 1 && First.Num() == 51);
+	QCHECK(First.FindRow(131)[0] == 99.f && First.FindRow(131)[4] == -0.25f);
+	QCHECK(static_cast<const float*>(View->FindRowData(131))[0] == 0.5f);
+	QCHECK(Second.FindRow(131)[0] == 0.5f && !Second.Contains(5) && Second.Num() == 50);
+	QCHECK(!First.FindRow(6) && First.GetNumWritten() == 2); // a missing row isn't added by a lookup
+
+	size_t NumRows = 0;
+	float Sum = 0.f;
+	First.ForEachRow([&](const FQKey, const float* Row) { ++NumRows; Sum += Row[0]; });
+	QCHECK(NumRows == 51);
+	QCHECK_NEAR(Sum, 0.5f * (50 * 51 / 2) - 0.5f + 99.f, 1e-3f); // the private copy replaces the shared row
+
+	First.Empty();
+	QCHECK(First.Num() == 0 && !First.Contains(131) && Second.Num() == 50);
+}
+
+QTEST(TableView, Int16OverlayKeepsRawValuesAndCounts)
+{
+	const FQKeyLayout Layout = MakeKeyLayout<FTestState::Schema>();
+	const std::unique_ptr<IQTable> Table = MakeFilledTable(EQValueType::Int16);
+	QCHECK(Table->EnableVisitCounts());
+	const uint32_t Counts[TestNumActions] = { 1, 2, 3, 4, 5 };
+	Table->StoreVisitCounts(262, Counts);
+
+	const std::shared_ptr<const FQTableView> View = MakeView(*Table, Layout);
+	QCHECK(View->IsValid() && View->HasVisitCounts() && View->GetValueScale() == Table->GetValueScale());
+
+	FQOverlayTable Overlay(View);
+	QCHECK(Overlay.GetValueType() == EQValueType::Int16 && Overlay.EnableVisitCounts());
+	QCHECK(Overlay.GetVisitCount(262, 4) == 5 && Overlay.GetVisitCount(393, 0) == 0);
+
+	uint32_t* RowCounts;
+	const FQRow16 Row = Overlay.FindRowAs<int16_t>(262, RowCounts); // copies the counts with the row
+	QCHECK(Row && RowCounts && RowCounts[2] == 3);
+	++RowCounts[2];
+	QCHECK(Overlay.GetVisitCount(262, 2) == 4 && View->GetVisitCounts(View->FindRowIndex(262))[2] == 3);
+
+	const FQConstRow16 Original = static_cast<const IQTable&>(*Table).FindRowAs<int16_t>(262);
+	for (int32_t Action = 0; Action < TestNumActions; ++Action) QCHECK(Row[Action] == Original[Action]);
+	QCHECK(CompareTables(*Table, Overlay).MaxAbsError == 0.f);
+}
+
+QTEST(TableView, LearnerOnOverlayMatchesLearnerOnCopy)
+{
+	const FQKeyLayout Layout = MakeKeyLayout<FTestState::Schema>();
+	const std::unique_ptr<IQTable> Saved = MakeFilledTable();
+	const std::shared_ptr<const FQTableView> View = MakeView(*Saved, Layout);
+
+	FQLearner OnCopy;
+	FQLearner OnOverlay;
+	std::shared_ptr<IQTable> Copy = MakeTable(ETableBackend::Map, TestNumActions, 0);
+	MergeAverage(*Copy, *Saved);
+	OnCopy.SetTable(Copy);
+	OnOverlay.SetTable(std::make_shared<FQOverlayTable>(View));
+	for (FQLearner* Learner : { &OnCopy, &OnOverlay })
+	{
+		Learner->Config.ExplorationRate = 0.3f;
+		Learner->Config.TraceDecay = 0.5f;
+		Learner->SeedRandom(11);
+	}
+
+	FQRandom Transitions(5);
+	for (int32_t Step = 0; Step < 2000; ++Step)
+	{
+		const FQKey State = (1 + Transitions.NextBounded(80)) * 131;
+		const FQKey Next = (1 + Transitions.NextBounded(80)) * 131;
+		const float Reward = Transitions.Chance(0.1f) ? 1.f : 0.f;
+		const int32_t Action = OnCopy.ChooseAction(State);
+		QCHECK(OnOverlay.ChooseAction(State) == Action);
+		OnCopy.UpdateQValue(State, Action, Reward, Next);
+		OnOverlay.UpdateQValue(State, Action, Reward, Next);
+	}
+
+	const FQTableComparison Comparison = CompareTables(*Copy, *OnOverlay.GetTable());
+	QCHECK(Comparison.NumMissing == 0 && Comparison.MaxAbsError == 0.f);
+	QCHECK(OnOverlay.GetTable()->Num() == Copy->Num());
+	QCHECK(static_cast<const float*>(View->FindRowData(131))[0] == 0.5f); // the shared rows never change
+}
+
+QTEST(TableView, DiscretizedViewIsLeftShared)
+{
+	const FQKeyLayout Layout = MakeKeyLayout<FTestState::Schema>();
+	FQDiscretizer Discretizer(Layout);
+	const int32_t Edges[] = { 20, 40, 60, 80 };
+	QCHECK(Discretizer.SetBucketEdges("HealthPercent", Edges, 4));
+
+	const std::unique_ptr<IQTable> Table = MakeTable(ETableBackend::Map, TestNumActions, 0);
+	FTestState State;
+	State.HealthPercent = 40;
+	Table->FindOrAddRow(State.ToKey())[0] = 1.f;
+	const std::shared_ptr<const FQTableView> View = MakeView(*Table, Layout);
+	QCHECK(View->IsDiscretizedBy(Discretizer));
+
+	FQOverlayTable Overlay(View);
+	DiscretizeTable(Overlay, Discretizer);
+	QCHECK(Overlay.GetBase() && Overlay.GetNumWritten() == 0);
+
+	State.HealthPercent = 45;
+	Table->FindOrAddRow(State.ToKey())[0] = 3.f;
+	QCHECK(!MakeView(*Table, Layout)->IsDiscretizedBy(Discretizer));
+}
+
+QTEST(TableView, MapTableFileRoundTrip)
+{
+	const FQKeyLayout Layout = MakeKeyLayout<FTestState::Schema>();
+	const std::unique_ptr<IQTable> Table = MakeFilledTable();
+	const std::string Path = "QTableViewTest.qtable";
+	QCHECK(SaveTableBinaryFile(*Table, Layout, Path, true));
+
+	{
+		std::shared_ptr<const FQTableView> View = MapTableFile(Path, Layout);
+		QCHECK(View && View->Num() == 50);
+		FQOverlayTable Overlay(View);
+		View.reset(); // the overlay keeps the mapping alive
+		QCHECK(CompareTables(*Table, Overlay).MaxAbsError == 0.f && Overlay.Num() == 50);
+	} // unmapped before the file is rewritten in place below
+
+	const std::unique_ptr<IQTable> Loaded = MakeTable(ETableBackend::Map, TestNumActions, 0);
+	QCHECK(LoadTableFile(*Loaded, Layout, Path) && Loaded->Num() == 50); // still an ordinary table file
+
+	QCHECK(SaveTableBinaryFile(*Table, Layout, Path));
+	QCHECK(!MapTableFile(Path, Layout)); // packed rows
+	std::remove(Path.c_str());
+	QCHECK(!MapTableFile(Path, Layout));
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+
+/*
+ * Minimal self-registering test harness (no third-party dependency so the Linux build stays self-contained)
+ *	QTEST(Suite, Name) { QCHECK(Condition); QCHECK_NEAR(A, B, Tolerance); }
+ */
+namespace QTest
+{
+	using FTestFunc = void (*)();
+
+	struct FTestCase
+	{
+		const char* Suite;
+		const char* Name;
+		FTestFunc Func;
+	};
+
+	inline std::vector<FTestCase>& GetRegistry()
+	{
+		static std::vector<FTestCase> Registry;
+		return Registry;
+	}
+
+	inline int& GetFailureCount()
+	{
+		static int Failures = 0;
+		return Failures;
+	}
+
+	struct FRegistrar
+	{
+		FRegistrar(const char* Suite, const char* Name, const FTestFunc Func) { GetRegistry().push_back({ Suite, Name, Func }); }
+	};
+
+	inline void ReportFailure(const char* File, const int Line, const char* Expression)
+	{
+		std::printf("  FAILED %s:%d: %s\n", File, Line, Expression);
+		++GetFailureCount();
+	}
+}
+
+#define QTEST(Suite, Name) \
+	static void QTest_##Suite##_##Name(); \
+	static QTest::FRegistrar QTestRegistrar_##Suite##_##Name(#Suite, #Name, &QTest_##Suite##_##Name); \
+	static void QTest_##Suite##_##Name()
+
+#define QCHECK(Condition) \
+	do { if (!(Condition)) QTest::ReportFailure(__FILE__, __LINE__, #Condition); } while (0)
+
+#define QCHECK_NEAR(A, B, Tolerance) \
+	do { if (!(std::fabs(static_cast<double>(A) - static_cast<double>(B)) <= (Tolerance))) QTest::ReportFailure(__FILE__, __LINE__, #A " ~= " #B); } while (0)
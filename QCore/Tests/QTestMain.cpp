@@ -0,0 +1,23 @@
+#include "QTest.h"
+#include <cstring>
+
+
+/* Runs every registered test, or only suites whose name matches argv[1] */
+int main(int Argc, char** Argv)
+{
+	const char* Filter = Argc > 1 ? Argv[1] : nullptr;
+	int NumRun = 0;
+
+	for (const QTest::FTestCase& Test : QTest::GetRegistry())
+	{
+		if (Filter && std::strcmp(Filter, Test.Suite) != 0) continue;
+
+		const int FailuresBefore = QTest::GetFailureCount();
+		Test.Func();
+		std::printf("[%s] %s.%s\n", QTest::GetFailureCount() == FailuresBefore ? " OK " : "FAIL", Test.Suite, Test.Name);
+		++NumRun;
+	}
+
+	std::printf("%d tests, %d failed checks\n", NumRun, QTest::GetFailureCount());
+	return QTest::GetFailureCount() == 0 && NumRun > 0 ? 0 : 1;
+}
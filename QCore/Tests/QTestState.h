@@ -0,0 +1,58 @@
+#pragma once
+
+#include "QCore/QLearner.h"
+#include "QCore/QStateSchema.h"
+
+
+/* Stand-in for the UE FQState (same fields and ranges) */
+struct FTestState
+{
+	int8_t HealthPercent = 0;
+	int8_t TargetHealthPercent = 0;
+	int8_t HealsLeft = 0;
+	bool bIsInAttackRange = false;
+	bool bIsTargetAttacking = false;
+	bool bIsTargetGuarding = false;
+	bool bWasHitRecently = false;
+
+	static constexpr auto Fields = std::make_tuple(
+		QCore::QField(&FTestState::HealthPercent, "HealthPercent", 0, 100),
+		QCore::QField(&FTestState::TargetHealthPercent, "TargetHealthPercent", 0, 100),
+		QCore::QField(&FTestState::HealsLeft, "HealsLeft", 0, 7),
+		QCore::QField(&FTestState::bIsInAttackRange, "bIsInAttackRange"),
+		QCore::QField(&FTestState::bIsTargetAttacking, "bIsTargetAttacking"),
+		QCore::QField(&FTestState::bIsTargetGuarding, "bIsTargetGuarding"),
+		QCore::QField(&FTestState::bWasHitRecently, "bWasHitRecently"));
+	using Schema = QCore::TQStateSchema<FTestState, Fields>;
+
+	QCore::FQKey ToKey() const { return Schema::Pack(*this); }
+};
+
+/* Fields in declaration order, the rest left at their defaults */
+inline FTestState MakeState(const int8_t Health = 0, const int8_t TargetHealth = 0, const int8_t Heals = 0, const bool bInRange = false,
+	const bool bAttacking = false, const bool bGuarding = false, const bool bHit = false)
+{
+	FTestState State;
+	State.HealthPercent = Health;
+	State.TargetHealthPercent = TargetHealth;
+	State.HealsLeft = Heals;
+	State.bIsInAttackRange = bInRange;
+	State.bIsTargetAttacking = bAttacking;
+	State.bIsTargetGuarding = bGuarding;
+	State.bWasHitRecently = bHit;
+	return State;
+}
+
+constexpr int32_t TestNumActions = 5;
+
+/* Greedy learner (alpha 0.5, gamma 0.9) on an empty table over FTestState's keys */
+inline QCore::FQLearner MakeTestLearner(const QCore::ETableBackend Backend, const float TraceDecay = 0.f)
+{
+	QCore::FQLearner Learner;
+	Learner.Config.ExplorationRate = 0.f;
+	Learner.Config.LearningRate = 0.5f;
+	Learner.Config.DiscountFactor = 0.9f;
+	Learner.Config.TraceDecay = TraceDecay;
+	Learner.SetTable(QCore::MakeTable(Backend, TestNumActions, FTestState::Schema::NumKeys));
+	return Learner;
+}
@@ -0,0 +1,110 @@
+#include "QTest.h"
+#include "QCore/QTileCoding.h"
+#include <algorithm>
+
+using namespace QCore;
+
+static int32_t CountShared(const FQTileCoder& Coder, const float* A, const float* B)
+{
+	uint32_t TilesA[FQTileCoder::MaxTilings];
+	uint32_t TilesB[FQTileCoder::MaxTilings];
+	Coder.GetActiveTiles(A, TilesA);
+	Coder.GetActiveTiles(B, TilesB);
+	int32_t Shared = 0;
+	for (int32_t Tiling = 0; Tiling < Coder.GetNumTilings(); ++Tiling) Shared += TilesA[Tiling] == TilesB[Tiling];
+	return Shared;
+}
+
+QTEST(TileCoding, NearbyInputsShareTiles)
+{
+	const FQTileCoder Coder({ { 0.f, 100.f, 5.f }, { 0.f, 1.f, 1.f } }, {});
+	QCHECK(Coder.IsValid() && Coder.GetNumTilings() == 8);
+
+	const float Base[] = { 50.f, 0.f };
+	const float Near[] = { 52.f, 0.f };
+	const float Far[] = { 90.f, 0.f };
+	const float Flag[] = { 50.f, 1.f };
+	QCHECK(CountShared(Coder, Base, Base) == 8); // deterministic
+	QCHECK(CountShared(Coder, Base, Near) >= 6); // 2 of a 20-wide tile apart
+	QCHECK(CountShared(Coder, Base, Far) == 0);
+	QCHECK(CountShared(Coder, Base, Flag) == 0); // bools never share
+
+	const float Clamped[] = { 250.f, -3.f };
+	const float Edge[] = { 100.f, 0.f };
+	QCHECK(CountShared(Coder, Clamped, Edge) == 8);
+}
+
+QTEST(TileCoding, InvalidCodings)
+{
+	QCHECK(!FQTileCoder({ { 0.f, 1.f, 1.f } }, { 8, 1000 }).IsValid()); // not a power of two
+	QCHECK(!FQTileCoder({ { 1.f, 1.f, 1.f } }, {}).IsValid());
+	QCHECK(!FQTileCoder({}, {}).IsValid());
+	QCHECK(!FQTileLearner(RowWidth + 1, { { 0.f, 1.f, 1.f } }).IsValid());
+}
+
+QTEST(TileCoding, LearnerGeneralizesAcrossNearbyStates)
+{
+	// Contextual bandit: action 1 pays below 0.5, action 2 above; only every 10th x is ever trained
+	FQTileLearner Learner(4, { { 0.f, 1.f, 4.f } });
+	QCHECK(Learner.IsValid());
+	Learner.Config.LearningRate = 0.2f;
+	Learner.Config.DiscountFactor = 0.f;
+	Learner.Config.ExplorationRate = 1.f;
+	Learner.SeedRandom(3);
+
+	for (int32_t Step = 0; Step < 4000; ++Step)
+	{
+		const float X[] = { static_cast<float>(Step % 10) / 10.f + 0.05f };
+		const int32_t Action = Learner.ChooseAction(X);
+		const float Reward = Action == (X[0] < 0.5f ? 1 : 2) ? 1.f : 0.f;
+		Learner.UpdateQValue(X, Action, Reward, X);
+	}
+
+	for (const float Probe : { 0.1f, 0.22f, 0.33f, 0.71f, 0.88f })
+	{
+		const float X[] = { Probe };
+		QCHECK(Learner.ChooseGreedyAction(X) == (Probe < 0.5f ? 1 : 2)); // untrained inputs
+	}
+	const float Trained[] = { 0.15f };
+	QCHECK_NEAR(Learner.GetQValue(Trained, 1), 1.f, 0.1f);
+
+	alignas(RowAlignment) float Row[RowWidth];
+	Learner.GetQValues(Trained, Row);
+	QCHECK(Row[4] == RowPadding && Row[1] == Learner.GetQValue(Trained, 1));
+}
+
+QTEST(TileCoding, TDUpdateMovesByLearningRate)
+{
+	FQTileLearner Learner(3, { { 0.f, 10.f, 2.f } }, { 4, 1 << 10 });
+	Learner.Config.LearningRate = 0.5f;
+	Learner.Config.DiscountFactor = 0.9f;
+
+	const float A[] = { 2.f };
+	const float B[] = { 8.f };
+	Learner.UpdateQValue(B, 0, 2.f, B);
+	QCHECK_NEAR(Learner.GetQValue(B, 0), 1.f, 1e-5f);
+	Learner.UpdateQValue(A, 1, 0.f, B); // target = 0.9 * max Q(B) = 0.9
+	QCHECK_NEAR(Learner.GetQValue(A, 1), 0.45f, 1e-5f);
+}
+
+QTEST(TileCoding, WeightsBinaryRoundTrip)
+{
+	const std::vector<FQTileDimension> Dimensions = { { 0.f, 100.f, 5.f }, { 0.f, 1.f, 1.f } };
+	FQTileLearner Learner(5, Dimensions, { 8, 1 << 8 });
+	const float X[] = { 40.f, 1.f };
+	Learner.UpdateQValue(X, 3, 1.f, X);
+
+	const std::string Bytes = WriteTileWeightsBinary(Learner);
+	QCHECK(Bytes.size() == 24 + 2 * 12 + (1 << 8) * 5 * 4);
+
+	FQTileLearner Loaded(5, Dimensions, { 8, 1 << 8 });
+	QCHECK(ReadTileWeightsBinary(Loaded, Bytes.data(), Bytes.size()));
+	QCHECK(Loaded.GetQValue(X, 3) == Learner.GetQValue(X, 3));
+
+	// Other codings and truncated files are rejected
+	FQTileLearner OtherTilings(5, Dimensions, { 4, 1 << 8 });
+	FQTileLearner OtherRange(5, { { 0.f, 50.f, 5.f }, { 0.f, 1.f, 1.f } }, { 8, 1 << 8 });
+	QCHECK(!ReadTileWeightsBinary(OtherTilings, Bytes.data(), Bytes.size()));
+	QCHECK(!ReadTileWeightsBinary(OtherRange, Bytes.data(), Bytes.size()));
+	QCHECK(!ReadTileWeightsBinary(Loaded, Bytes.data(), Bytes.size() - 1));
+}
@@ -0,0 +1,115 @@
+#include "QTest.h"
+#include "QTestState.h"
+#include "QCore/QPrioritizedSweeper.h"
+#include "QCore/QUpdateQueue.h"
+
+using namespace QCore;
+
+QTEST(UpdateQueue, FlushMatchesInlineUpdates)
+{
+	FQLearner Inline = MakeTestLearner(ETableBackend::Map);
+	FQLearner DeferredA = MakeTestLearner(ETableBackend::Map);
+	FQLearner DeferredB = MakeTestLearner(ETableBackend::Map);
+
+	FQUpdateQueue Queue(16);
+	const FQKey Prev[] = { 5, 1, 3, 7 };
+	for (int32_t Step = 0; Step < 4; ++Step)
+	{
+		Inline.UpdateQValue(Prev[Step], Step, 1.f + Step, 0);
+		QCHECK(Queue.Push(DeferredA, Prev[Step], Step, 1.f + Step, 0));
+		QCHECK(Queue.Push(DeferredB, Prev[Step], Step, -1.f, 0));
+	}
+	QCHECK(DeferredA.GetQValue(5, 0) == 0.f); // nothing applied before the flush
+
+	QCHECK(Queue.Flush() == 8);
+	QCHECK(Queue.IsEmpty() && Queue.GetCapacity() == 16);
+	for (const FQKey State : Prev)
+	{
+		for (int32_t Action = 0; Action < TestNumActions; ++Action)
+		{
+			QCHECK(DeferredA.GetQValue(State, Action) == Inline.GetQValue(State, Action));
+		}
+	}
+	QCHECK_NEAR(DeferredB.GetQValue(7, 3), -0.5f, 1e-6);
+}
+
+QTEST(UpdateQueue, SharedTableSortsAcrossLearners)
+{
+	FQLearner A = MakeTestLearner(ETableBackend::Map);
+	FQLearner B = MakeTestLearner(ETableBackend::Map);
+	const std::shared_ptr<IQTable> Shared = MakeTable(ETableBackend::Map, TestNumActions, 0);
+	A.SetTable(Shared);
+	B.SetTable(Shared);
+
+	FQUpdateQueue Queue;
+	Queue.Push(A, 3, 0, 2.f, 0);
+	Queue.Push(B, 1, 0, 4.f, 0);
+	Queue.Push(A, 1, 0, 0.f, 0);
+	QCHECK(Queue.Flush() == 3);
+	QCHECK(A.GetQValue(1, 0) == 1.f); // 0 -> 2 (B) -> 1 (A): same state, push order whichever learner sorts first
+	QCHECK(A.GetQValue(3, 0) == 1.f);
+}
+
+QTEST(UpdateQueue, BatchedFutureQSeesEarlierUpdates)
+{
+	FQLearner Learner = MakeTestLearner(ETableBackend::Map);
+	Learner.GetTable()->FindOrAddRow(6)[1] = 4.f;
+
+	FQUpdateQueue Queue;
+	Queue.Push(Learner, 5, 0, 0.f, 2); // s' = 2 is updated first (sorted by state), read inline after it
+	Queue.Push(Learner, 2, 0, 10.f, 0);
+	Queue.Push(Learner, 1, 0, 0.f, 6); // s' = 6 is never written, read by the batched MaxRows
+	QCHECK(Queue.Flush() == 3);
+	QCHECK_NEAR(Learner.GetQValue(2, 0), 5.f, 1e-6f);
+	QCHECK_NEAR(Learner.GetQValue(5, 0), 0.5f * 0.9f * 5.f, 1e-6f);
+	QCHECK_NEAR(Learner.GetQValue(1, 0), 0.5f * 0.9f * 4.f, 1e-6f);
+}
+
+QTEST(UpdateQueue, FullQueueRejectsPush)
+{
+	FQLearner Learner = MakeTestLearner(ETableBackend::Map);
+	FQUpdateQueue Queue(2);
+	QCHECK(Queue.Push(Learner, 1, 0, 1.f, 2));
+	QCHECK(Queue.PushEndEpisode(Learner));
+	QCHECK(!Queue.Push(Learner, 2, 0, 1.f, 3));
+	QCHECK(Queue.Flush() == 1);
+	QCHECK(Queue.Push(Learner, 2, 0, 1.f, 3));
+}
+
+QTEST(UpdateQueue, FlushFeedsTheSweeper)
+{
+	FQLearner Learner = MakeTestLearner(ETableBackend::Map);
+	FQPrioritizedSweeper Sweeper;
+	FQUpdateQueue Queue;
+	QCHECK(Queue.Push(Learner, 1, 0, 4.f, 2, &Sweeper));
+	QCHECK(Sweeper.NumQueued() == 0); // observed after the update, not at push
+
+	Queue.Flush();
+	QCHECK(Sweeper.GetModel().Find({ 1, 0 }) != nullptr);
+	QCHECK(Sweeper.NumQueued() == 1 && Sweeper.GetTopPriority() == 2.f); // half of the error left at alpha 0.5
+}
+
+QTEST(UpdateQueue, TraceLearnerKeepsPushOrder)
+{
+	FQLearner Inline = MakeTestLearner(ETableBackend::Map, 0.8f);
+	FQLearner Deferred = MakeTestLearner(ETableBackend::Map, 0.8f);
+
+	FQUpdateQueue Queue;
+	const FQKey Chain[] = { 6, 2, 4 };
+	for (int32_t Step = 0; Step < 3; ++Step)
+	{
+		const float Reward = Step == 2 ? 10.f : 0.f;
+		Inline.UpdateQValue(Chain[Step], 0, Reward, Chain[Step] + 1);
+		Queue.Push(Deferred, Chain[Step], 0, Reward, Chain[Step] + 1);
+	}
+	Inline.EndEpisode();
+	Queue.PushEndEpisode(Deferred);
+	Queue.Flush();
+
+	QCHECK(Deferred.GetTraces().Num() == 0);
+	for (const FQKey State : Chain)
+	{
+		QCHECK(Deferred.GetQValue(State, 0) == Inline.GetQValue(State, 0));
+	}
+	QCHECK(Deferred.GetQValue(6, 0) > 0.f);
+}
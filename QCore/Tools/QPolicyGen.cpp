@@ -0,0 +1,129 @@
+/*
+ * QPolicyGen - compiles a trained Q table into a constexpr policy header
+ *	QPolicyGen <Table.qtable|Table.json> <Out.h> [--name QBuiltInPolicy] [--actions 5] [--buckets Field=Edge,Edge,...]...
+ *
+ * Loads a saved *_QTable.qtable (or JSON export), folds it into the state buckets (the AQLearningEnemy defaults unless --buckets
+ * overrides a field, "Field=" clears one) and writes QCore::WritePolicyHeader's output: the greedy action of
+ * every bucketed state as a constexpr array plus its StateIndex/Choose functions. Buckets must match the enemies
+ * that compile the header in, the header's Signature is checked against them at BeginPlay.
+ */
+#include "QCore/QDiscretizer.h"
+#include "QCore/QPersistence.h"
+#include "QCore/QPolicyTable.h"
+#include "QCore/QStateSchema.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+
+/* --- Generator state (mirrors the UE FQState) --- */
+struct FGenState
+{
+	int8_t HealthPercent = 0;
+	int8_t TargetHealthPercent = 0;
+	int8_t HealsLeft = 0;
+	bool bIsInAttackRange = false;
+	bool bIsTargetAttacking = false;
+	bool bIsTargetGuarding = false;
+	bool bWasHitRecently = false;
+
+	static constexpr auto Fields = std::make_tuple(
+		QCore::QField(&FGenState::HealthPercent, "HealthPercent", 0, 100),
+		QCore::QField(&FGenState::TargetHealthPercent, "TargetHealthPercent", 0, 100),
+		QCore::QField(&FGenState::HealsLeft, "HealsLeft", 0, 7),
+		QCore::QField(&FGenState::bIsInAttackRange, "bIsInAttackRange"),
+		QCore::QField(&FGenState::bIsTargetAttacking, "bIsTargetAttacking"),
+		QCore::QField(&FGenState::bIsTargetGuarding, "bIsTargetGuarding"),
+		QCore::QField(&FGenState::bWasHitRecently, "bWasHitRecently"));
+	using Schema = QCore::TQStateSchema<FGenState, Fields>;
+};
+
+constexpr int32_t GenNumActions = 5; // EQAction::Wait + 1
+
+
+static int PrintUsage()
+{
+	std::fprintf(stderr, "usage: QPolicyGen <Table.qtable|Table.json> <Out.h> [--name QBuiltInPolicy] [--actions %d] [--buckets Field=Edge,Edge,...]...\n", GenNumActions);
+	return 2;
+}
+
+/* "Field=20,40,60,80" -> Discretizer, false on an unknown field or invalid edges */
+static bool ApplyBuckets(QCore::FQDiscretizer& Discretizer, const char* Spec)
+{
+	const char* Equals = std::strchr(Spec, '=');
+	if (!Equals) return false;
+
+	const std::string FieldName(Spec, Equals);
+	std::vector<int32_t> Edges;
+	for (const char* Token = Equals + 1; *Token; )
+	{
+		char* End;
+		Edges.push_back(static_cast<int32_t>(std::strtol(Token, &End, 10)));
+		if (End == Token) return false;
+		Token = *End ? End + 1 : End;
+	}
+	return Discretizer.SetBucketEdges(FieldName.c_str(), Edges.data(), Edges.size());
+}
+
+int main(int Argc, char** Argv)
+{
+	if (Argc < 3) return PrintUsage();
+	const char* TablePath = Argv[1];
+	const char* OutPath = Argv[2];
+	const char* Name = "QBuiltInPolicy";
+	int32_t NumActions = GenNumActions;
+
+	const QCore::FQKeyLayout Layout = QCore::MakeKeyLayout<FGenState::Schema>();
+	QCore::FQDiscretizer Discretizer(Layout);
+	const int32_t DefaultEdges[] = { 20, 40, 60, 80 }; // AQLearningEnemy::QHealthBucketEdges / QTargetHealthBucketEdges
+	Discretizer.SetBucketEdges("HealthPercent", DefaultEdges, 4);
+	Discretizer.SetBucketEdges("TargetHealthPercent", DefaultEdges, 4);
+
+	for (int Arg = 3; Arg + 1 < Argc; Arg += 2)
+	{
+		if (!std::strcmp(Argv[Arg], "--name")) Name = Argv[Arg + 1];
+		else if (!std::strcmp(Argv[Arg], "--actions")) NumActions = std::atoi(Argv[Arg + 1]);
+		else if (!std::strcmp(Argv[Arg], "--buckets"))
+		{
+			if (!ApplyBuckets(Discretizer, Argv[Arg + 1]))
+			{
+				std::fprintf(stderr, "QPolicyGen: invalid buckets '%s'\n", Argv[Arg + 1]);
+				return 2;
+			}
+		}
+		else return PrintUsage();
+	}
+	if (NumActions < 1 || NumActions > QCore::RowWidth) return PrintUsage();
+
+	const std::unique_ptr<QCore::IQTable> Table = QCore::MakeTable(QCore::ETableBackend::Map, NumActions, 0);
+	if (!QCore::LoadTableFile(*Table, Layout, TablePath))
+	{
+		std::fprintf(stderr, "QPolicyGen: can't load %s\n", TablePath);
+		return 1;
+	}
+	QCore::DiscretizeTable(*Table, Discretizer);
+
+	QCore::FQPolicyTable Policy(Discretizer);
+	if (!Policy.IsValid())
+	{
+		std::fprintf(stderr, "QPolicyGen: state space too large for a policy, add buckets\n");
+		return 1;
+	}
+	Policy.Build(*Table);
+
+	const char* Source = std::strrchr(TablePath, '/');
+	const std::string Header = QCore::WritePolicyHeader(Policy, Layout, Name, Source ? Source + 1 : TablePath);
+	FILE* File = std::fopen(OutPath, "wb");
+	if (!File || std::fwrite(Header.data(), 1, Header.size(), File) != Header.size())
+	{
+		if (File) std::fclose(File);
+		std::fprintf(stderr, "QPolicyGen: can't write %s\n", OutPath);
+		return 1;
+	}
+	std::fclose(File);
+
+	std::printf("%s: %zu rows -> %zu states, %zu bytes of actions\n", OutPath, Table->Num(), Policy.GetNumStates(), Policy.GetNumStates());
+	return 0;
+}
@@ -5,6 +5,18 @@
 #include "Components/BoxComponent.h"
 #include "Characters/KnightCharacter.h"
 #include "Kismet/GameplayStatics.h"
+#include "Misc/Paths.h"
+#include "QLearning/QLearningStorage.h"
+#include "QCore/QOverlayTable.h"
+#include "QCore/QStateIndex.h"
+
+// Built-in policy for shipping builds: QPolicyGen <Name>_QTable.qtable Public/QLearning/Generated/QBuiltInPolicy.h (same buckets as the enemies)
+#if __has_include("QLearning/Generated/QBuiltInPolicy.h")
+#include "QLearning/Generated/QBuiltInPolicy.h"
+#define QLEARNING_BUILTIN_POLICY 1
+#else
+#define QLEARNING_BUILTIN_POLICY 0
+#endif
 
 // Might not be needed
 // --------------------------------------------------------------------------------------------------
@@ -45,10 +57,24 @@ void AQLearningEnemy::BeginPlay()
 	}
 
 	/* Q Learning BeginPlay */
-	LoadQTableFromDisk();
-	DisplayQTable();
+	QStreamSeed = QRandomSeed != 0 ? static_cast<uint32>(QRandomSeed) : QCore::FQRandom::MakeRandomSeed(); // once, every stream below derives from it
+	const bool bFrozen = bFrozenQPolicy && InitFrozenQPolicy();
+	if (!bFrozen && bQTileCoding)
+	{
+		InitQTileLearner();
+	}
+	else if (!bFrozen)
+	{
+		InitQLearner();
+		LoadQTableFromDisk();
+		DisplayQTable();
+	}
 	
 	//FindQManager();
+	if (bDeferQUpdates || bShareQReplay || bUseQDynaPlanning) QManager = AQLearningManager::Get(GetWorld());
+	if (QReplayUpdatesPerFrame > 0 && !bShareQReplay) QReplayBuffer.SetCapacity(QReplayCapacity);
+	QReplayBuffer.SeedRandom(QStreamSeed, GetQRandomStream(1));
+	if (bUseQDynaPlanning) StartQDynaPlanning();
 	
 	FindQTarget();
 	if (QTarget) CombatTarget = QTarget; // needed?
@@ -57,15 +83,33 @@ void AQLearningEnemy::BeginPlay()
 void AQLearningEnemy::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
 	Super::EndPlay(EndPlayReason);
+
+	if (QManager) QManager->FlushQUpdates(); // queued updates reference QLearner
+	if (QDynaPlanner)
+	{
+		if (QManager) QManager->RemoveQDynaPlanner(*QDynaPlanner);
+		QDynaPlanner->Publish(*QLearner.GetTable());
+		QDynaPlanner->Stop();
+	}
 	
+	if (IsQPolicyFrozen()) return; // nothing learned
+	if (QTileLearner)
+	{
+		QLearningStorage::SaveQTileWeights(*QTileLearner, GetQTileWeightsFilename());
+		return;
+	}
+
 	if (!IsUsingSharedTable()) SaveQTableToDisk();
-	else SubmitQTableToManager();
+	else if (!bUsingLiveSharedTable) SubmitQTableToManager(); // live shared rows are already in the manager's table
+	if (bExportQPolicyOnEndPlay) ExportQPolicy();
 }
 
 void AQLearningEnemy::Tick(float DeltaTime)
 {
 	ABaseCharacter::Tick(DeltaTime);
 
+	PublishQDynaPlanning(); // before this frame's decisions read the table
+
 	static float ChaseAccumulator = 0.f;
 	ChaseAccumulator += DeltaTime;
 
@@ -88,7 +132,10 @@ void AQLearningEnemy::Tick(float DeltaTime)
 		AccumulatedTime = 0.f;
 		UpdateFunction_Phase1(); // start a new decision cycle
 	}
-	
+
+	ReplayQExperience();
+	SweepQPriorities();
+	PublishQSnapshot(DeltaTime);
 }
 
 void AQLearningEnemy::GetHit_Implementation(const FVector& ImpactPoint)
@@ -168,6 +215,7 @@ void AQLearningEnemy::UpdateFunction_Phase1()
 
 	// 1. Save current state to PrevQState
 	PrevQState = MakeUnique<FQState>(*QState); // Deep copy of current state
+	PrevQTargetDistance = QTargetDistance;
 
 	// 2. Choose action (ε-greedy)
 	ChosenQAction = ChooseAction(*PrevQState);
@@ -204,72 +252,111 @@ void AQLearningEnemy::UpdateFunction_Phase2()
 
 EQAction AQLearningEnemy::ChooseAction(const FQState& State) // State - EncodedState, Epsilon - 0 to 1 - exploration rate
 {
-	float Epsilon = QExplorationRate;
-	if (!QTable.Contains(State))
+#if QLEARNING_BUILTIN_POLICY
+	if (bUsingBuiltInQPolicy) return static_cast<EQAction>(QBuiltInPolicy::Choose(State.ToKey())); // inlined, no table at all
+#endif
+	if (FrozenQPolicy) return static_cast<EQAction>(FrozenQPolicy->Choose(State.ToKey())); // the policy folds its own buckets
+	if (QTileLearner)
 	{
-		// Initialize default Q-values for all actions
-		QTable.Add(State, {
-			{ EQAction::Attack, 0.f },
-			{ EQAction::Guard, 0.f },
-			{ EQAction::Dodge, 0.f },
-			{ EQAction::Heal, 0.f },
-			{ EQAction::Wait, 0.f }
-		});
+		float Features[NumQFeatures];
+		ToQFeatures(State, QTargetDistance, Features);
+		return static_cast<EQAction>(QTileLearner->ChooseAction(Features));
 	}
+	return static_cast<EQAction>(QLearner.ChooseAction(ToQKey(State)));
+}
 
-	// Exploration
-	if (FMath::RandRange(0,1) < Epsilon)
+void AQLearningEnemy::UpdateQValue(const FQState& PrevState, EQAction ActionTaken, float Reward,
+	const FQState& NewState) // Update Rule
+{
+	if (IsQPolicyFrozen()) return;
+	if (QTileLearner)
 	{
-		int32 Index = FMath::RandRange(0, static_cast<int32>(EQAction::Wait)); // Random Action
-		return static_cast<EQAction>(Index);
+		float PrevFeatures[NumQFeatures];
+		float NewFeatures[NumQFeatures];
+		ToQFeatures(PrevState, PrevQTargetDistance, PrevFeatures);
+		ToQFeatures(NewState, QTargetDistance, NewFeatures);
+		QTileLearner->UpdateQValue(PrevFeatures, static_cast<int32>(ActionTaken), Reward, NewFeatures);
+		return;
 	}
 
-	// Exploitation
-	TMap<EQAction, float>& ActionValues = QTable[State];
-	EQAction BestAction = EQAction::Wait;
-	float BestValue = -FLT_MAX;
-	for (const auto& Pair : ActionValues)
+	const QCore::FQKey PrevKey = ToQKey(PrevState);
+	const QCore::FQKey NewKey = ToQKey(NewState);
+
+	if (QReplayUpdatesPerFrame > 0)
 	{
-		if (Pair.Value > BestValue)
-		{
-			BestValue = Pair.Value;
-			BestAction = Pair.Key;
-		}
+		if (QCore::FQReplayBuffer* Buffer = GetQReplayBuffer()) Buffer->Add({ PrevKey, NewKey, static_cast<int32>(ActionTaken), Reward });
 	}
-	return BestAction;
+
+	if (QDynaPlanner) QDynaPlanner->Observe({ PrevKey, NewKey, static_cast<int32>(ActionTaken), Reward }); // handed over on the next publish, after any deferred update
+
+	QCore::FQPrioritizedSweeper* Sweeper = QSweepUpdatesPerFrame > 0 ? &QSweeper : nullptr;
+	if (bDeferQUpdates && QManager && QManager->GetQUpdateQueue().Push(QLearner, PrevKey, static_cast<int32>(ActionTaken), Reward, NewKey, Sweeper))
+	{
+		return; // applied (and observed by the sweeper) in AQLearningManager::Tick
+	}
+	QLearner.UpdateQValue(PrevKey, static_cast<int32>(ActionTaken), Reward, NewKey);
+	if (Sweeper) Sweeper->Observe(QLearner, { PrevKey, NewKey, static_cast<int32>(ActionTaken), Reward });
 }
 
-void AQLearningEnemy::UpdateQValue(const FQState& PrevState, EQAction ActionTaken, float Reward,
-	const FQState& NewState) // Update Rule
+void AQLearningEnemy::ReplayQExperience()
 {
-	float Alpha = QLearningRate; // Learning rate
-	float Gamma = QDiscountFactor; // discount factor
+	if (QReplayUpdatesPerFrame <= 0 || !GetQTable()) return;
 
-	if (!QTable.Contains(PrevState))
-		return;
-
-	if (!QTable.Contains(NewState))
+	if (QCore::FQReplayBuffer* Buffer = GetQReplayBuffer())
 	{
-		// Initialize all actions
-		QTable.Add(NewState, {
-			{ EQAction::Attack, 0.f },
-			{ EQAction::Guard, 0.f },
-			{ EQAction::Dodge, 0.f },
-			{ EQAction::Heal, 0.f },
-			{ EQAction::Wait, 0.f }
-		});
+		Buffer->Replay(QLearner, QReplayUpdatesPerFrame, QReplayBudgetMicros);
 	}
+}
+
+void AQLearningEnemy::SweepQPriorities()
+{
+	if (QSweepUpdatesPerFrame <= 0 || !GetQTable()) return;
+
+	QSweeper.Sweep(QLearner, QSweepUpdatesPerFrame, QSweepBudgetMicros);
+}
 
-	const float OldQ = QTable[PrevState][ActionTaken];
+QCore::FQReplayBuffer* AQLearningEnemy::GetQReplayBuffer()
+{
+	if (!bShareQReplay) return &QReplayBuffer;
+	return QManager ? &QManager->GetQReplayBuffer() : nullptr;
+}
+
+void AQLearningEnemy::StartQDynaPlanning()
+{
+	if (!GetQTable()) return;
 
-	float MaxFutureQ = -FLT_MAX;
-	for (const auto& Pair : QTable[NewState]) // Choose Action
+	QDynaPlanner = MakeUnique<QCore::FQDynaPlanner>();
+	QDynaPlanner->Config.MaxUnpublishedUpdates = FMath::Max(QDynaMaxStaleUpdates, 1);
+	QDynaPlanner->SeedRandom(QStreamSeed, GetQRandomStream(2));
+	if (!QManager) // no shared worker, plans on a thread of its own
 	{
-		MaxFutureQ = FMath::Max(MaxFutureQ, Pair.Value);
+		QDynaPlanner->Start(*QLearner.GetTable(), QLearner.Config);
+		return;
 	}
+	QDynaPlanner->Start(*QLearner.GetTable(), QLearner.Config, false);
+	QManager->AddQDynaPlanner(*QDynaPlanner);
+}
+
+void AQLearningEnemy::PublishQDynaPlanning()
+{
+	if (QDynaPlanner) QDynaPlanner->Publish(*QLearner.GetTable());
+}
+
+void AQLearningEnemy::PublishQSnapshot(const float DeltaTime)
+{
+	if (QSnapshotIntervalSecs <= 0.f || !GetQTable()) return;
+
+	QSnapshotAccumulator += DeltaTime;
+	if (QSnapshotAccumulator < QSnapshotIntervalSecs && QSnapshots.GetVersion() > 0) return;
+
+	QSnapshotAccumulator = 0.f;
+	QSnapshots.Publish(*GetQTable());
+}
 
-	const float NewQ = OldQ + Alpha * (Reward + Gamma * MaxFutureQ - OldQ);
-	QTable[NewState][ActionTaken] = NewQ;
+void AQLearningEnemy::EndQEpisode()
+{
+	if (bDeferQUpdates && QManager && QManager->GetQUpdateQueue().PushEndEpisode(QLearner)) return;
+	QLearner.EndEpisode();
 }
 
 
@@ -356,6 +443,7 @@ void AQLearningEnemy::UpdateQState_Distance()
 	const float Distance = FVector::Dist(GetActorLocation(), QTarget->GetActorLocation());
 	
 	QState->bIsInAttackRange = Distance < QAttackRadius;
+	QTargetDistance = Distance;
 }
 
 void AQLearningEnemy::UpdateQState_IsEnemyAttacking(const bool bIsTargetAttacking)
@@ -486,6 +574,7 @@ void AQLearningEnemy::Die()
 	Super::Die();
 	AddQReward(QLearningRewards::DeathPenalty);
 	UpdateFunction_Phase2(); // test placement (apply death penalty to last action immediately)
+	EndQEpisode();
 	//ClearFallbackPhase2Timer();
 }
 
@@ -528,76 +617,214 @@ void AQLearningEnemy::ClearGuardTimer()
 
 
 /* Storage */
-void AQLearningEnemy::SaveQTableToDisk()
+void AQLearningEnemy::InitQLearner()
 {
-	const FString SavePath = FPaths::ProjectSavedDir() + QFilename;
+	QLearner.Config.LearningRate = QLearningRate;
+	QLearner.Config.ExplorationRate = QExplorationRate;
+	QLearner.Config.DiscountFactor = QDiscountFactor;
+	QLearner.Config.TraceDecay = QTraceDecay;
+	QLearner.Config.VisitCountExponent = QVisitCountExponent;
+	QLearner.SeedRandom(QStreamSeed, GetQRandomStream(0));
 
-	TSharedPtr<FJsonObject> RootObject = MakeShareable(new FJsonObject);
+	InitQDiscretizer();
 
-	for (const auto& StatePair : QTable)
+	bUsingLiveSharedTable = false;
+	if (bLiveSharedQTable && IsUsingSharedTable())
 	{
-		const FString StateKey = StatePair.Key.ToString();
-		TSharedPtr<FJsonObject> ActionMap = MakeShareable(new FJsonObject);
-
-		for (const auto& ActionPair : StatePair.Value)
+		AQLearningManager* Manager = AQLearningManager::Get(GetWorld());
+		if (std::shared_ptr<QCore::IQTable> Shared = Manager ? Manager->GetSharedQTable(QDiscretizer) : nullptr)
 		{
-			const FString ActionStr = FString::FromInt(static_cast<int32>(ActionPair.Key));
-			ActionMap->SetNumberField(ActionStr, ActionPair.Value);
+			QLearner.SetTable(MoveTemp(Shared));
+			bUsingLiveSharedTable = true;
+			return;
 		}
+		UE_LOG(LogTemp, Warning, TEXT("%s: no QLearningManager for the live shared Q-Table, or its buckets differ - merging at EndPlay"), *GetName());
+	}
+
+	const QCore::ETableBackend Backend = QTableBackend == EQTableBackend::Dense ? QCore::ETableBackend::Dense
+		: QTableBackend == EQTableBackend::Sharded ? QCore::ETableBackend::Sharded : QCore::ETableBackend::Map;
+	const QCore::EQValueType ValueType = Backend == QCore::ETableBackend::Sharded ? QCore::EQValueType::AtomicFloat
+		: QValueStorage == EQValueStorage::Int16 ? QCore::EQValueType::Int16 : QCore::EQValueType::Float;
+	std::unique_ptr<QCore::IQTable> Table = bMapQTable && Backend == QCore::ETableBackend::Map && QTableMemoryCapKB <= 0 ? MakeMappedQTable(ValueType) : nullptr;
+	if (Table) // already holds the saved rows, LoadQTableFromDisk skips it
+	{
+		if (bQVisitCounts || QVisitCountExponent > 0.f) Table->EnableVisitCounts();
+		QLearner.SetTable(MoveTemp(Table));
+		return;
+	}
 
-		RootObject->SetObjectField(StateKey, ActionMap);
+	Table = QCore::MakeTable(Backend, NumQActions, std::make_shared<const QCore::FQStateIndex>(QDiscretizer), ValueType, QValueRange); // Dense: one row per bucketed state
+	if (!Table)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s: state space too large for a Dense Q-Table, using Map"), *GetName());
+		Table = QCore::MakeTable(QCore::ETableBackend::Map, NumQActions, 0, ValueType, QValueRange);
+	}
+	if ((bQVisitCounts || QVisitCountExponent > 0.f) && !Table->EnableVisitCounts()) // before loading, counts are saved with the table
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s: Sharded Q-Tables have no visit counts, using QLearningRate"), *GetName());
+	}
+	const QCore::EQEvictionPolicy Eviction = QTableEviction == EQEviction::LeastVisited ? QCore::EQEvictionPolicy::LeastVisited : QCore::EQEvictionPolicy::Clock;
+	if (QTableMemoryCapKB > 0 && !Table->SetMemoryLimit(static_cast<size_t>(QTableMemoryCapKB) * 1024, Eviction))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s: QTableMemoryCapKB needs a Map Q-Table, ignored"), *GetName());
 	}
+	QLearner.SetTable(MoveTemp(Table));
+}
 
-	// Convert to string
-	FString OutputString;
-	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&OutputString);
-	FJsonSerializer::Serialize(RootObject.ToSharedRef(), Writer);
+std::unique_ptr<QCore::IQTable> AQLearningEnemy::MakeMappedQTable(const QCore::EQValueType ValueType) const
+{
+	// The shared rows are used as they are: same actions and value type, keys already in this enemy's buckets (checked by the manager)
+	AQLearningManager* Manager = AQLearningManager::Get(GetWorld());
+	std::shared_ptr<const QCore::FQTableView> View;
+	if (Manager) View = Manager->GetQTableView(QFilename, QDiscretizer);
+	else if ((View = QLearningStorage::MapQTable(QFilename)) && !View->IsDiscretizedBy(QDiscretizer)) View.reset();
 
-	// Save to file
-	FFileHelper::SaveStringToFile(OutputString, *SavePath);
-	UE_LOG(LogTemp, Warning, TEXT("Saved Q-Table: %s"), *SavePath);
+	if (!View || View->GetNumActions() != NumQActions || View->GetValueType() != ValueType)
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s: saved Q-Table can't be mapped or doesn't match the value storage or state buckets, loading a private copy"), *GetName());
+		return nullptr;
+	}
+	UE_LOG(LogTemp, Log, TEXT("%s: mapped Q-Table, %d shared states"), *GetName(), static_cast<int32>(View->Num()));
+	return std::make_unique<QCore::FQOverlayTable>(View);
 }
 
-void AQLearningEnemy::LoadQTableFromDisk()
+bool AQLearningEnemy::InitFrozenQPolicy()
 {
-	const FString LoadPath = FPaths::ProjectSavedDir() + QFilename;
-	FString FileContents;
+	InitQDiscretizer();
 
-	if (!FFileHelper::LoadFileToString(FileContents, *LoadPath))
+#if QLEARNING_BUILTIN_POLICY
+	if (QBuiltInPolicy::NumActions == NumQActions && QBuiltInPolicy::Signature == QCore::FQStateIndex(QDiscretizer).GetSignature()) // bucket lookups only, no action bytes
 	{
-		UE_LOG(LogTemp, Warning, TEXT("No Q-Table found at: %s"), *LoadPath);
-		return;
+		bUsingBuiltInQPolicy = true;
+		UE_LOG(LogTemp, Log, TEXT("%s: built-in Q-Policy, %u states"), *GetName(), QBuiltInPolicy::NumStates);
+		return true;
+	}
+	UE_LOG(LogTemp, Warning, TEXT("%s: built-in Q-Policy was generated for other state buckets, loading one instead"), *GetName());
+#endif
+
+	if (AQLearningManager* Manager = AQLearningManager::Get(GetWorld()))
+	{
+		FrozenQPolicy = Manager->GetFrozenQPolicy(GetQPolicyFilename(), QFilename, QDiscretizer);
+	}
+	else // no manager to share it through - a private copy
+	{
+		auto Policy = std::make_shared<QCore::FQPolicyTable>(QDiscretizer);
+		if (QLearningStorage::LoadOrBuildQPolicy(*Policy, GetQPolicyFilename(), QFilename, QDiscretizer)) FrozenQPolicy = MoveTemp(Policy);
+	}
+
+	if (!FrozenQPolicy)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s: no Q-Policy or Q-Table to freeze, learning instead"), *GetName());
+		return false;
 	}
+	UE_LOG(LogTemp, Log, TEXT("%s: frozen Q-Policy, %d states (%llu bytes)"), *GetName(), static_cast<int32>(FrozenQPolicy->GetNumStates()), static_cast<uint64>(FrozenQPolicy->GetAllocatedSize()));
+	return true;
+}
+
+FString AQLearningEnemy::GetQPolicyFilename() const
+{
+	return FPaths::GetBaseFilename(QFilename) + TEXT(".qpolicy");
+}
 
-	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(FileContents);
-	TSharedPtr<FJsonObject> RootObject;
+void AQLearningEnemy::InitQTileLearner()
+{
+	// One dimension per schema field over its declared range (health in 20% tiles like the default buckets), plus distance
+	const QCore::FQKeyLayout Layout = QCore::MakeKeyLayout<FQState::Schema>();
+	std::vector<QCore::FQTileDimension> Dimensions;
+	for (size_t Field = 0; Field < Layout.NumFields; ++Field)
+	{
+		const QCore::FQFieldLayout& Range = Layout.Fields[Field];
+		const float Span = static_cast<float>(Range.Max - Range.Min);
+		Dimensions.push_back({ static_cast<float>(Range.Min), static_cast<float>(Range.Max), Span > 10.f ? 5.f : Span });
+	}
+	Dimensions.push_back({ 0.f, FMath::Max(QCombatRadius, 1.f), FMath::Max(QCombatRadius / FMath::Max(QAttackRadius, 1.f), 1.f) }); // attack-radius tiles
 
-	if (!FJsonSerializer::Deserialize(Reader, RootObject) || !RootObject.IsValid())
+	QCore::FQTileCodingConfig Coding;
+	Coding.NumTilings = QTileCodingTilings;
+	Coding.MemorySize = static_cast<uint32>(FMath::RoundUpToPowerOfTwo(FMath::Max(QTileCodingMemory, 2)));
+	QTileLearner = MakeUnique<QCore::FQTileLearner>(NumQActions, MoveTemp(Dimensions), Coding);
+	if (!QTileLearner->IsValid())
 	{
-		UE_LOG(LogTemp, Warning, TEXT("Failed to parse Q-Table JSON"));
+		UE_LOG(LogTemp, Warning, TEXT("%s: invalid tile coding (1-%d tilings), using the Q-Table"), *GetName(), QCore::FQTileCoder::MaxTilings);
+		QTileLearner.Reset();
+		InitQLearner();
+		LoadQTableFromDisk();
 		return;
 	}
 
-	QTable.Empty();
+	QTileLearner->Config.LearningRate = QLearningRate;
+	QTileLearner->Config.ExplorationRate = QExplorationRate;
+	QTileLearner->Config.DiscountFactor = QDiscountFactor;
+	QTileLearner->SeedRandom(QStreamSeed, GetQRandomStream(0));
+	QLearningStorage::LoadQTileWeights(*QTileLearner, GetQTileWeightsFilename());
+	UE_LOG(LogTemp, Log, TEXT("%s: tile-coded Q, %d tilings x %u tiles (%llu bytes)"), *GetName(), QTileLearner->GetCoder().GetNumTilings(),
+		QTileLearner->GetCoder().GetMemorySize(), static_cast<uint64>(QTileLearner->GetAllocatedSize()));
+}
+
+void AQLearningEnemy::ToQFeatures(const FQState& State, const float Distance, float* OutFeatures) const
+{
+	FQState::Schema::ToFloats(State, OutFeatures);
+	OutFeatures[FQState::Schema::NumFields] = Distance;
+}
+
+FString AQLearningEnemy::GetQTileWeightsFilename() const
+{
+	return FPaths::GetBaseFilename(QFilename) + TEXT(".qtiles");
+}
 
-	for (const auto& StatePair : RootObject->Values)
+bool AQLearningEnemy::ExportQPolicy() const
+{
+	const QCore::IQTable* Table = GetQTable();
+	if (!Table) return false;
+
+	QCore::FQPolicyTable Policy(QDiscretizer);
+	if (!Policy.IsValid())
 	{
-		FQState StateKey = FQState::FromString(StatePair.Key);
-		TSharedPtr<FJsonObject> ActionMap = StatePair.Value->AsObject();
+		UE_LOG(LogTemp, Warning, TEXT("%s: state space too large for a Q-Policy (add state buckets)"), *GetName());
+		return false;
+	}
+	Policy.Build(*Table);
+	return QLearningStorage::SaveQPolicy(Policy, GetQPolicyFilename());
+}
 
-		TMap<EQAction, float> Actions;
+void AQLearningEnemy::InitQDiscretizer()
+{
+	QDiscretizer = QCore::FQDiscretizer(QCore::MakeKeyLayout<FQState::Schema>());
 
-		for (const auto& ActionPair : ActionMap->Values)
+	auto SetEdges = [this](const char* FieldName, const TArray<int32>& Edges)
+	{
+		if (!QDiscretizer.SetBucketEdges(FieldName, Edges.GetData(), Edges.Num()))
 		{
-			const EQAction Action = static_cast<EQAction>(FCString::Atoi(*ActionPair.Key));
-			const float QValue = ActionPair.Value->AsNumber();
-			Actions.Add(Action, QValue);
+			UE_LOG(LogTemp, Warning, TEXT("%s: invalid %hs bucket edges (must be ascending, inside the field range), using raw values"), *GetName(), FieldName);
 		}
+	};
+	SetEdges("HealthPercent", QHealthBucketEdges);
+	SetEdges("TargetHealthPercent", QTargetHealthBucketEdges);
+	SetEdges("HealsLeft", QHealsLeftBucketEdges);
+
+	UE_LOG(LogTemp, Log, TEXT("%s: %llu reachable Q states"), *GetName(), QDiscretizer.CountReachableKeys());
+}
 
-		QTable.Add(StateKey, Actions);
+void AQLearningEnemy::SaveQTableToDisk()
+{
+	if (const QCore::IQTable* Table = GetQTable())
+	{
+		QLearningStorage::SaveQTable(*Table, QFilename);
+		if (bExportQTableJson) QLearningStorage::ExportQTableJson(*Table, QFilename);
 	}
+}
+
+void AQLearningEnemy::LoadQTableFromDisk()
+{
+	if (bUsingLiveSharedTable) return; // loaded once by the manager
+
+	QCore::IQTable* Table = QLearner.GetTable();
+	if (Table && Table->GetBackend() == QCore::ETableBackend::Overlay) return; // the mapped rows are already bucketed
 
-	UE_LOG(LogTemp, Warning, TEXT("Loaded Q-Table: %s"), *LoadPath);
+	if (Table)
+	{
+		QLearningStorage::LoadDiscretizedQTable(*Table, QFilename, QDiscretizer); // folds rows saved with raw (or different) buckets
+	}
 }
 
 void AQLearningEnemy::FindQManager()
@@ -623,7 +850,7 @@ void AQLearningEnemy::SubmitQTableToManager() const
 	{
 		if (AQLearningManager* Manager = AQLearningManager::Get(World))
 		{
-			Manager->MergeQTableFromEnemy(QTable);
+			if (const QCore::IQTable* Table = GetQTable()) Manager->MergeQTableFromEnemy(*Table);
 			UE_LOG(LogTemp, Warning, TEXT("Submitted QTable to %s from %s"), *Manager->GetName(), *GetName());
 		}
 	}
@@ -643,20 +870,21 @@ void AQLearningEnemy::FallbackPhase2()
 /* Display */
 void AQLearningEnemy::DisplayQTable() const
 {
+	const QCore::IQTable* Table = GetQTable();
+	if (!Table) return;
+
 	UE_LOG(LogTemp, Warning, TEXT("========= Q TABLE ========="));
-	for (const auto& StatePair : QTable)
+	UE_LOG(LogTemp, Warning, TEXT("%d states, %llu bytes, %llu evicted"), static_cast<int32>(Table->Num()), static_cast<uint64>(Table->GetAllocatedSize()), static_cast<uint64>(Table->GetNumEvicted()));
+	Table->ForEachRow([Table](const QCore::FQKey Key, const float* Row)
 	{
-		const FString& State = StatePair.Key.ToString();
-		const TMap<EQAction, float>& ActionMap = StatePair.Value;
-
-		UE_LOG(LogTemp, Warning, TEXT("State: %s"), *State);
+		UE_LOG(LogTemp, Warning, TEXT("State: %s"), *FQState::FromKey(Key).ToString());
 
-		for (const auto& ActionPair : ActionMap)
+		for (int32 Action = 0; Action < Table->GetNumActions(); ++Action)
 		{
-			const FString ActionName = StaticEnum<EQAction>()->GetNameStringByValue(static_cast<int64>(ActionPair.Key));
-			UE_LOG(LogTemp, Warning, TEXT("   %s: %.2f"), *ActionName, ActionPair.Value);
+			const FString ActionName = StaticEnum<EQAction>()->GetNameStringByValue(Action);
+			UE_LOG(LogTemp, Warning, TEXT("   %s: %.2f"), *ActionName, Row[Action]);
 		}
-	}
+	});
 	UE_LOG(LogTemp, Warning, TEXT("============================"));
 }
 
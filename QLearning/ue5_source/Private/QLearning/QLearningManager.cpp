@@ -1,5 +1,6 @@
 #include "QLearning/QLearningManager.h"
 #include "QLearning/Enemy/QLearningEnemy.h"
+#include "QLearning/QLearningStorage.h"
 #include "Kismet/GameplayStatics.h"
 #include "EngineUtils.h"
 
@@ -7,12 +8,15 @@
 AQLearningManager::AQLearningManager()
 {
 	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.TickGroup = TG_PostUpdateWork; // flush after this frame's enemy updates
 
 }
 
 void AQLearningManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
 	Super::EndPlay(EndPlayReason);
+	FlushQUpdates();
+	QDynaWorker.Stop();
 
 	/*if (!MergedQTable.IsEmpty())
 	{
@@ -34,6 +38,7 @@ void AQLearningManager::BeginPlay()
 	Super::BeginPlay();
 
 	Tags.Add(FName("QManager"));
+	QReplayBuffer.SeedRandom(QCore::FQRandom::MakeRandomSeed()); // pooled buffer, one draw per session
 	
 }
 
@@ -41,6 +46,15 @@ void AQLearningManager::Tick(float DeltaTime)
 {
 	//Super::Tick(DeltaTime);
 
+	FlushQUpdates();
+	QDynaWorker.BeginFrame(); // after the enemies published this frame's planning
+}
+
+void AQLearningManager::AddQDynaPlanner(QCore::FQDynaPlanner& Planner)
+{
+	QDynaWorker.UpdatesPerFrame = FMath::Max(QDynaUpdatesPerFrame, 0);
+	QDynaWorker.Add(Planner);
+	QDynaWorker.Start(); // no-op once running
 }
 
 AQLearningManager* AQLearningManager::Get(UWorld* World)
@@ -69,67 +83,75 @@ TArray<AQLearningEnemy*> AQLearningManager::FindAllQEnemies()
 	return Enemies;
 }
 
-void AQLearningManager::MergeQTableFromEnemy(const TMap<FQState, TMap<EQAction, float>>& OtherTable)
+void AQLearningManager::MergeQTableFromEnemy(const QCore::IQTable& OtherTable)
 {
-	for (const auto& StatePair : OtherTable)
-	{
-		const FQState& State = StatePair.Key;
-		const TMap<EQAction, float>& Actions = StatePair.Value;
-
-		if (!MergedQTable.Contains(State))
-		{
-			MergedQTable.Add(State, Actions);
-		}
-		else
-		{
-			for (const auto& ActionPair : Actions)
-			{
-				EQAction Action = ActionPair.Key;
-				float OtherValue = ActionPair.Value;
-
-				float& ExistingValue = MergedQTable[State].FindOrAdd(Action);
-				ExistingValue = (ExistingValue + OtherValue) / 2.0f; // Simple average
-				// experiment with merging algorithms
-			}
-		}
-	}
+	QCore::IQTable& Into = SharedQTable ? *SharedQTable : *MergedQTable; // enemies without live sharing still land in the shared file
+	QCore::MergeAverage(Into, OtherTable); // Simple average - experiment with merging algorithms
 }
 
 void AQLearningManager::SaveMergedQTableToDisk(const FString& Filename)
 {
-	const FString SavePath = FPaths::ProjectSavedDir() + Filename;
-
-	TSharedPtr<FJsonObject> Root = MakeShareable(new FJsonObject);
+	const QCore::IQTable& Table = SharedQTable ? *SharedQTable : *MergedQTable;
+	QLearningStorage::SaveQTable(Table, Filename);
+	if (bExportSharedQTableJson) QLearningStorage::ExportQTableJson(Table, Filename);
+}
 
-	for (const auto& StatePair : MergedQTable)
+std::shared_ptr<QCore::IQTable> AQLearningManager::GetSharedQTable(const QCore::FQDiscretizer& Discretizer)
+{
+	if (!SharedQTable)
 	{
-		FString StateKey = StatePair.Key.ToString();
-		TSharedPtr<FJsonObject> ActionMap = MakeShareable(new FJsonObject);
-
-		for (const auto& ActionPair : StatePair.Value)
+		const std::shared_ptr<const QCore::FQStateIndex> StateIndex = std::make_shared<QCore::FQStateIndex>(Discretizer); // one row per bucketed state
+		SharedQTable = QCore::MakeTable(QCore::ETableBackend::Dense, NumQActions, StateIndex, QCore::EQValueType::AtomicFloat);
+		if (!SharedQTable) // state space too large to index densely
 		{
-			FString ActionKey = FString::FromInt(static_cast<int32>(ActionPair.Key));
-			ActionMap->SetNumberField(ActionKey, ActionPair.Value);
+			SharedQTable = QCore::MakeTable(QCore::ETableBackend::Sharded, NumQActions, 0, QCore::EQValueType::AtomicFloat);
 		}
 
-		Root->SetObjectField(StateKey, ActionMap);
+		QLearningStorage::LoadDiscretizedQTable(*SharedQTable, SharedFilename, Discretizer);
+		SharedQTableBuckets = Discretizer;
 	}
+	return SharedQTableBuckets.HasSameBuckets(Discretizer) ? SharedQTable : nullptr; // rows are the first caller's buckets
+}
+
+std::shared_ptr<const QCore::FQPolicyTable> AQLearningManager::GetFrozenQPolicy(const FString& PolicyFilename, const FString& TableFilename,
+	const QCore::FQDiscretizer& Discretizer)
+{
+	if (const std::shared_ptr<const QCore::FQPolicyTable>* Cached = FrozenQPolicies.Find(PolicyFilename)) return *Cached; // folds raw keys with its own buckets
+
+	auto Policy = std::make_shared<QCore::FQPolicyTable>(Discretizer);
+	if (!QLearningStorage::LoadOrBuildQPolicy(*Policy, PolicyFilename, TableFilename, Discretizer)) return nullptr;
+	FrozenQPolicies.Add(PolicyFilename, Policy);
+	return Policy;
+}
 
-	FString Output;
-	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Output);
-	FJsonSerializer::Serialize(Root.ToSharedRef(), Writer);
+std::shared_ptr<const QCore::FQTableView> AQLearningManager::GetQTableView(const FString& Filename, const QCore::FQDiscretizer& Discretizer)
+{
+	FMappedQTable* Mapped = QTableViews.Find(Filename);
+	std::shared_ptr<const QCore::FQTableView> View = Mapped ? Mapped->View.lock() : nullptr;
+	if (!View)
+	{
+		View = QLearningStorage::MapQTable(Filename);
+		if (!View) return nullptr;
+		Mapped = &QTableViews.Add(Filename, FMappedQTable{ View, {} }); // a new mapping may hold other keys, checks start over
+	}
 
-	FFileHelper::SaveStringToFile(Output, *SavePath);
-	UE_LOG(LogTemp, Warning, TEXT("Merged QTable saved to %s"), *SavePath);
+	for (const std::pair<QCore::FQDiscretizer, bool>& Checked : Mapped->CheckedBuckets)
+	{
+		if (Checked.first.HasSameBuckets(Discretizer)) return Checked.second ? View : nullptr;
+	}
+	const bool bDiscretized = View->IsDiscretizedBy(Discretizer); // one scan over every key
+	Mapped->CheckedBuckets.emplace_back(Discretizer, bDiscretized);
+	return bDiscretized ? View : nullptr;
 }
 
 void AQLearningManager::MergeAndSaveQTables()
 {
-	MergedQTable.Empty();
+	MergedQTable->Empty();
 
 	for (AQLearningEnemy* Enemy : FindAllQEnemies())
 	{
-		MergeQTableFromEnemy(Enemy->GetQTable()); // Add `GetQTable()` to your QEnemy
+		if (Enemy->IsUsingLiveSharedTable()) continue; // already learning in SharedQTable
+		if (const QCore::IQTable* Table = Enemy->GetQTable()) MergeQTableFromEnemy(*Table);
 	}
 
 	SaveMergedQTableToDisk(SharedFilename);
@@ -0,0 +1,235 @@
+#include "QLearning/QLearningStorage.h"
+#include "QLearning/QLearningTypes.h"
+#include "QCore/QDiscretizer.h"
+#include "QCore/QPersistence.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+
+namespace
+{
+	bool SaveBytes(const std::string& Bytes, const FString& SavePath)
+	{
+		return FFileHelper::SaveArrayToFile(TArrayView<const uint8>(reinterpret_cast<const uint8*>(Bytes.data()), static_cast<int32>(Bytes.size())), *SavePath);
+	}
+
+	FString GetPendingPath(const FString& BinaryPath) { return BinaryPath + TEXT(".pending"); }
+
+	/* The newest saved table: a pending save is moved into place first, or read where it is if the table file is still mapped */
+	FString ResolveQTablePath(const FString& BinaryPath)
+	{
+		IFileManager& FileManager = IFileManager::Get();
+		const FString PendingPath = GetPendingPath(BinaryPath);
+		if (!FileManager.FileExists(*PendingPath)) return BinaryPath;
+
+		if (FileManager.FileExists(*BinaryPath) && FileManager.GetTimeStamp(*BinaryPath) > FileManager.GetTimeStamp(*PendingPath))
+		{
+			FileManager.Delete(*PendingPath, false, false, true); // the table file was saved over after all
+			return BinaryPath;
+		}
+		return FileManager.Move(*BinaryPath, *PendingPath, true, false, false, true) ? BinaryPath : PendingPath; // no retries while it is mapped
+	}
+}
+
+FString QLearningStorage::GetBinaryQTableFilename(const FString& Filename)
+{
+	return FPaths::ChangeExtension(Filename, TEXT("qtable"));
+}
+
+bool QLearningStorage::SaveQTable(const QCore::IQTable& Table, const FString& Filename)
+{
+	IFileManager& FileManager = IFileManager::Get();
+	const FString SavePath = FPaths::ProjectSavedDir() + GetBinaryQTableFilename(Filename);
+	const FString PendingPath = GetPendingPath(SavePath);
+	const FString TempPath = SavePath + TEXT(".tmp");
+
+	// Written beside the old file and moved over it, so mappings of the old file stay valid. Where a mapped file
+	// can't be replaced (Windows) it becomes the pending save, which the next load moves into place
+	if (!SaveBytes(QCore::WriteTableBinary(Table, QCore::MakeKeyLayout<FQState::Schema>(), true), TempPath))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Failed to save Q-Table: %s"), *SavePath);
+		return false;
+	}
+	if (FileManager.Move(*SavePath, *TempPath, true, false, false, true))
+	{
+		FileManager.Delete(*PendingPath, false, false, true); // older than this save
+		UE_LOG(LogTemp, Warning, TEXT("Saved Q-Table: %s (%d states)"), *SavePath, static_cast<int32>(Table.Num()));
+		return true;
+	}
+	if (FileManager.Move(*PendingPath, *TempPath, true))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Saved Q-Table: %s (%d states, table file in use - applied on the next load)"), *PendingPath, static_cast<int32>(Table.Num()));
+		return true;
+	}
+
+	FileManager.Delete(*TempPath, false, false, true);
+	UE_LOG(LogTemp, Warning, TEXT("Failed to save Q-Table: %s"), *SavePath);
+	return false;
+}
+
+bool QLearningStorage::ExportQTableJson(const QCore::IQTable& Table, const FString& Filename)
+{
+	const FString SavePath = FPaths::ProjectSavedDir() + Filename;
+
+	if (!SaveBytes(QCore::WriteTableJson(Table, QCore::MakeKeyLayout<FQState::Schema>()), SavePath))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Failed to export Q-Table JSON: %s"), *SavePath);
+		return false;
+	}
+	UE_LOG(LogTemp, Warning, TEXT("Exported Q-Table JSON: %s (%d states)"), *SavePath, static_cast<int32>(Table.Num()));
+	return true;
+}
+
+bool QLearningStorage::LoadQTable(QCore::IQTable& Table, const FString& Filename)
+{
+	FString LoadPath = ResolveQTablePath(FPaths::ProjectSavedDir() + GetBinaryQTableFilename(Filename));
+	TArray<uint8> FileContents;
+
+	if (!FFileHelper::LoadFileToArray(FileContents, *LoadPath, FILEREAD_Silent))
+	{
+		LoadPath = FPaths::ProjectSavedDir() + Filename; // saved before the binary format
+		if (!FFileHelper::LoadFileToArray(FileContents, *LoadPath, FILEREAD_Silent))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("No Q-Table found at: %s"), *LoadPath);
+			return false;
+		}
+	}
+
+	// Either format - the binary one is recognized by its header
+	if (!QCore::ReadTable(Table, QCore::MakeKeyLayout<FQState::Schema>(), reinterpret_cast<const char*>(FileContents.GetData()), FileContents.Num()))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Failed to read Q-Table (corrupt, or saved with another state layout or action count): %s"), *LoadPath);
+		return false;
+	}
+
+	UE_LOG(LogTemp, Warning, TEXT("Loaded Q-Table: %s (%d states)"), *LoadPath, static_cast<int32>(Table.Num()));
+	return true;
+}
+
+bool QLearningStorage::LoadDiscretizedQTable(QCore::IQTable& Table, const FString& Filename, const QCore::FQDiscretizer& Discretizer)
+{
+	if (Table.GetBackend() != QCore::ETableBackend::Dense)
+	{
+		if (!LoadQTable(Table, Filename)) return false;
+		QCore::DiscretizeTable(Table, Discretizer);
+		return true;
+	}
+
+	// Dense rows are indexed by bucket, raw keys would overwrite each other there instead of being averaged - fold them first
+	const std::unique_ptr<QCore::IQTable> Saved = QCore::MakeTable(QCore::ETableBackend::Map, Table.GetNumActions(), 0);
+	if (Table.HasVisitCounts()) Saved->EnableVisitCounts();
+	if (!LoadQTable(*Saved, Filename)) return false;
+	QCore::DiscretizeTable(*Saved, Discretizer);
+
+	Saved->ForEachRow([&Table, &Saved](const QCore::FQKey Key, const float* Row)
+	{
+		Table.StoreRow(Key, Row);
+		const uint32_t* Counts;
+		if (Saved->FindCountedRowData(Key, Counts) && Counts) Table.StoreVisitCounts(Key, Counts);
+	});
+	return true;
+}
+
+std::shared_ptr<const QCore::FQTableView> QLearningStorage::MapQTable(const FString& Filename)
+{
+	const FString LoadPath = ResolveQTablePath(FPaths::ProjectSavedDir() + GetBinaryQTableFilename(Filename));
+
+	// Kept alive by the view (and every overlay on it); the region is unmapped before its file handle closes
+	struct FMapping
+	{
+		TUniquePtr<IMappedFileHandle> Handle;
+		TUniquePtr<IMappedFileRegion> Region;
+	};
+	const std::shared_ptr<FMapping> Mapping = std::make_shared<FMapping>();
+	Mapping->Handle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*LoadPath));
+	if (!Mapping->Handle) return nullptr; // no saved table, or no mapped files on this platform
+	Mapping->Region.Reset(Mapping->Handle->MapRegion());
+	if (!Mapping->Region) return nullptr;
+
+	const char* Data = reinterpret_cast<const char*>(Mapping->Region->GetMappedPtr());
+	const size_t Size = static_cast<size_t>(Mapping->Region->GetMappedSize());
+	const std::shared_ptr<const QCore::FQTableView> View = std::make_shared<QCore::FQTableView>(Data, Size, QCore::MakeKeyLayout<FQState::Schema>(), Mapping);
+	if (!View->IsValid())
+	{
+		UE_LOG(LogTemp, Log, TEXT("Q-Table %s can't be mapped (saved with packed rows, another state layout, or corrupt)"), *LoadPath);
+		return nullptr;
+	}
+
+	UE_LOG(LogTemp, Warning, TEXT("Mapped Q-Table: %s (%d states, %llu index bytes)"), *LoadPath, static_cast<int32>(View->Num()), static_cast<uint64>(View->GetIndexSize()));
+	return View;
+}
+
+bool QLearningStorage::SaveQPolicy(const QCore::FQPolicyTable& Policy, const FString& Filename)
+{
+	const FString SavePath = FPaths::ProjectSavedDir() + Filename;
+
+	const std::string Bytes = QCore::WritePolicyBinary(Policy);
+	if (!FFileHelper::SaveArrayToFile(TArrayView<const uint8>(reinterpret_cast<const uint8*>(Bytes.data()), static_cast<int32>(Bytes.size())), *SavePath))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Failed to save Q-Policy: %s"), *SavePath);
+		return false;
+	}
+	UE_LOG(LogTemp, Warning, TEXT("Saved Q-Policy: %s (%d states)"), *SavePath, static_cast<int32>(Policy.GetNumStates()));
+	return true;
+}
+
+bool QLearningStorage::LoadQPolicy(QCore::FQPolicyTable& Policy, const FString& Filename)
+{
+	const FString LoadPath = FPaths::ProjectSavedDir() + Filename;
+	TArray<uint8> FileContents;
+
+	if (!FFileHelper::LoadFileToArray(FileContents, *LoadPath, FILEREAD_Silent)) return false;
+
+	if (!QCore::ReadPolicyBinary(Policy, reinterpret_cast<const char*>(FileContents.GetData()), FileContents.Num()))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Q-Policy %s doesn't match the current state buckets, ignored"), *LoadPath);
+		return false;
+	}
+	UE_LOG(LogTemp, Warning, TEXT("Loaded Q-Policy: %s (%d states)"), *LoadPath, static_cast<int32>(Policy.GetNumStates()));
+	return true;
+}
+
+bool QLearningStorage::LoadOrBuildQPolicy(QCore::FQPolicyTable& Policy, const FString& PolicyFilename, const FString& TableFilename,
+	const QCore::FQDiscretizer& Discretizer)
+{
+	if (!Policy.IsValid()) return false;
+	if (LoadQPolicy(Policy, PolicyFilename)) return true;
+
+	const std::unique_ptr<QCore::IQTable> Table = QCore::MakeTable(QCore::ETableBackend::Map, NumQActions, 0);
+	if (!LoadDiscretizedQTable(*Table, TableFilename, Discretizer)) return false;
+	Policy.Build(*Table);
+	return true;
+}
+
+bool QLearningStorage::SaveQTileWeights(const QCore::FQTileLearner& Learner, const FString& Filename)
+{
+	const FString SavePath = FPaths::ProjectSavedDir() + Filename;
+
+	const std::string Bytes = QCore::WriteTileWeightsBinary(Learner);
+	if (!FFileHelper::SaveArrayToFile(TArrayView<const uint8>(reinterpret_cast<const uint8*>(Bytes.data()), static_cast<int32>(Bytes.size())), *SavePath))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Failed to save Q-Tile weights: %s"), *SavePath);
+		return false;
+	}
+	UE_LOG(LogTemp, Warning, TEXT("Saved Q-Tile weights: %s (%d tiles)"), *SavePath, static_cast<int32>(Learner.GetCoder().GetMemorySize()));
+	return true;
+}
+
+bool QLearningStorage::LoadQTileWeights(QCore::FQTileLearner& Learner, const FString& Filename)
+{
+	const FString LoadPath = FPaths::ProjectSavedDir() + Filename;
+	TArray<uint8> FileContents;
+
+	if (!FFileHelper::LoadFileToArray(FileContents, *LoadPath, FILEREAD_Silent)) return false;
+
+	if (!QCore::ReadTileWeightsBinary(Learner, reinterpret_cast<const char*>(FileContents.GetData()), FileContents.Num()))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Q-Tile weights %s were trained with another tile coding, ignored"), *LoadPath);
+		return false;
+	}
+	UE_LOG(LogTemp, Warning, TEXT("Loaded Q-Tile weights: %s"), *LoadPath);
+	return true;
+}
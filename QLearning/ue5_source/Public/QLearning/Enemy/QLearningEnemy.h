@@ -5,6 +5,14 @@
 #include "Enemy/Enemy.h"
 #include "GameFramework/Character.h"
 #include "QLearning/QLearningManager.h"
+#include "QCore/QDiscretizer.h"
+#include "QCore/QDynaPlanner.h"
+#include "QCore/QLearner.h"
+#include "QCore/QPolicyTable.h"
+#include "QCore/QPrioritizedSweeper.h"
+#include "QCore/QReplayBuffer.h"
+#include "QCore/QSnapshot.h"
+#include "QCore/QTileCoding.h"
 #include "QLearning/QLearningTypes.h"
 #include "QLearningEnemy.generated.h"
 
@@ -57,9 +65,19 @@ public:
 
 	bool bWaitingForActionCompletion = false;
 
-	TMap<FQState, TMap<EQAction, float>> QTable; // QTable[State][Action] = QValue
+	QCore::FQLearner QLearner; // Q table + update rule + exploration (engine independent), table created in BeginPlay
+	QCore::FQDiscretizer QDiscretizer; // State buckets, applied to every key before it reaches QLearner
+	QCore::FQReplayBuffer QReplayBuffer{ 0 }; // sized in BeginPlay (QReplayCapacity)
+	TUniquePtr<QCore::FQDynaPlanner> QDynaPlanner; // bUseQDynaPlanning - planned on the manager's FQDynaWorker (own thread without a manager)
+	QCore::FQPrioritizedSweeper QSweeper; // model + priority queue, QSweepUpdatesPerFrame
+	QCore::FQSnapshotPublisher QSnapshots; // immutable copies of the table for readers on other threads (QSnapshotIntervalSecs)
+	std::shared_ptr<const QCore::FQPolicyTable> FrozenQPolicy; // bFrozenQPolicy - decisions come from here, QLearner has no table
+	bool bUsingBuiltInQPolicy = false; // bFrozenQPolicy with a compiled-in QBuiltInPolicy.h matching the state buckets
+	TUniquePtr<QCore::FQTileLearner> QTileLearner; // bQTileCoding - linear Q over tile-coded features, QLearner has no table
 	TUniquePtr<FQState> QState = MakeUnique<FQState>();
 	TUniquePtr<FQState> PrevQState = MakeUnique<FQState>();
+	float QTargetDistance = 0.f; // continuous, tile coding only (the table sees bIsInAttackRange)
+	float PrevQTargetDistance = 0.f;
 	EQAction ChosenQAction;
 	TArray<float> PendingRewards;
 
@@ -70,7 +88,19 @@ public:
 	void UpdateFunction_Phase2();
 
 	EQAction ChooseAction(const FQState& State);
+	QCore::FQKey ToQKey(const FQState& State) const { return QDiscretizer.Apply(State.ToKey()); } // Table key (bucketed)
+	static constexpr int32 NumQFeatures = static_cast<int32>(FQState::Schema::NumFields) + 1;
+	void ToQFeatures(const FQState& State, float Distance, float* OutFeatures) const; // Tile coding input: schema fields + distance
 	void UpdateQValue(const FQState& PrevState, EQAction ActionTaken, float Reward, const FQState& NewState);
+	void EndQEpisode(); // terminal - drops eligibility traces (queued behind pending updates when deferred)
+	void ReplayQExperience(); // QReplayUpdatesPerFrame extra TD updates from the replay buffer
+	QCore::FQReplayBuffer* GetQReplayBuffer();
+	void SweepQPriorities(); // QSweepUpdatesPerFrame model updates, largest TD error first
+	void StartQDynaPlanning();
+	void PublishQDynaPlanning(); // once per frame, planned changes -> QLearner's table
+	void PublishQSnapshot(float DeltaTime);
+	QCore::FQSnapshotPublisher& GetQSnapshotPublisher() { return QSnapshots; } // async decision jobs, debug views - read through an FQSnapshotReader
+	UFUNCTION(BlueprintCallable, Category=QLearning) bool ExportQPolicy() const; // greedy action per bucketed state -> GetQPolicyFilename()
 
 	
 	/* Action */
@@ -89,10 +119,14 @@ public:
 
 	/* Storage */
 	bool IsUsingSharedTable() const { return QFilename.Contains("Shared", ESearchCase::IgnoreCase); }
+	bool IsUsingLiveSharedTable() const { return bUsingLiveSharedTable; }
+	bool IsQPolicyFrozen() const { return FrozenQPolicy || bUsingBuiltInQPolicy; }
+	FString GetQPolicyFilename() const; // QFilename with a .qpolicy extension
+	FString GetQTileWeightsFilename() const; // QFilename with a .qtiles extension
 
 	
 	/* Get */
-	TMap<FQState, TMap<EQAction, float>> GetQTable() { return QTable; }
+	const QCore::IQTable* GetQTable() const { return QLearner.GetTable(); } // null before BeginPlay
 
 protected:
 	virtual void BeginPlay() override;
@@ -103,11 +137,56 @@ protected:
 	UPROPERTY(EditAnywhere) float QLearningRate = 0.1f;
 	UPROPERTY(EditAnywhere) float QExplorationRate = 0.25f;
 	UPROPERTY(EditAnywhere) float QDiscountFactor = 0.95f;
+	UPROPERTY(EditAnywhere) float QTraceDecay = 0.f; // Lambda. > 0 - Watkins Q(lambda), sparse rewards (Kill/Death) reach earlier decisions in one episode
+	UPROPERTY(EditAnywhere, Category=QLearning) bool bQVisitCounts = false; // N(s,a) per cell, saved with the Q-Table (own Map/Dense tables only)
+	UPROPERTY(EditAnywhere, Category=QLearning) float QVisitCountExponent = 0.f; // omega. > 0 - alpha = max(1 / N(s,a)^omega, QLearningRate), implies bQVisitCounts
 	UPROPERTY(EditAnywhere, Category=QLearning) float QUpdateIntervalSecs = 1.f;
+	UPROPERTY(EditAnywhere, Category=QLearning) int32 QRandomSeed = 0; // != 0 - reproducible exploration/replay/planning draws, one stream per enemy name
+	UPROPERTY(EditAnywhere, Category=QLearning) EQTableBackend QTableBackend = EQTableBackend::Map; // Dense - flat array, no hashing (larger up-front allocation)
+	UPROPERTY(EditAnywhere, Category=QLearning) EQValueStorage QValueStorage = EQValueStorage::Float;
+	UPROPERTY(EditAnywhere, Category=QLearning) float QValueRange = 256.f; // Int16 - Q-values saturate at +-range
+	UPROPERTY(EditAnywhere, Category=QLearning) int32 QTableMemoryCapKB = 0; // Map - evict rows past this size (per enemy), 0 - unlimited
+	UPROPERTY(EditAnywhere, Category=QLearning) EQEviction QTableEviction = EQEviction::Clock;
+	UPROPERTY(EditAnywhere, Category=QLearning) bool bLiveSharedQTable = true; // "Shared" QFilename - learn in the QLearningManager's table during play instead of merging at EndPlay
+	UPROPERTY(EditAnywhere, Category=QLearning) bool bDeferQUpdates = false; // Queue TD updates, QLearningManager applies them once per frame (inline if no manager)
+
+	/* Frozen Policy */ // Shipped enemies - no exploration, learning or saving
+	UPROPERTY(EditAnywhere, Category=QLearning) bool bFrozenQPolicy = false; // decide from the compiled-in policy, else GetQPolicyFilename() (built from QFilename if missing) - one byte load per decision
+	UPROPERTY(EditAnywhere, Category=QLearning) bool bExportQPolicyOnEndPlay = false; // training runs - write the greedy policy next to the Q-Table
+
+	/* Tile Coding */ // Generalizes across nearby states (health, distance) instead of one row per key - replay, sweeping, Dyna and snapshots need the table
+	UPROPERTY(EditAnywhere, Category=QLearning) bool bQTileCoding = false; // learn a tile-coded linear Q, saved to GetQTileWeightsFilename()
+	UPROPERTY(EditAnywhere, Category=QLearning) int32 QTileCodingTilings = 8;
+	UPROPERTY(EditAnywhere, Category=QLearning) int32 QTileCodingMemory = 16384; // hashed tiles (power of two), 32 bytes each
+	void InitQTileLearner();
+
+	/* Experience Replay */ // 0 updates - off
+	UPROPERTY(EditAnywhere, Category=QLearning) int32 QReplayUpdatesPerFrame = 0;
+	UPROPERTY(EditAnywhere, Category=QLearning) float QReplayBudgetMicros = 50.f; // per frame, stops early when exceeded
+	UPROPERTY(EditAnywhere, Category=QLearning) int32 QReplayCapacity = 4096; // transitions kept (per enemy)
+	UPROPERTY(EditAnywhere, Category=QLearning) bool bShareQReplay = false; // use the QLearningManager's pooled buffer
+
+	/* Prioritized Sweeping */ // 0 updates - off. Deferred updates are observed when the manager flushes them
+	UPROPERTY(EditAnywhere, Category=QLearning) int32 QSweepUpdatesPerFrame = 0;
+	UPROPERTY(EditAnywhere, Category=QLearning) float QSweepBudgetMicros = 50.f; // per frame, stops early when exceeded
+
+	/* Policy Snapshots */ // 0 - off. Readers must not outlive this enemy
+	UPROPERTY(EditAnywhere, Category=QLearning) float QSnapshotIntervalSecs = 0.f;
+	float QSnapshotAccumulator = 0.f;
+
+	/* Dyna-Q */ // The manager's planning thread replays a learned model of observed transitions against a copy of the table
+	UPROPERTY(EditAnywhere, Category=QLearning) bool bUseQDynaPlanning = false;
+	UPROPERTY(EditAnywhere, Category=QLearning) int32 QDynaMaxStaleUpdates = 4096; // planning pauses until the next frame publishes
 
 	/* Q State Parameters */
 	UPROPERTY(EditAnywhere, Category=QLearning) float QAttackRadius = 300.f;
 	UPROPERTY(EditAnywhere, Category=QLearning) float QCombatRadius = 1000.f;
+	
+	/* Q State Buckets */ // Ascending lower edges of buckets 2..N, each value is stored as its bucket's lower edge. Empty - raw values
+	UPROPERTY(EditAnywhere, Category=QLearning) TArray<int32> QHealthBucketEdges = { 20, 40, 60, 80 }; // 5 bands instead of 101 values
+	UPROPERTY(EditAnywhere, Category=QLearning) TArray<int32> QTargetHealthBucketEdges = { 20, 40, 60, 80 };
+	UPROPERTY(EditAnywhere, Category=QLearning) TArray<int32> QHealsLeftBucketEdges;
+	void InitQDiscretizer();
 
 	/* Target */
 	UPROPERTY(VisibleAnywhere, Category=QLearning) class AKnightCharacter* QTarget; // Possibly change to ABaseCharacter - to accept other enemy types 
@@ -135,7 +214,15 @@ protected:
 
 
 	/* Storage */
-	UPROPERTY(EditAnywhere, Category=QLearning) FString QFilename = FString::Printf(TEXT("%s_QTable.json"), *GetName());
+	UPROPERTY(EditAnywhere, Category=QLearning) FString QFilename = FString::Printf(TEXT("%s_QTable.json"), *GetName()); // saved as .qtable (binary), the JSON name is the export
+	UPROPERTY(EditAnywhere, Category=QLearning) bool bExportQTableJson = false; // also write QFilename as JSON when saving (inspection, tools)
+	UPROPERTY(EditAnywhere, Category=QLearning) bool bMapQTable = true; // Map tables without a memory cap - read the saved rows in place from a mapping shared by every enemy on QFilename, copying a row on its first update
+	void InitQLearner();
+	std::unique_ptr<QCore::IQTable> MakeMappedQTable(QCore::EQValueType ValueType) const; // null - no mappable file, load a private table instead
+	bool InitFrozenQPolicy(); // false - no policy or table to freeze, the enemy learns instead
+	uint64 GetQRandomStream(uint32 Purpose) const { return (static_cast<uint64>(GetTypeHash(GetName())) << 2) | Purpose; } // 0 learner, 1 replay, 2 planner
+	uint64 QStreamSeed = 0; // QRandomSeed, or drawn once in BeginPlay - seeds every stream of this enemy
+	bool bUsingLiveSharedTable = false; // QLearner's table is the manager's, set in InitQLearner
 	void SaveQTableToDisk();
 	void LoadQTableFromDisk();
 
@@ -4,6 +4,13 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "QLearningTypes.h"
+#include "QCore/QDiscretizer.h"
+#include "QCore/QDynaPlanner.h"
+#include "QCore/QPolicyTable.h"
+#include "QCore/QReplayBuffer.h"
+#include "QCore/QTable.h"
+#include "QCore/QTableView.h"
+#include "QCore/QUpdateQueue.h"
 #include "QLearningManager.generated.h"
 
 
@@ -22,15 +29,54 @@ public:
 	virtual void Tick(float DeltaTime) override;
 	
 	void MergeAndSaveQTables();
-	void MergeQTableFromEnemy(const TMap<FQState, TMap<EQAction, float>>& OtherTable);
+	void MergeQTableFromEnemy(const QCore::IQTable& OtherTable);
 	void SaveMergedQTableToDisk(const FString& Filename);
+
+	/* Deferred TD updates (AQLearningEnemy::bDeferQUpdates) - applied once per frame in Tick */
+	QCore::FQUpdateQueue& GetQUpdateQueue() { return QUpdateQueue; }
+	void FlushQUpdates() { QUpdateQueue.Flush(); }
+
+	/* Live shared table (AtomicFloat, Dense or Sharded past MaxDenseKeys) for "Shared" enemies with bLiveSharedQTable - every enemy updates it
+	 * concurrently, no merge at EndPlay. Created and loaded from SharedFilename on first use, null for an enemy with other buckets */
+	std::shared_ptr<QCore::IQTable> GetSharedQTable(const QCore::FQDiscretizer& Discretizer);
+
+	/* One planning thread for every enemy with bUseQDynaPlanning, QDynaUpdatesPerFrame simulated updates a frame between them.
+	 * Planners are started unthreaded; Remove before the planner goes away */
+	void AddQDynaPlanner(QCore::FQDynaPlanner& Planner);
+	void RemoveQDynaPlanner(QCore::FQDynaPlanner& Planner) { QDynaWorker.Remove(Planner); }
+
+	/* Experience pooled from every enemy with bShareQReplay (they must use the same state buckets) */
+	QCore::FQReplayBuffer& GetQReplayBuffer() { return QReplayBuffer; }
+
+	/* Frozen greedy policy, loaded (or built from TableFilename) once per PolicyFilename and shared read-only by every enemy using it.
+	 * Null if neither file loads */
+	std::shared_ptr<const QCore::FQPolicyTable> GetFrozenQPolicy(const FString& PolicyFilename, const FString& TableFilename, const QCore::FQDiscretizer& Discretizer);
+
+	/* Saved Q-Table mapped read-only, one mapping per Filename while any enemy's overlay still uses it. Null if it can't be mapped
+	 * or its keys aren't all in Discretizer's buckets - checked once per mapping and distinct buckets, not per enemy */
+	std::shared_ptr<const QCore::FQTableView> GetQTableView(const FString& Filename, const QCore::FQDiscretizer& Discretizer);
 	
 protected:
 	virtual void BeginPlay() override;
 	
 	TArray<AQLearningEnemy*> FindAllQEnemies();
-	TMap<FQState, TMap<EQAction, float>> MergedQTable;
-	UPROPERTY(EditAnywhere) FString SharedFilename = "SharedQTable.json";
+	std::unique_ptr<QCore::IQTable> MergedQTable = QCore::MakeTable(QCore::ETableBackend::Map, NumQActions, 0);
+	std::shared_ptr<QCore::IQTable> SharedQTable; // saved to SharedFilename instead of MergedQTable when in use
+	QCore::FQDiscretizer SharedQTableBuckets; // SharedQTable's rows are keyed by these
+	UPROPERTY(EditAnywhere) FString SharedFilename = "SharedQTable.json"; // saved as SharedQTable.qtable
+	UPROPERTY(EditAnywhere) bool bExportSharedQTableJson = false; // also write SharedFilename as JSON
+
+	QCore::FQUpdateQueue QUpdateQueue{ 256 }; // preallocated, full queue -> enemies update inline
+	QCore::FQReplayBuffer QReplayBuffer{ 16384 };
+	QCore::FQDynaWorker QDynaWorker; // started on first use
+	UPROPERTY(EditAnywhere) int32 QDynaUpdatesPerFrame = 4096; // total across enemies, spent on the worker thread
+	TMap<FString, std::shared_ptr<const QCore::FQPolicyTable>> FrozenQPolicies;
+	struct FMappedQTable
+	{
+		std::weak_ptr<const QCore::FQTableView> View; // weak - unmapped with the last overlay (saves made while mapped wait as .pending)
+		std::vector<std::pair<QCore::FQDiscretizer, bool>> CheckedBuckets; // IsDiscretizedBy results for this mapping
+	};
+	TMap<FString, FMappedQTable> QTableViews;
 	
 	
 };
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "QCore/QPolicyTable.h"
+#include "QCore/QTable.h"
+#include "QCore/QTableView.h"
+#include "QCore/QTileCoding.h"
+
+
+/*
+ * Q table file I/O for the UE side
+ * Files live in FPaths::ProjectSavedDir(). Encoding is done by QCore (QPersistence), file access goes through FFileHelper.
+ * Tables are saved in the binary format next to the configured name ("Name_QTable.json" -> "Name_QTable.qtable");
+ * JSON is only written on export and read when no binary file exists yet (older saves).
+ * Saves keep full aligned rows so the file can be mapped (MapQTable), and replace the old file rather than rewrite it,
+ * so enemies still mapping it keep reading the rows they started with. Where a mapped file can't be replaced the save
+ * goes to "<name>.qtable.pending", which the next LoadQTable / MapQTable moves into place before reading.
+ */
+namespace QLearningStorage
+{
+	FString GetBinaryQTableFilename(const FString& Filename);
+	bool SaveQTable(const QCore::IQTable& Table, const FString& Filename); // binary
+	bool ExportQTableJson(const QCore::IQTable& Table, const FString& Filename);
+	bool LoadQTable(QCore::IQTable& Table, const FString& Filename); // binary, else the JSON file
+	bool LoadDiscretizedQTable(QCore::IQTable& Table, const FString& Filename, const QCore::FQDiscretizer& Discretizer); // rows saved with raw (or other) buckets folded into Discretizer's
+	std::shared_ptr<const QCore::FQTableView> MapQTable(const FString& Filename); // read-only, rows used in place. Null for JSON or packed saves
+
+	/* Frozen greedy policies (QCore::FQPolicyTable), Policy must be constructed with the enemies' discretizer */
+	bool SaveQPolicy(const QCore::FQPolicyTable& Policy, const FString& Filename);
+	bool LoadQPolicy(QCore::FQPolicyTable& Policy, const FString& Filename);
+	bool LoadOrBuildQPolicy(QCore::FQPolicyTable& Policy, const FString& PolicyFilename, const FString& TableFilename, const QCore::FQDiscretizer& Discretizer); // no policy file - greedy policy of the saved Q-Table
+
+	/* Tile-coded approximator weights (QCore::FQTileLearner), only load into a learner with the same coding */
+	bool SaveQTileWeights(const QCore::FQTileLearner& Learner, const FString& Filename);
+	bool LoadQTileWeights(QCore::FQTileLearner& Learner, const FString& Filename);
+}
@@ -2,6 +2,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "QCore/QStateSchema.h"
 
 #define ADD_HASH(Hash, Field) Hash = HashCombine(Hash, GetTypeHash(Field)); // not used atm
 
@@ -16,6 +17,30 @@ enum class EQAction : uint8
 	// RunSpeed?
 };
 
+constexpr int32 NumQActions = static_cast<int32>(EQAction::Wait) + 1;
+
+UENUM(BlueprintType)
+enum class EQTableBackend : uint8
+{
+	Map,	// QCore::FQMapTable - hashed, only holds visited states
+	Dense,	// QCore::FQDenseTable - flat row array, one row per bucketed state (QCore::FQStateIndex)
+	Sharded	// QCore::FQShardedTable - concurrent hashed table (atomic float cells), for state spaces too large for Dense
+};
+
+UENUM(BlueprintType)
+enum class EQValueStorage : uint8
+{
+	Float,
+	Int16	// Quantized Q-values - half the row memory, ValueRange / 32767 resolution
+};
+
+UENUM(BlueprintType)
+enum class EQEviction : uint8
+{
+	Clock,			// Approximately least recently used
+	LeastVisited	// Fewest visit counts among a few candidates (needs bQVisitCounts, Clock otherwise)
+};
+
 struct FQState
 {
 	int8 HealthPercent;
@@ -29,61 +54,41 @@ struct FQState
 	//bool bIsInCombatRange;
 	
 
+	// --- Schema: the single field list everything below is generated from ---
+	static constexpr auto Fields = std::make_tuple(
+		QCore::QField(&FQState::HealthPercent, "HealthPercent", 0, 100),
+		QCore::QField(&FQState::TargetHealthPercent, "TargetHealthPercent", 0, 100),
+		QCore::QField(&FQState::HealsLeft, "HealsLeft", 0, 7),
+		QCore::QField(&FQState::bIsInAttackRange, "bIsInAttackRange"),
+		QCore::QField(&FQState::bIsTargetAttacking, "bIsTargetAttacking"),
+		QCore::QField(&FQState::bIsTargetGuarding, "bIsTargetGuarding"),
+		QCore::QField(&FQState::bWasHitRecently, "bWasHitRecently"));
+	using Schema = QCore::TQStateSchema<FQState, Fields>;
+
 	// --- Hashing support ---
 	friend uint32 GetTypeHash(const FQState& Key) // used in TMap or TSet
 	{
-		uint32 Hash = 0;
-		Hash = HashCombine(Hash, GetTypeHash(Key.HealthPercent));
-		Hash = HashCombine(Hash, GetTypeHash(Key.TargetHealthPercent));
-		Hash = HashCombine(Hash, GetTypeHash(Key.HealsLeft));
-		Hash = HashCombine(Hash, GetTypeHash(Key.bIsInAttackRange));
-		Hash = HashCombine(Hash, GetTypeHash(Key.bIsTargetAttacking));
-		Hash = HashCombine(Hash, GetTypeHash(Key.bIsTargetGuarding));
-		Hash = HashCombine(Hash, GetTypeHash(Key.bWasHitRecently));
-		return Hash;
+		return Schema::Hash(Key);
 	}
 
 	// --- Equality operator for use as a key in TMap ---
 	bool operator==(const FQState& Other) const
 	{
-		return HealthPercent == Other.HealthPercent &&
-			   TargetHealthPercent == Other.TargetHealthPercent &&
-			   HealsLeft == Other.HealsLeft &&
-			   bIsInAttackRange == Other.bIsInAttackRange &&
-			   bIsTargetAttacking == Other.bIsTargetAttacking &&
-			   bIsTargetGuarding == Other.bIsTargetGuarding &&
-			   bWasHitRecently == Other.bWasHitRecently;
+		return Schema::Equals(*this, Other);
 	}
 
 	// --- Debug ToString() ---
 	FString ToString() const
 	{
-		return FString::Printf(TEXT("%d_%d_%d_%d_%d_%d_%d"), // %d for compatibility
-			HealthPercent,
-			TargetHealthPercent,
-			HealsLeft,
-			bIsInAttackRange,
-			bIsTargetAttacking,
-			bIsTargetGuarding,
-			bWasHitRecently);
+		TCHAR Buffer[Schema::MaxStringLength];
+		Schema::WriteString(*this, Buffer, Schema::MaxStringLength);
+		return FString(Buffer);
 	}
 
 	static FQState FromString(const FString& Str)
 	{
 		FQState State;
-		TArray<FString> Parts;
-		Str.ParseIntoArray(Parts, TEXT("_"), true);
-
-		if (Parts.Num() >= 7)
-		{
-			State.HealthPercent = FCString::Atoi(*Parts[0]);
-			State.TargetHealthPercent = FCString::Atoi(*Parts[1]);
-			State.HealsLeft = FCString::Atoi(*Parts[2]);
-			State.bIsInAttackRange = FCString::Atoi(*Parts[3]) != 0;
-			State.bIsTargetAttacking = FCString::Atoi(*Parts[4]) != 0;
-			State.bIsTargetGuarding = FCString::Atoi(*Parts[5]) != 0;
-			State.bWasHitRecently = FCString::Atoi(*Parts[6]) != 0;
-		}
+		Schema::ParseString(*Str, State);
 		return State;
 	}
 
@@ -101,6 +106,11 @@ struct FQState
 	{
 		*this = FQState(); // Calls the default constructor to reset all values
 	}
+
+	// --- QCore table key ---
+	// Packed key = [HealthPercent:7][TargetHealthPercent:7][HealsLeft:3][4 bools], small enough to index a dense table directly
+	QCore::FQKey ToKey() const { return Schema::Pack(*this); }
+	static FQState FromKey(const QCore::FQKey Key) { return Schema::Unpack(Key); }
 	
 };
 